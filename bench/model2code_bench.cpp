@@ -0,0 +1,461 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file model2code_bench.cpp
+ * @brief This file contains the benchmark of the generation: it generates all the skills of a directory in-process
+ * several times and reports the time and the allocations of each phase, optionally compared with a saved baseline.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+
+#include "Translator.h"
+#include <filesystem>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <iomanip>
+#include <unistd.h>
+
+// Count the allocations of each thread, read by TRACE_PHASE through allocationCount
+void* operator new(std::size_t size)
+{
+    allocationCount++;
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// over-aligned allocations, e.g. the blocks of the std::pmr arenas
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    allocationCount++;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if (void* ptr = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+// Phases reported by the benchmark, in pipeline order; "total" is the whole generation of the skills
+static const std::vector<std::string> benchPhases = {
+    "Translator", "extractFromSCXML", "getEventsVecData", "replaceEventCode", "writeFiles", "writeTranslatedSM", "total"
+};
+
+struct benchOptionsStr{
+    std::string inputPath = "tests/hl_scxml"; // directory of the SCXML files of the skills
+    std::string templatePath; // empty for the embedded template_skill
+    std::string outputPath; // generated skills, in a sub-directory owned by the benchmark (a temporary directory if empty)
+    std::string jsonFile; // results written as JSON, not written if empty
+    std::string baselineFile; // baseline JSON compared with the results, not compared if empty
+    unsigned int repetitions = 5;
+    unsigned int warmup = 1; // repetitions run before the measured ones
+    double threshold = 10; // regression threshold, in percent of the baseline median
+    double minDelta = 0.5; // differences smaller than this, in ms, are never regressions
+    bool datamodel_mode = false;
+};
+
+struct benchPhaseStr{
+    std::vector<double> times; // ms, one per repetition
+    std::vector<double> allocations; // one per repetition
+    double median = 0;
+    double mean = 0;
+    double min = 0;
+    double stddev = 0;
+    double medianAllocations = 0;
+};
+
+/**
+ * @brief Print the help message
+ *
+ */
+void print_help()
+{
+    std::cout << "Benchmark of the model2code generation.\n";
+    std::cout << "Usage:\n";
+    std::cout << "model2code_bench --input_path \"path/to/scxml/directory\" [default tests/hl_scxml] ";
+    std::cout << "--template_path \"path/to/template_skill/directory\" [default: the embedded template_skill] ";
+    std::cout << "--output_path \"path/to/output/directory\" [generated in its model2code_bench.<pid> sub-directory, default: temporary directory]\n";
+    std::cout << "--repetitions N [measured repetitions, default 5]\n";
+    std::cout << "--warmup N [repetitions run before the measured ones, default 1]\n";
+    std::cout << "--datamodel_mode\n";
+    std::cout << "--json \"results.json\" [to save the results, e.g. as baseline]\n";
+    std::cout << "--baseline \"baseline.json\" [to fail if a phase is slower than in the baseline]\n";
+    std::cout << "--threshold P [regression threshold in percent of the baseline median, default 10]\n";
+    std::cout << "--min_delta MS [differences smaller than MS milliseconds or than 3 standard deviations of the baseline are not regressions, default 0.5]\n";
+}
+
+/**
+ * @brief Handle the inputs
+ *
+ * @param argc number of input arguments
+ * @param argv vector of input arguments
+ * @param options benchmark options passed by reference where the options are stored
+ * @return true
+ * @return false
+ */
+bool handleInputs(int argc, char* argv[], benchOptionsStr& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i+1 < argc && argv[i+1][0] != '\0';
+        if (arg == "--help") {
+            print_help();
+            return RETURN_CODE_ERROR;
+        }
+        else if (arg == "--input_path" && hasValue) {
+            options.inputPath = argv[++i];
+        }
+        else if (arg == "--template_path" && hasValue) {
+            options.templatePath = argv[++i];
+        }
+        else if (arg == "--output_path" && hasValue) {
+            options.outputPath = argv[++i];
+        }
+        else if (arg == "--json" && hasValue) {
+            options.jsonFile = argv[++i];
+        }
+        else if (arg == "--baseline" && hasValue) {
+            options.baselineFile = argv[++i];
+        }
+        else if (arg == "--repetitions" && hasValue) {
+            options.repetitions = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--warmup" && hasValue) {
+            options.warmup = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (arg == "--threshold" && hasValue) {
+            options.threshold = std::atof(argv[++i]);
+        }
+        else if (arg == "--min_delta" && hasValue) {
+            options.minDelta = std::atof(argv[++i]);
+        }
+        else if (arg == "--datamodel_mode") {
+            options.datamodel_mode = true;
+        }
+        else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            std::cerr << "Run 'model2code_bench --help' for instructions" << std::endl;
+            return RETURN_CODE_ERROR;
+        }
+    }
+    if(options.outputPath == "")
+    {
+        options.outputPath = std::filesystem::temp_directory_path().string();
+    }
+    // the output is removed at each repetition, so it is never generated directly in a directory given by the user
+    options.outputPath = (std::filesystem::path(options.outputPath) / ("model2code_bench." + std::to_string(getpid()))).string();
+    return RETURN_CODE_OK;
+}
+
+/**
+ * @brief Generate a skill in-process, as model2code does without the generation manifest
+ *
+ * @param options benchmark options
+ * @param inputFile SCXML file of the skill
+ * @param templateFileData template file data structure, the templates are already read
+ * @return true if the skill is generated successfully
+ * @return false
+ */
+bool generateSkill(const benchOptionsStr& options, const std::string& inputFile, templateFileDataStr& templateFileData)
+{
+    fileDataStr fileData;
+    fileData.inputFileName = inputFile;
+    fileData.debug_mode = false;
+    fileData.datamodel_mode = options.datamodel_mode;
+    fileData.translate_mode = true;
+    fileData.generate_mode = true;
+    fileData.verbose_mode = false;
+    fileData.reproducible_mode = true;
+    fileData.generationDatetime = getGenerationDatetime(true);
+    fileData.outputPath = options.outputPath + "/" + turnToSnakeCase(std::filesystem::path(inputFile).stem().string()) + "/";
+    fileData.outputPathInclude = fileData.outputPath + "/include/";
+    fileData.outputPathSrc = fileData.outputPath + "/src/";
+
+    TRACE_PHASE("total");
+    // the input is mapped once for the translation and the generation, as in model2code
+    std::shared_ptr<const mappedFileStr> inputMapping = mapInputFile(inputFile);
+    tinyxml2::XMLDocument translatedDoc;
+    std::future<bool> translatedSMWritten;
+    std::future<bool> filesWritten;
+    if(!Translator(fileData, translatedDoc, translatedSMWritten))
+    {
+        return false;
+    }
+    fileData.inputFileNameGeneration = fileData.outputFileTranslatedSM;
+    bool generated = Replacer(fileData, templateFileData, translatedDoc, filesWritten);
+    generated &= translatedSMWritten.get();
+    generated &= !filesWritten.valid() || filesWritten.get();
+    join_generation_tasks();
+    return generated;
+}
+
+/**
+ * @brief Get the total size of the regular files of a directory and its sub-directories
+ *
+ * @param path directory
+ * @return uintmax_t size in bytes
+ */
+uintmax_t getDirectorySize(const std::string& path)
+{
+    uintmax_t size = 0;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(path, ec)) {
+        if (entry.is_regular_file()) {
+            size += entry.file_size();
+        }
+    }
+    return size;
+}
+
+/**
+ * @brief Compute the statistics of a phase over the repetitions
+ *
+ * @param phase phase passed by reference where the statistics are stored
+ */
+void computeStatistics(benchPhaseStr& phase)
+{
+    std::vector<double> times = phase.times;
+    std::sort(times.begin(), times.end());
+    size_t n = times.size();
+    phase.median = n % 2 ? times[n / 2] : (times[n / 2 - 1] + times[n / 2]) / 2;
+    phase.mean = std::accumulate(times.begin(), times.end(), 0.0) / n;
+    phase.min = times.front();
+    double variance = 0;
+    for (double time : times) {
+        variance += (time - phase.mean) * (time - phase.mean);
+    }
+    phase.stddev = n > 1 ? std::sqrt(variance / (n - 1)) : 0;
+    std::vector<double> allocations = phase.allocations;
+    std::sort(allocations.begin(), allocations.end());
+    phase.medianAllocations = allocations[n / 2];
+}
+
+/**
+ * @brief Write the results as JSON
+ *
+ * @param fileName JSON file
+ * @param options benchmark options
+ * @param phases statistics of the phases
+ * @param skills number of skills
+ * @param inputBytes size of the SCXML files of the skills
+ * @param outputBytes size of the generated files
+ * @return true
+ * @return false
+ */
+bool writeResults(const std::string& fileName, const benchOptionsStr& options, const std::map<std::string, benchPhaseStr>& phases, size_t skills, uintmax_t inputBytes, uintmax_t outputBytes)
+{
+    std::ofstream file(fileName);
+    if(!file.is_open())
+    {
+        std::cerr << "Failed to open file for writing: " << fileName << std::endl;
+        return false;
+    }
+    double totalSeconds = phases.at("total").median / 1000;
+    file << "{\n";
+    file << "  \"skills\": " << skills << ",\n";
+    file << "  \"repetitions\": " << options.repetitions << ",\n";
+    file << "  \"datamodel_mode\": " << (options.datamodel_mode ? "true" : "false") << ",\n";
+    file << "  \"skills_per_s\": " << skills / totalSeconds << ",\n";
+    file << "  \"input_bytes_per_s\": " << inputBytes / totalSeconds << ",\n";
+    file << "  \"output_bytes_per_s\": " << outputBytes / totalSeconds << ",\n";
+    file << "  \"phases\": {\n";
+    for (size_t i = 0; i < benchPhases.size(); i++) {
+        const benchPhaseStr& phase = phases.at(benchPhases[i]);
+        file << "    \"" << benchPhases[i] << "\": {\"median_ms\": " << phase.median << ", \"mean_ms\": " << phase.mean
+             << ", \"min_ms\": " << phase.min << ", \"stddev_ms\": " << phase.stddev << ", \"allocations\": " << phase.medianAllocations
+             << "}" << (i + 1 < benchPhases.size() ? "," : "") << "\n";
+    }
+    file << "  }\n";
+    file << "}\n";
+    return true;
+}
+
+/**
+ * @brief Read the median times and their standard deviation from a JSON file written by writeResults
+ *
+ * @param fileName JSON file
+ * @param baseline phase name -> (median, stddev) in ms, returned by reference
+ * @return true
+ * @return false
+ */
+bool readBaseline(const std::string& fileName, std::map<std::string, std::pair<double, double>>& baseline)
+{
+    std::string content;
+    if(!readTemplateFile(fileName, content))
+    {
+        return false;
+    }
+    // "phases" is the last entry: "phases": {"name": {"median_ms": value, ...}, ...}
+    size_t pos = content.find("\"phases\"");
+    pos = pos == std::string::npos ? pos : content.find('{', pos);
+    while (pos != std::string::npos) {
+        size_t nameStart = content.find('"', pos + 1);
+        size_t nameEnd = content.find('"', nameStart + 1);
+        size_t phaseEnd = content.find('}', nameEnd);
+        size_t medianPos = content.find("\"median_ms\":", nameEnd);
+        size_t stddevPos = content.find("\"stddev_ms\":", nameEnd);
+        if (nameStart == std::string::npos || nameEnd == std::string::npos || medianPos > phaseEnd || stddevPos > phaseEnd) {
+            break;
+        }
+        baseline[content.substr(nameStart + 1, nameEnd - nameStart - 1)] = {std::atof(content.c_str() + medianPos + 12), std::atof(content.c_str() + stddevPos + 12)};
+        pos = phaseEnd;
+    }
+    if(baseline.empty())
+    {
+        std::cerr << "No phase found in baseline: " << fileName << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Main function
+ *
+ * @param argc number of input arguments
+ * @param argv vector of input arguments
+ * @return int RETURN_CODE_OK, RETURN_CODE_ERROR if a skill fails or a phase regresses
+ */
+int main(int argc, char* argv[])
+{
+    namespace fs = std::filesystem;
+    benchOptionsStr options;
+    if(handleInputs(argc, argv, options))
+    {
+        return RETURN_CODE_ERROR;
+    }
+
+    std::vector<std::string> inputFiles;
+    uintmax_t inputBytes = 0;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(options.inputPath, ec)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".scxml") {
+            inputFiles.push_back(entry.path().string());
+            inputBytes += entry.file_size();
+        }
+    }
+    std::sort(inputFiles.begin(), inputFiles.end());
+    if(ec || inputFiles.empty())
+    {
+        std::cerr << "No SCXML file found in: " << options.inputPath << std::endl;
+        return RETURN_CODE_ERROR;
+    }
+    templateFileDataStr templateFileData;
+    templateFileData.templatePath = options.templatePath;
+    if(!readTemplates(templateFileData, templateFileData.codeMap))
+    {
+        std::cerr << "Failed to read the templates from: " << getTemplateSource(templateFileData) << std::endl;
+        return RETURN_CODE_ERROR;
+    }
+
+    std::map<std::string, benchPhaseStr> phases;
+    uintmax_t outputBytes = 0;
+    for (unsigned int rep = 0; rep < options.warmup + options.repetitions; rep++) {
+        // the files are generated from scratch at each repetition
+        fs::remove_all(options.outputPath, ec);
+        std::map<std::string, std::pair<double, double>> repetitionPhases; // phase -> (ms, allocations)
+        for (const auto& inputFile : inputFiles) {
+            generationContextStr context;
+            context.buffered = true;
+            context.trace = true;
+            set_generation_context(&context);
+            bool generated = generateSkill(options, inputFile, templateFileData);
+            set_generation_context(nullptr);
+            if(!generated)
+            {
+                std::cerr << context.errors.str();
+                std::cerr << "Error in the generation of: " << inputFile << std::endl;
+                return RETURN_CODE_ERROR;
+            }
+            for (const auto& event : context.traceEvents) {
+                auto& [time, allocations] = repetitionPhases[event.name];
+                time += std::chrono::duration<double, std::milli>(event.duration).count();
+                allocations += event.allocations;
+            }
+        }
+        if(rep < options.warmup)
+        {
+            continue;
+        }
+        for (const auto& phaseName : benchPhases) {
+            phases[phaseName].times.push_back(repetitionPhases[phaseName].first);
+            phases[phaseName].allocations.push_back(repetitionPhases[phaseName].second);
+        }
+        outputBytes = getDirectorySize(options.outputPath);
+    }
+    for (auto& [phaseName, phase] : phases) {
+        computeStatistics(phase);
+    }
+
+    const benchPhaseStr& total = phases["total"];
+    std::cout << "model2code_bench: " << inputFiles.size() << " skills, " << options.repetitions << " repetitions"
+              << (options.datamodel_mode ? ", datamodel mode" : "") << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << std::left << std::setw(20) << "phase" << std::right << std::setw(12) << "median ms" << std::setw(12) << "mean ms"
+              << std::setw(12) << "min ms" << std::setw(12) << "stddev ms" << std::setw(14) << "allocations" << std::endl;
+    for (const auto& phaseName : benchPhases) {
+        const benchPhaseStr& phase = phases[phaseName];
+        std::cout << std::left << std::setw(20) << phaseName << std::right << std::setw(12) << phase.median << std::setw(12) << phase.mean
+                  << std::setw(12) << phase.min << std::setw(12) << phase.stddev << std::setw(14) << std::setprecision(0) << phase.medianAllocations
+                  << std::setprecision(3) << std::endl;
+    }
+    double totalSeconds = total.median / 1000;
+    std::cout << std::setprecision(1) << "Throughput: " << inputFiles.size() / totalSeconds << " skills/s, "
+              << inputBytes / totalSeconds / 1e6 << " MB/s of SCXML, " << outputBytes / totalSeconds / 1e6 << " MB/s generated" << std::endl;
+
+    if(options.jsonFile != "" && !writeResults(options.jsonFile, options, phases, inputFiles.size(), inputBytes, outputBytes))
+    {
+        return RETURN_CODE_ERROR;
+    }
+    if(options.baselineFile == "")
+    {
+        return RETURN_CODE_OK;
+    }
+    std::map<std::string, std::pair<double, double>> baseline;
+    if(!readBaseline(options.baselineFile, baseline))
+    {
+        return RETURN_CODE_ERROR;
+    }
+    bool regressed = false;
+    std::cout << "Comparison with " << options.baselineFile << " (threshold " << options.threshold << "%, min delta " << options.minDelta << " ms):" << std::endl;
+    for (const auto& phaseName : benchPhases) {
+        auto it = baseline.find(phaseName);
+        if (it == baseline.end() || it->second.first <= 0) {
+            continue;
+        }
+        const auto& [baselineMedian, baselineStddev] = it->second;
+        double median = phases[phaseName].median;
+        double change = (median - baselineMedian) / baselineMedian * 100;
+        // differences within the noise of the baseline are not regressions
+        bool phaseRegressed = change > options.threshold && median - baselineMedian > std::max(options.minDelta, 3 * baselineStddev);
+        regressed |= phaseRegressed;
+        std::cout << "\t" << std::left << std::setw(20) << phaseName << std::right << std::showpos << std::setw(8) << change << "%" << std::noshowpos
+                  << (phaseRegressed ? "  REGRESSION" : "") << std::endl;
+    }
+    return regressed ? RETURN_CODE_ERROR : RETURN_CODE_OK;
+}
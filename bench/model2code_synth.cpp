@@ -0,0 +1,358 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file model2code_synth.cpp
+ * @brief This file contains the generator of synthetic High-Level SCXML skills, used to measure how the generation scales
+ * with the number of states, transitions, interfaces and the nesting depth of the model.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+
+#include "tinyxml2.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+
+#define RETURN_CODE_ERROR 1
+#define RETURN_CODE_OK    0
+
+struct synthOptionsStr{
+    std::string outputFile; // standard output if empty
+    std::string name = "Synthetic"; // the skill is named <name>Skill
+    bool action = true; // action skill (tick and halt) or condition skill (tick only)
+    unsigned int states = 10; // steps of the skill, each one with a request state and a response state
+    unsigned int transitions = 1; // extra conditional transitions of each step to random steps
+    unsigned int serviceClients = 4;
+    unsigned int topicSubscribers = 2;
+    unsigned int actionClients = 1;
+    unsigned int depth = 0; // nesting levels of compound states around the steps
+    unsigned int branching = 2; // compound states in each nesting level
+    unsigned int seed = 1; // seed of the extra transitions, the same options give the same model
+};
+
+struct synthModelStr{
+    synthOptionsStr options;
+    std::string serverName; // e.g. "/SyntheticSkill"
+    std::mt19937 random;
+    tinyxml2::XMLDocument doc;
+};
+
+/**
+ * @brief Print the help message
+ *
+ */
+void print_help()
+{
+    std::cout << "Generator of synthetic High-Level SCXML skills for the scaling tests of model2code.\n";
+    std::cout << "Usage:\n";
+    std::cout << "model2code_synth --output \"SyntheticSkill.scxml\" [default: standard output] --name Synthetic\n";
+    std::cout << "--states N [steps of the skill, each one with a request and a response state, default 10]\n";
+    std::cout << "--transitions N [extra conditional transitions of each step, default 1]\n";
+    std::cout << "--service_clients N [default 4]\n";
+    std::cout << "--topic_subscribers N [default 2]\n";
+    std::cout << "--action_clients N [default 1]\n";
+    std::cout << "--depth N [nesting levels of compound states around the steps, default 0]\n";
+    std::cout << "--branching N [compound states in each nesting level, default 2]\n";
+    std::cout << "--condition [to generate a condition skill instead of an action skill]\n";
+    std::cout << "--seed N [seed of the extra transitions, default 1]\n";
+}
+
+/**
+ * @brief Handle the inputs
+ *
+ * @param argc number of input arguments
+ * @param argv vector of input arguments
+ * @param options options passed by reference where the options are stored
+ * @return true
+ * @return false
+ */
+bool handleInputs(int argc, char* argv[], synthOptionsStr& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i+1 < argc && argv[i+1][0] != '\0';
+        bool hasNumber = hasValue && std::string(argv[i+1]).find_first_not_of("0123456789") == std::string::npos;
+        if (arg == "--help") {
+            print_help();
+            return RETURN_CODE_ERROR;
+        }
+        else if (arg == "--output" && hasValue) {
+            options.outputFile = argv[++i];
+        }
+        else if (arg == "--name" && hasValue) {
+            options.name = argv[++i];
+        }
+        else if (arg == "--states" && hasNumber) {
+            options.states = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--transitions" && hasNumber) {
+            options.transitions = std::atoi(argv[++i]);
+        }
+        else if (arg == "--service_clients" && hasNumber) {
+            options.serviceClients = std::atoi(argv[++i]);
+        }
+        else if (arg == "--topic_subscribers" && hasNumber) {
+            options.topicSubscribers = std::atoi(argv[++i]);
+        }
+        else if (arg == "--action_clients" && hasNumber) {
+            options.actionClients = std::atoi(argv[++i]);
+        }
+        else if (arg == "--depth" && hasNumber) {
+            options.depth = std::atoi(argv[++i]);
+        }
+        else if (arg == "--branching" && hasNumber) {
+            options.branching = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--seed" && hasNumber) {
+            options.seed = std::atoi(argv[++i]);
+        }
+        else if (arg == "--condition") {
+            options.action = false;
+        }
+        else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            std::cerr << "Run 'model2code_synth --help' for instructions" << std::endl;
+            return RETURN_CODE_ERROR;
+        }
+    }
+    return RETURN_CODE_OK;
+}
+
+/**
+ * @brief Add a child element with its attributes
+ *
+ * @param parent parent element
+ * @param tag tag of the child
+ * @param attributes attribute name and value pairs, in order
+ * @return tinyxml2::XMLElement* child element
+ */
+tinyxml2::XMLElement* addElement(tinyxml2::XMLNode* parent, const char* tag, const std::vector<std::pair<std::string, std::string>>& attributes = {})
+{
+    tinyxml2::XMLElement* element = parent->GetDocument()->NewElement(tag);
+    for (const auto& [name, value] : attributes) {
+        element->SetAttribute(name.c_str(), value.c_str());
+    }
+    parent->InsertEndChild(element);
+    return element;
+}
+
+/**
+ * @brief Add the response of the skill to a tick or halt request
+ *
+ * @param model synthetic model
+ * @param parent element where the response is sent
+ * @param request "tick" or "halt"
+ * @param status status of the skill (e.g. "SKILL_RUNNING"), not sent if empty
+ */
+void addSkillResponse(synthModelStr& model, tinyxml2::XMLElement* parent, const std::string& request, const std::string& status)
+{
+    tinyxml2::XMLElement* response = addElement(parent, "ros_service_send_response", {{"name", model.serverName + "/" + request}});
+    addElement(response, "field", {{"name", "is_ok"}, {"expr", "true"}});
+    if (!status.empty()) {
+        addElement(response, "field", {{"name", "status"}, {"expr", status}});
+    }
+}
+
+/**
+ * @brief Add the handlers shared by all the states: halt (action skills) and topic callback
+ *
+ * @param model synthetic model
+ * @param state state element
+ * @param stateId id of the state, target of the topic callback
+ * @param step step of the state, selects the topic
+ */
+void addCommonHandlers(synthModelStr& model, tinyxml2::XMLElement* state, const std::string& stateId, unsigned int step)
+{
+    const synthOptionsStr& options = model.options;
+    if (options.action) {
+        tinyxml2::XMLElement* halt = addElement(state, "ros_service_handle_request", {{"name", model.serverName + "/halt"}, {"target", "idle"}});
+        addSkillResponse(model, halt, "halt", "");
+    }
+    if (options.topicSubscribers) {
+        unsigned int topic = step % options.topicSubscribers;
+        tinyxml2::XMLElement* callback = addElement(state, "ros_topic_callback", {{"name", "/TopicComponent" + std::to_string(topic) + "/topic" + std::to_string(topic)}, {"target", stateId}});
+        addElement(callback, "assign", {{"location", "m_topic" + std::to_string(topic)}, {"expr", "_msg.data"}});
+    }
+}
+
+/**
+ * @brief Add the request and response states of a step: the tick request calls a service or sends an action goal,
+ * the response moves to the next step
+ *
+ * @param model synthetic model
+ * @param parent element where the states are added (the scxml element or a compound state)
+ * @param step step index
+ */
+void addStep(synthModelStr& model, tinyxml2::XMLElement* parent, unsigned int step)
+{
+    const synthOptionsStr& options = model.options;
+    std::string stepId = "step" + std::to_string(step);
+    std::string nextId = step + 1 < options.states ? "step" + std::to_string(step + 1) : "idle";
+    std::string waitId = stepId + "_wait";
+    unsigned int interfaces = options.serviceClients + options.actionClients;
+
+    tinyxml2::XMLElement* state = addElement(parent, "state", {{"id", stepId}});
+    tinyxml2::XMLElement* tick = addElement(state, "ros_service_handle_request", {{"name", model.serverName + "/tick"}, {"target", interfaces ? waitId : nextId}});
+    tinyxml2::XMLElement* wait = nullptr;
+    if (interfaces && step % interfaces < options.serviceClients) {
+        unsigned int client = step % interfaces;
+        std::string clientName = "/ServiceComponent" + std::to_string(client) + "/Function" + std::to_string(client);
+        tinyxml2::XMLElement* request = addElement(tick, "ros_service_send_request", {{"name", clientName}});
+        addElement(request, "field", {{"name", "value"}, {"expr", std::to_string(step)}});
+
+        wait = addElement(parent, "state", {{"id", waitId}});
+        tinyxml2::XMLElement* response = addElement(wait, "ros_service_handle_response", {{"name", clientName}, {"target", nextId}});
+        addElement(response, "assign", {{"location", "m_service" + std::to_string(client)}, {"expr", "_res.result"}});
+        addSkillResponse(model, response, "tick", "SKILL_RUNNING");
+    }
+    else if (interfaces) {
+        unsigned int client = step % interfaces - options.serviceClients;
+        std::string clientName = "action" + std::to_string(client);
+        tinyxml2::XMLElement* goal = addElement(tick, "ros_action_send_goal", {{"name", clientName}});
+        addElement(goal, "field", {{"name", "value"}, {"expr", std::to_string(step)}});
+        addSkillResponse(model, tick, "tick", "SKILL_RUNNING");
+
+        wait = addElement(parent, "state", {{"id", waitId}});
+        addElement(wait, "ros_action_handle_goal_response", {{"name", clientName}, {"accept", waitId}, {"reject", "idle"}});
+        tinyxml2::XMLElement* feedback = addElement(wait, "ros_action_handle_feedback", {{"name", clientName}, {"target", waitId}});
+        addElement(feedback, "assign", {{"location", "m_action" + std::to_string(client)}, {"expr", "_feedback.progress"}});
+        tinyxml2::XMLElement* result = addElement(wait, "ros_action_handle_success_result", {{"name", clientName}, {"target", nextId}});
+        addElement(result, "assign", {{"location", "m_action" + std::to_string(client)}, {"expr", "_wrapped_result.result.progress"}});
+    }
+    else {
+        addSkillResponse(model, tick, "tick", step + 1 < options.states ? "SKILL_RUNNING" : "SKILL_SUCCESS");
+    }
+
+    // extra transitions to random steps, guarded so that the skill keeps its main path
+    std::uniform_int_distribution<unsigned int> targetStep(0, options.states - 1);
+    for (unsigned int i = 0; i < options.transitions; i++) {
+        addElement(state, "transition", {{"cond", "m_counter == " + std::to_string(step * options.transitions + i + 1)}, {"target", "step" + std::to_string(targetStep(model.random))}});
+    }
+    addCommonHandlers(model, state, stepId, step);
+    if (wait) {
+        addCommonHandlers(model, wait, waitId, step);
+    }
+}
+
+/**
+ * @brief Add the steps of a range, nested in depth levels of compound states
+ *
+ * @param model synthetic model
+ * @param parent element where the steps are added
+ * @param first first step of the range
+ * @param last step after the range
+ * @param depth remaining nesting levels
+ * @param path path of the compound state in the nesting, used in its id
+ */
+void addSteps(synthModelStr& model, tinyxml2::XMLElement* parent, unsigned int first, unsigned int last, unsigned int depth, const std::string& path)
+{
+    if (depth == 0 || last - first < 2) {
+        for (unsigned int step = first; step < last; step++) {
+            addStep(model, parent, step);
+        }
+        return;
+    }
+    unsigned int branches = std::min(model.options.branching, last - first);
+    for (unsigned int branch = 0; branch < branches; branch++) {
+        unsigned int branchFirst = first + (last - first) * branch / branches;
+        unsigned int branchLast = first + (last - first) * (branch + 1) / branches;
+        std::string groupPath = path + "_" + std::to_string(branch);
+        tinyxml2::XMLElement* group = addElement(parent, "state", {{"id", "group" + groupPath}, {"initial", "step" + std::to_string(branchFirst)}});
+        addSteps(model, group, branchFirst, branchLast, depth - 1, groupPath);
+    }
+}
+
+/**
+ * @brief Build the synthetic High-Level SCXML skill
+ *
+ * @param model synthetic model with the options, the document is filled
+ */
+void buildModel(synthModelStr& model)
+{
+    const synthOptionsStr& options = model.options;
+    std::string skillName = options.name + "Skill";
+    model.serverName = "/" + skillName;
+    model.random.seed(options.seed);
+
+    model.doc.InsertEndChild(model.doc.NewDeclaration("xml version=\"1.0\" encoding=\"UTF-8\""));
+    tinyxml2::XMLElement* scxml = addElement(&model.doc, "scxml", {{"version", "1.0"}, {"xmlns", "http://www.w3.org/2005/07/scxml"},
+        {"datamodel", "ecmascript"}, {"name", skillName}, {"initial", "idle"}});
+    model.doc.InsertAfterChild(model.doc.FirstChild(), model.doc.NewComment(
+        (" Synthetic skill: " + std::to_string(options.states) + " steps, " + std::to_string(options.transitions) + " extra transitions per step, "
+        + std::to_string(options.serviceClients) + " service clients, " + std::to_string(options.topicSubscribers) + " topic subscribers, "
+        + std::to_string(options.actionClients) + " action clients, depth " + std::to_string(options.depth) + ", seed " + std::to_string(options.seed) + " ").c_str()));
+
+    tinyxml2::XMLElement* datamodel = addElement(scxml, "datamodel");
+    addElement(datamodel, "data", {{"id", "m_counter"}, {"type", "int32"}, {"expr", "0"}});
+    for (unsigned int i = 0; i < options.serviceClients; i++) {
+        addElement(datamodel, "data", {{"id", "m_service" + std::to_string(i)}, {"type", "int32"}, {"expr", "0"}});
+    }
+    for (unsigned int i = 0; i < options.topicSubscribers; i++) {
+        addElement(datamodel, "data", {{"id", "m_topic" + std::to_string(i)}, {"type", "int32"}, {"expr", "0"}});
+    }
+    for (unsigned int i = 0; i < options.actionClients; i++) {
+        addElement(datamodel, "data", {{"id", "m_action" + std::to_string(i)}, {"type", "int32"}, {"expr", "0"}});
+    }
+    addElement(datamodel, "data", {{"id", "SKILL_SUCCESS"}, {"type", "int8"}, {"expr", "0"}});
+    addElement(datamodel, "data", {{"id", "SKILL_FAILURE"}, {"type", "int8"}, {"expr", "1"}});
+    addElement(datamodel, "data", {{"id", "SKILL_RUNNING"}, {"type", "int8"}, {"expr", "2"}});
+
+    addElement(scxml, "ros_service_server", {{"service_name", model.serverName + "/tick"}, {"type", options.action ? "bt_interfaces_dummy/TickAction" : "bt_interfaces_dummy/TickCondition"}});
+    if (options.action) {
+        addElement(scxml, "ros_service_server", {{"service_name", model.serverName + "/halt"}, {"type", "bt_interfaces_dummy/HaltAction"}});
+    }
+    for (unsigned int i = 0; i < options.serviceClients; i++) {
+        addElement(scxml, "ros_service_client", {{"service_name", "/ServiceComponent" + std::to_string(i) + "/Function" + std::to_string(i)}, {"type", "synthetic_interfaces/Function" + std::to_string(i)}});
+    }
+    for (unsigned int i = 0; i < options.topicSubscribers; i++) {
+        addElement(scxml, "ros_topic_subscriber", {{"topic", "/TopicComponent" + std::to_string(i) + "/topic" + std::to_string(i)}, {"type", "std_msgs/Int32"}});
+    }
+    for (unsigned int i = 0; i < options.actionClients; i++) {
+        addElement(scxml, "ros_action_client", {{"name", "action" + std::to_string(i)}, {"action_name", "/ActionComponent" + std::to_string(i) + "/Action" + std::to_string(i)}, {"type", "synthetic_interfaces/Action" + std::to_string(i)}});
+    }
+
+    tinyxml2::XMLElement* idle = addElement(scxml, "state", {{"id", "idle"}});
+    tinyxml2::XMLElement* tick = addElement(idle, "ros_service_handle_request", {{"name", model.serverName + "/tick"}, {"target", "step0"}});
+    addSkillResponse(model, tick, "tick", "SKILL_RUNNING");
+    if (options.action) {
+        tinyxml2::XMLElement* halt = addElement(idle, "ros_service_handle_request", {{"name", model.serverName + "/halt"}, {"target", "idle"}});
+        addSkillResponse(model, halt, "halt", "");
+    }
+    addSteps(model, scxml, 0, options.states, options.depth, "");
+}
+
+/**
+ * @brief Main function
+ *
+ * @param argc number of input arguments
+ * @param argv vector of input arguments
+ * @return int
+ */
+int main(int argc, char* argv[])
+{
+    synthModelStr model;
+    if(handleInputs(argc, argv, model.options))
+    {
+        return RETURN_CODE_ERROR;
+    }
+    buildModel(model);
+    if(model.options.outputFile == "")
+    {
+        tinyxml2::XMLPrinter printer;
+        model.doc.Print(&printer);
+        std::cout << printer.CStr();
+        return RETURN_CODE_OK;
+    }
+    if(model.doc.SaveFile(model.options.outputFile.c_str()) != tinyxml2::XML_SUCCESS)
+    {
+        std::cerr << "Failed to write: " << model.options.outputFile << std::endl;
+        return RETURN_CODE_ERROR;
+    }
+    return RETURN_CODE_OK;
+}
@@ -0,0 +1,45 @@
+# SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+# SPDX-License-Identifier: APACHE-2.0
+
+# Write the files of template_skill as constant data in a header, used when no --template_path is given.
+# Usage: cmake -DTEMPLATE_DIR=path/to/template_skill -DOUTPUT=path/to/EmbeddedTemplates.h -P EmbedTemplates.cmake
+
+# code map key and path relative to TEMPLATE_DIR, as in readTemplates
+set(TEMPLATES
+  hCode include/TemplateSkill.h
+  cppCode src/TemplateSkill.cpp
+  hDataModelCode include/TemplateSkillDataModel.h
+  cppDataModelCode src/TemplateSkillDataModel.cpp
+  cmakeCode CMakeLists.txt
+  packageCode package.xml
+  mainCode src/main.cpp
+)
+
+string(REPEAT "0x[0-9a-f][0-9a-f]," 16 LINE_PATTERN)
+set(HEADER "// Generated from template_skill by cmake/EmbedTemplates.cmake, do not edit\n#pragma once\n\n#include <string_view>\n#include <utility>\n\n")
+set(TABLE "")
+list(LENGTH TEMPLATES TEMPLATES_LENGTH)
+math(EXPR LAST "${TEMPLATES_LENGTH} - 1")
+foreach(i RANGE 0 ${LAST} 2)
+  math(EXPR j "${i} + 1")
+  list(GET TEMPLATES ${i} NAME)
+  list(GET TEMPLATES ${j} FILE)
+  file(READ "${TEMPLATE_DIR}/${FILE}" CONTENT HEX)
+  string(LENGTH "${CONTENT}" CONTENT_LENGTH)
+  math(EXPR SIZE "${CONTENT_LENGTH} / 2")
+  # 16 bytes per line, terminated by a null character so that empty templates are valid arrays
+  string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," CONTENT "${CONTENT}")
+  string(REGEX REPLACE "(${LINE_PATTERN})" "\\1\n  " CONTENT "${CONTENT}")
+  string(APPEND HEADER "// ${FILE}\nstatic constexpr char embeddedTemplate_${NAME}[] = {\n  ${CONTENT}0x00\n};\n\n")
+  string(APPEND TABLE "  {\"${NAME}\", std::string_view(embeddedTemplate_${NAME}, ${SIZE})},\n")
+endforeach()
+string(APPEND HEADER "// code map key and template code\nstatic constexpr std::pair<const char*, std::string_view> embeddedTemplates[] = {\n${TABLE}};\n")
+
+# the header is written only if it changed, so that the sources including it are not compiled again
+set(CURRENT "")
+if(EXISTS "${OUTPUT}")
+  file(READ "${OUTPUT}" CURRENT)
+endif()
+if(NOT CURRENT STREQUAL HEADER)
+  file(WRITE "${OUTPUT}" "${HEADER}")
+endif()
@@ -14,14 +14,21 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <map>
+#include <unordered_map>
+#include <set>
+#include <sstream>
+#include <memory>
+#include <memory_resource>
+#include <deque>
+#include <future>
+#include <chrono>
+#include <cstdint>
 #include "strManipulation.h"
 #include <vector>
+#include "tinyxml2.h"
 
-#define modelFilePath "./templates/specifications/full-model.xml"
-#define interfaceFilePath "./templates/specifications/interfaces.xml"
-
-#define templateFilePath "./template_skill/"
 #define cppTemplateFileRelativePath "/src/TemplateSkill.cpp"
 #define hTemplateFileRelativePath "/include/TemplateSkill.h"
 #define cppDataModelTemplateFileRelativePath "/src/TemplateSkillDataModel.cpp"
@@ -30,6 +37,12 @@
 #define cMakeTemplateFileRelativePath "/CMakeLists.txt"
 #define pkgTemplateFileRelativePath "/package.xml"
 
+#define manifestFileName ".model2code_manifest"
+
+#ifndef MODEL2CODE_VERSION
+#define MODEL2CODE_VERSION "0.1"
+#endif
+
 #define RETURN_CODE_ERROR 1
 #define RETURN_CODE_OK    0
 
@@ -38,6 +51,20 @@
 #define rspTick "TICK_RESPONSE"
 #define rspHalt "HALT_RESPONSE"
 
+// Log a message streamed with << (e.g. LOG_DEBUG("Event: " << event)), the message is not formatted if its level is disabled
+#define LOG_MESSAGE(level, message) do { if (log_enabled(level)) { std::ostringstream logMessage; logMessage << message; write_log(level, logMessage.str()); } } while (0)
+#define LOG_DEBUG(message)   LOG_MESSAGE(logLevel::debug, message)
+#define LOG_INFO(message)    LOG_MESSAGE(logLevel::info, message)
+#define LOG_WARNING(message) LOG_MESSAGE(logLevel::warning, message)
+#define LOG_ERROR(message)   LOG_MESSAGE(logLevel::error, message)
+
+// Time the enclosing scope as a phase of the generation, recorded only if the generation context traces the phases
+#define TRACE_PHASE(name) traceScopeStr traceScope(name)
+// Same as TRACE_PHASE with a detail streamed with << (e.g. the event name), the detail is not formatted if the phases are not traced
+#define TRACE_PHASE_DETAIL(name, value) traceScopeStr traceScope(name); if (traceScope.enabled) { std::ostringstream traceDetail; traceDetail << value; traceScope.detail = traceDetail.str(); }
+// Add a value to a counter of the generation (e.g. "bytes written"), counted only if the generation context traces the phases
+#define TRACE_COUNTER(name, value) do { generationContextStr& traceContext = get_generation_context(); if (traceContext.trace) { traceContext.traceCounters[name] += (value); } } while (0)
+
 
 
 struct skillDataStr{
@@ -75,7 +102,7 @@ struct eventDataStr{
     std::string serviceTypeNameSnakeCase; // snake case version of serviceTypeName
     std::string rosInterfaceType; //type of the interface in ROS (e.g. "sync-service", "async-service", "action", "topic")
     std::string scxmlInterfaceName; //name of the interface in the scxml file
-    bool virtualInterface;
+    bool virtualInterface = false;
 
     std::vector<std::string> interfaceRequestFields; //list of interfaces used in the event
     std::vector<std::string> interfaceResponseFields; //list of interfaces used in the event
@@ -100,16 +127,135 @@ struct fileDataStr{
     std::string outputFileNameH;
     std::string outputFileNameCPP;
     std::string outputFileTranslatedSM;
-    bool debug_mode;
-    bool datamodel_mode;   
-    bool translate_mode;   
-    bool generate_mode;   
-    bool verbose_mode;
+    bool debug_mode = false;
+    bool datamodel_mode = false;   
+    bool translate_mode = false;   
+    bool generate_mode = false;   
+    bool verbose_mode = false;
+    bool force_mode = false; // generate the skill even if its manifest is up to date
+    bool reproducible_mode = false; // write a fixed datetime in the generated files, see getGenerationDatetime
+    bool fsync_mode = false; // sync the generated files and their directories to disk, see setOutputSync
+    bool stream_mode = false; // write the translated SCXML while translating, see Translator
+    bool validate_mode = false; // check the input SCXML before the generation, a skill with errors is not generated, see Validator
+    std::string cacheDirectory; // directory of the resolved events kept between the runs, empty if the cache is disabled
+    uintmax_t cacheSize = 64 * 1024 * 1024; // maximum size in bytes of the cache directory, the oldest files are removed above it
+    std::string generationDatetime; // datetime written in the generated files, the same for all the files of the skill
     bool is_action_skill; // true if the skill is an action skill, false otherwise
+    std::string batchPath; // directory or manifest of the skills generated in batch mode, empty for a single skill
+    unsigned int jobs = 1; // number of skills generated in parallel in batch mode, 0 for one per core
+    std::string watchPath; // directory of the skills regenerated when their SCXML file or the templates change, empty if not watching
+    std::string profileFile; // Chrome trace of the generation phases, empty if not profiling
+    size_t profileTopCount = 10; // number of phases printed in the profile summary
+};
+
+// The names and the values of the element index are views of the strings of the indexed document, which is not copied:
+// the index is valid while the indexed elements are not modified. Its maps and vectors are allocated in the arena of the
+// index, released at once with it.
+struct attributeIndexStr{
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    explicit attributeIndexStr(const allocator_type& allocator = {}) : elements(allocator), valueMap(allocator) {}
+    std::pmr::vector<tinyxml2::XMLElement*> elements; // elements having the attribute, in document order
+    std::pmr::map<std::string_view, std::pmr::vector<tinyxml2::XMLElement*>, std::less<>> valueMap; // attribute value -> elements, in document order
+};
+
+struct tagIndexStr{
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    explicit tagIndexStr(const allocator_type& allocator = {}) : elements(allocator), attributeMap(allocator), typeNameMap(allocator) {}
+    std::pmr::vector<tinyxml2::XMLElement*> elements; // elements with the tag, in document order
+    std::pmr::map<std::string_view, attributeIndexStr, std::less<>> attributeMap; // attribute name -> attribute index
+    std::pmr::map<std::string_view, std::pmr::vector<tinyxml2::XMLElement*>, std::less<>> typeNameMap; // last part of the type attribute (e.g. "HaltAction" of "bt_interfaces/HaltAction") -> elements, in document order
+};
+
+struct elementIndexStr{
+    std::pmr::monotonic_buffer_resource arena{16 * 1024}; // storage of the maps and the vectors of the index
+    std::pmr::map<std::string_view, tagIndexStr, std::less<>> tagMap{&arena}; // tag name -> tag index
+    std::pmr::map<const tinyxml2::XMLElement*, size_t> documentOrder{&arena}; // position of each indexed element in document order
+};
+
+struct hlModelDataStr{
+    std::string fileName; // name of the High-Level SCXML file the model was loaded from
+    tinyxml2::XMLDocument doc; // parsed document, kept alive for the whole generation
+    tinyxml2::XMLElement* root = nullptr;
+    std::map<std::string, std::string> datamodelTypes; // datamodel variable id and type (e.g. "m_level" -> "int")
+    elementIndexStr elementIndex; // index of all the elements below root
+};
+
+struct attributeSubstitutionStr{
+    std::string attributeName;
+    std::string oldSubstring; // first occurrence is replaced
+    std::string newSubstring;
+};
+
+struct translationRuleStr{
+    std::string newTagName; // tag name after the translation, empty to keep the tag
+    bool deleteElement = false; // declarations not used by the SCXML (e.g. ros_service_server)
+    bool splitAcceptReject = false; // replace the element with an "accept" and a "reject" transition
+    std::vector<std::string> deletedAttributes;
+    std::vector<std::pair<std::string, std::string>> attributeRenames; // old attribute name -> new attribute name
+    std::vector<std::pair<std::string, std::string>> eventValueContaining; // event substring -> new event value (e.g. "tick" -> "CMD_TICK")
+    bool mapActionName = false; // replace the action client name with its action name
+    std::vector<attributeSubstitutionStr> substitutions; // applied in order
+    bool eventSlashToPoint = false;
+    std::string eventSuffix; // e.g. ".Call", ".Return", ".SendGoal"
+    bool fieldsToParam = false; // rename the <field> children to <param>
+};
+
+struct mappedFileStr{
+    std::string path;
+    const char* data = nullptr; // file content, mapped in memory or pointing into buffer
+    size_t size = 0;
+    std::string buffer; // file content when the file can not be mapped (e.g. pipes) or mapping is disabled
+    int64_t modificationTime = 0; // last write time, the file is mapped again when it changes
+    std::string_view view() const { return std::string_view(data ? data : "", size); }
+};
+
+struct interfaceFunctionStr{ // function of an interface of the specification (interfaces.xml)
+    std::string interfaceName; // interface of the component, also the package of its messages (e.g. "template_interfaces")
+    std::string interfaceType; // protocol of the function (e.g. "sync-service", "topic"), empty if not given
+    std::string requestDataType; // dataType of requestValue (e.g. std_msgs::msg::Bool), empty if not given
+    std::string returnDataType; // dataType of returnValue, empty if not given
+    std::vector<std::string> requestFields; // dataField of requestValue
+    std::vector<std::string> returnFields; // dataField of returnValue
+    std::map<std::string, std::string> interfaceData; // field and type, for the dataField elements with a type attribute
+};
+
+struct interfaceRegistryStr{ // components and interfaces of the specification, parsed once and shared by all the skills
+    std::string modelFileName; // e.g. full-model.xml
+    std::string interfaceFileName; // e.g. interfaces.xml
+    std::string hash; // hash of the content of both files
+    std::unordered_map<std::string, std::string> componentInterfaces; // componentDeclaration id -> interface id
+    std::unordered_map<std::string, interfaceFunctionStr> functions; // "componentName.functionName" -> function
+    std::vector<std::shared_ptr<const mappedFileStr>> files; // files the registry was parsed from, to detect their changes
+};
+
+struct validationDiagnosticStr{ // problem found in the input SCXML of a skill, see Validator
+    int line; // line of the element in the input file
+    bool error; // false for a warning, the skill is generated anyway
+    std::string message;
+};
+
+struct outputFileStr{ // generated file queued to the output writer
+    std::string filePath; // directory of the file
+    std::string fileName;
+    std::string content;
+};
+
+enum class templateNodeType{
+    literal,     // text copied as it is
+    placeholder, // $name$, replaced by its value
+    section,     // text between a marker and its END_ marker (e.g. /*TICK*/ ... /*END_TICK*/)
+    slot         // repeat slot marker (e.g. /*PARAM_LIST*/), where the event code is written
+};
+
+struct templateNodeStr{
+    templateNodeType type;
+    std::string text; // literal text, placeholder (e.g. "$className$") or marker (e.g. "/*TICK*/")
+    std::string endMarker; // section end marker (e.g. "/*END_TICK*/")
+    std::vector<templateNodeStr> children; // section content
 };
 
 struct templateFileDataStr{
-    std::string templatePath;
+    std::string templatePath; // directory of the templates, empty for the template_skill embedded at build time
     std::string hFile;
     std::string cppFile;
     std::string hDatamodelFile;
@@ -117,37 +263,78 @@ struct templateFileDataStr{
     std::string CMakeListsFile;
     std::string packageFile;
     std::string mainFile;
+    std::vector<std::shared_ptr<const mappedFileStr>> templateFiles; // mapped template files, kept while codeMap is used
+    std::map<std::string, std::string_view> codeMap; // template code over templateFiles or the embedded templates, read once and shared by all the skills generated by the process
+    std::map<std::string, std::vector<templateNodeStr>> compiledMap; // compiled codeMap, shared by all the skills
+};
+
+struct templateFragmentStr;
+
+struct templateSlotStr{ // slot reachable from a fragment, in its nodes or in the fragments written in its slots
+    templateFragmentStr* fragment; // fragment whose nodes contain the slot
+    const templateNodeStr* slot;
+    std::vector<const templateNodeStr*> sections; // sections enclosing the slot, it is written only while they are all written
+    std::vector<std::vector<const templateNodeStr*>> truncations; // sections enclosing the truncate markers before the slot, it is not written once they are all written
+};
+
+struct templateSlotIndexStr{ // slots of a fragment by marker, built by its first writeToSlot and extended with the fragments written in them
+    bool built = false;
+    std::map<std::string_view, std::vector<templateSlotStr>, std::less<>> slots; // slot marker -> slots, in document order
+    // the index points to the fragment and its content: a copied or moved fragment builds its own index again
+    templateSlotIndexStr() = default;
+    templateSlotIndexStr(const templateSlotIndexStr&) {}
+    templateSlotIndexStr& operator=(const templateSlotIndexStr&) { built = false; slots.clear(); return *this; }
 };
 
-struct savedCodeStr{
-    std::string eventC;
-    std::string interfaceH;
-    std::string sendParam;
-    std::string returnParam;
-    std::string interfaceCMake;
-    std::string packageCMake;
-    std::string interfaceXML;
-    std::string topicSubscriptionC;
-    std::string topicCallbackC;  
-    std::string topicSubscriptionH;
-    std::string topicCallbackH; 
-    std::string topicInterfaceH; 
-    std::string topicParamList;
-    std::string serviceClientH;
-    std::string actionC;
-    std::string actionH;
-    std::string actionInterfaceH;
-    std::string actionSendParam;
-    std::string actionFeedbackParam;
-    std::string actionFeedbackParamFnc;
-    std::string actionFeedbackData;
-    std::string actionSendGoalLambda;
-    std::string actionResultRequestLambda;
-    std::string actionFeedbackLambda;   
-    std::string actionSendGoalFnc; 
-    std::string actionResultCallbackFnc; 
-    std::string actionFeedbackCallback; 
-    std::string actionGoalResponseFnc; 
+struct templateFragmentStr{
+    const std::vector<templateNodeStr>* nodes = nullptr; // compiled template or snippet, nullptr for plain text
+    std::string text; // plain text, used when nodes is nullptr
+    std::map<std::string_view, std::string, std::less<>> values; // placeholder (string literal, not copied) -> value, local to the fragment
+    std::map<const templateNodeStr*, std::deque<templateFragmentStr>> slotContent; // fragments written in each slot, in writing order (a deque keeps their address, used by slotIndex)
+    templateSlotIndexStr slotIndex; // slots of the fragment, see writeToSlot
+};
+
+struct templateContextStr{
+    std::map<std::string_view, std::string, std::less<>> values; // placeholder (string literal, not copied) -> value, shared by all the fragments
+    std::map<std::string, bool> sections; // section marker -> keep the content (true) or delete it (false), other sections are left as they are
+    std::set<std::string> snippets; // section markers of the snippets, never written in place
+    std::string truncateMarker; // section marker from which the rest of the template is dropped
+};
+
+struct interfaceDependenciesStr{ // interface packages used by a skill
+    std::vector<std::string> names; // in order of first use
+    std::set<std::string> index; // names already added
+};
+
+struct savedCodeStr{ // snippet sections of the compiled templates, nullptr if not found
+    const templateNodeStr* eventC = nullptr;
+    const templateNodeStr* interfaceH = nullptr;
+    const templateNodeStr* sendParam = nullptr;
+    const templateNodeStr* returnParam = nullptr;
+    const templateNodeStr* interfaceCMake = nullptr;
+    const templateNodeStr* packageCMake = nullptr;
+    const templateNodeStr* interfaceXML = nullptr;
+    const templateNodeStr* topicSubscriptionC = nullptr;
+    const templateNodeStr* topicCallbackC = nullptr;
+    const templateNodeStr* topicSubscriptionH = nullptr;
+    const templateNodeStr* topicCallbackH = nullptr;
+    const templateNodeStr* topicInterfaceH = nullptr;
+    const templateNodeStr* topicParamList = nullptr;
+    const templateNodeStr* serviceClientH = nullptr;
+    const templateNodeStr* actionC = nullptr;
+    const templateNodeStr* actionH = nullptr;
+    const templateNodeStr* actionInterfaceH = nullptr;
+    const templateNodeStr* actionSendParam = nullptr;
+    const templateNodeStr* actionFeedbackParam = nullptr;
+    const templateNodeStr* actionFeedbackParamFnc = nullptr;
+    const templateNodeStr* actionFeedbackData = nullptr;
+    const templateNodeStr* actionSendGoalLambda = nullptr;
+    const templateNodeStr* actionResultRequestLambda = nullptr;
+    const templateNodeStr* actionFeedbackLambda = nullptr;
+    const templateNodeStr* actionSendGoalFnc = nullptr;
+    const templateNodeStr* actionResultCallbackFnc = nullptr;
+    const templateNodeStr* actionFeedbackCallback = nullptr;
+    const templateNodeStr* actionGoalResponseFnc = nullptr;
 };
 
 struct cppCodeStr
@@ -193,7 +380,62 @@ struct topicCodeStr
     std::string callbacksCode;
 };
 
-static std::map<std::string, eventDataStr> eventsMap;
+struct eventCacheEntryStr{ // event data resolved in a previous run, see EventCache
+    eventDataStr eventData;
+    std::string errors; // messages written to the error stream while the event was resolved, written again when it is read
+};
+
+struct eventCacheStr{ // resolved events of a skill, stored in one file of the cache directory
+    std::string filePath; // cache file of the skill, empty if the cache is disabled
+    std::map<std::string, eventCacheEntryStr> entries; // event string -> resolved event data
+    bool modified = false; // true if entries were added since the file was read
+};
+
+struct generationManifestStr{
+    std::map<std::string, std::string> key; // entries of the generation key (e.g. "input" -> hash of the input SCXML)
+    std::map<std::string, std::string> files; // generated file relative to the output directory -> hash of its content
+};
+
+enum class logLevel{
+    debug,   // generation steps, shown with --verbose_mode
+    info,
+    warning, // shown by default
+    error,
+    off
+};
+
+struct logConfigStr{ // set once by main before the generation starts
+    logLevel level = logLevel::warning; // messages of this level and above are written to the output streams
+    size_t bufferSize = 0; // number of messages of any level kept for print_log, 0 to keep none
+};
+
+inline logConfigStr logConfig;
+
+struct traceEventStr{ // phase of the generation timed with TRACE_PHASE
+    const char* name; // phase name (e.g. "replaceEventCode")
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::duration duration;
+    size_t allocations; // allocations made by the thread during the phase, see allocationCount
+    std::string detail; // e.g. the event or the file of the phase, empty if not given
+    unsigned int thread; // index of the thread, in order of first traced phase
+};
+
+// Allocations made by the current thread, counted by the executables that replace operator new (e.g. model2code_bench), always 0 otherwise
+inline thread_local size_t allocationCount = 0;
+
+struct generationContextStr{ // messages of the skill being generated by the current thread
+    bool buffered = false; // true to keep the messages until the skill is done (e.g. skills generated in parallel), false to print them directly
+    bool trace = false; // true to record the phases of the generation in traceEvents
+    std::vector<traceEventStr> traceEvents; // phases of the generation, in order of completion
+    std::map<std::string, uint64_t> traceCounters; // counters of the generation (e.g. "events processed")
+    std::deque<std::string> log; // last logConfig.bufferSize log messages
+    std::ostringstream output; // buffered standard output messages
+    std::ostringstream errors; // buffered standard error messages
+    std::vector<std::shared_ptr<generationContextStr>> tasks; // contexts of the background tasks of the skill, merged when they are joined
+    std::vector<std::shared_future<bool>> writes; // background writes of the skill (e.g. its files), waited for when the tasks are joined
+    bool inMemory = false; // true to keep the generated files in files instead of writing them (e.g. generate of the library)
+    std::vector<outputFileStr> files; // generated files, in order of generation, when inMemory is true
+};
 
 /**
  * @brief Get component and function data from event string (Format: componentName.functionName.eventName)
@@ -209,28 +451,28 @@ void getDataFromEvent(eventDataStr& eventData);
  * @param skillData skill data structure passed by reference where the skill data is stored
  * @return bool 
  */
-bool getDataFromRootName(const std::string attributeName, skillDataStr& skillData);
+bool getDataFromRootName(const std::string& attributeName, skillDataStr& skillData);
 
 /**
  * @brief Prints the event data
  * 
  * @param eventData event data structure to be printed
  */
-void printEventData(eventDataStr eventData);
+void printEventData(const eventDataStr& eventData);
 
 /**
  * @brief Prints the event data to cerr
  * 
  * @param eventData event data structure to be printed
  */
-void printEventDataToCerr(eventDataStr eventData);
+void printEventDataToCerr(const eventDataStr& eventData);
 
 /**
  * @brief Prints the skill data
  * 
  * @param skillData skill data structure to be printed
  */
-void printSkillData(skillDataStr skillData);
+void printSkillData(const skillDataStr& skillData);
 
 /**
  * @brief Set the File Data object
@@ -238,17 +480,97 @@ void printSkillData(skillDataStr skillData);
  * @param fileData file data structure passed by reference where the file data is stored
  * @param skillData const skill data structure used to set the file data
  */
-void setFileData(fileDataStr& fileData, const skillDataStr skillData);
+void setFileData(fileDataStr& fileData, const skillDataStr& skillData);
+
+/**
+ * @brief Set the generation context of the current thread
+ * 
+ * @param context generation context of the skill, nullptr to go back to the default context that prints the messages directly
+ */
+void set_generation_context(generationContextStr* context);
+
+/**
+ * @brief Get the generation context of the current thread
+ * 
+ * @return generationContextStr& 
+ */
+generationContextStr& get_generation_context();
+
+/**
+ * @brief Merge the messages, phases and counters of a finished context in the generation context of the current thread
+ * 
+ * @param finished context of a task or of a step of the generation, run with set_generation_context
+ */
+void merge_generation_context(const generationContextStr& finished);
+
+/**
+ * @brief Wait for the background writes of the generation context of the current thread and merge the messages of its tasks
+ * 
+ * @return true if all the writes succeeded
+ * @return false 
+ */
+bool join_generation_tasks();
+
+/**
+ * @brief Get the standard output stream of the skill being generated by the current thread
+ * 
+ * @return std::ostream& buffered stream of the skill or std::cout
+ */
+std::ostream& output_stream();
+
+/**
+ * @brief Get the standard error stream of the skill being generated by the current thread
+ * 
+ * @return std::ostream& buffered stream of the skill or std::cerr
+ */
+std::ostream& error_stream();
+
+struct traceScopeStr{ // used by TRACE_PHASE, records a phase from its construction to its destruction
+    explicit traceScopeStr(const char* name);
+    ~traceScopeStr();
+    const char* name;
+    bool enabled; // true if the generation context traces the phases
+    std::chrono::steady_clock::time_point start;
+    size_t allocations;
+    std::string detail;
+};
+
+/**
+ * @brief Check if the messages of a log level are written or kept, used by LOG_MESSAGE before formatting the message
+ * 
+ * @param level log level
+ * @return true 
+ * @return false 
+ */
+inline bool log_enabled(const logLevel level) {
+    return level >= logConfig.level || (logConfig.bufferSize > 0 && level != logLevel::off);
+}
+
+/**
+ * @brief Write a message to the log, use the LOG_ macros instead so that disabled messages are not formatted
+ * 
+ * @param level log level
+ * @param message log message
+ */
+void write_log(const logLevel level, const std::string& message);
+
+/**
+ * @brief Get a log level from its name
+ * 
+ * @param name level name (debug, info, warning, error, off)
+ * @param level log level returned by reference
+ * @return true 
+ * @return false if the name is not a log level
+ */
+bool getLogLevel(const std::string& name, logLevel& level);
 
 /**
- * @brief Add a message to the log
+ * @brief print the last log messages kept in the generation context, used when a skill fails
  * 
- * @param fileName file name
- * @param path path passed by reference where the path is stored
  */
-void add_to_log(const std::string& message);
+void print_log();
 /**
- * @brief print the log
+ * @brief clear the log messages kept in the generation context, used between the skills generated in batch mode
  * 
  */
-void print_log();
\ No newline at end of file
+void clear_log();
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file EventCache.h
+ * @brief This file contains the functions to keep the resolved event data of the skills on disk between the runs.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+
+#include "Data.h"
+
+/**
+ * @brief Enable or disable the event cache
+ *
+ * @param directory cache directory, empty to disable the cache
+ * @param maxSize maximum size in bytes of the cache files, see trimEventCache
+ */
+void setEventCache(const std::string& directory, uintmax_t maxSize);
+
+/**
+ * @brief Get the default cache directory: $XDG_CACHE_HOME/model2code or ~/.cache/model2code
+ *
+ * @return std::string cache directory, empty if neither XDG_CACHE_HOME nor HOME is set
+ */
+std::string getDefaultCacheDirectory();
+
+/**
+ * @brief Read the cached events of a skill, the cache file is identified by the content and the path of the input file
+ *
+ * @param fileData file data structure of the skill
+ * @param cache cache of the skill passed by reference, its file path is left empty when the cache is disabled
+ * @return true if cached events were read
+ * @return false if the cache is disabled or has no valid file for the skill (no error is printed)
+ */
+bool readEventCache(const fileDataStr& fileData, eventCacheStr& cache);
+
+/**
+ * @brief Write the cache file of a skill if events were added to it
+ *
+ * @param cache cache of the skill
+ * @return true
+ * @return false if the file can not be written, a warning is printed
+ */
+bool writeEventCache(eventCacheStr& cache);
+
+/**
+ * @brief Remove the least recently used cache files until the cache fits in its maximum size
+ *
+ */
+void trimEventCache();
@@ -9,7 +9,10 @@
  * 
  */
 
+#pragma once
+
 #include "tinyxml2.h"
+#include "Data.h"
 #include <iostream>
 #include <string>
 #include <algorithm>
@@ -77,3 +80,125 @@ void findElementVectorByTagAndAttribute(tinyxml2::XMLElement* root, const std::s
  */
 void findElementVectorByTag(tinyxml2::XMLElement* root, const std::string tag, std::vector<tinyxml2::XMLElement*>& elementVector);
 
+/**
+ * @brief Find a XML element by tag and attribute name where the attribute's value contains a specific substring
+ * 
+ * @param root root element from which to start the search
+ * @param tag tag name to look for
+ * @param attributeName attribute name to look for inside the tag
+ * @param substring substring to check for in the attribute value
+ * @param element element found returned by reference
+ * @return true if an element with the tag and attribute containing the substring is found
+ * @return false otherwise
+ */
+bool findElementByTagAndAttValueContaining(tinyxml2::XMLElement* root, const std::string& tag, const std::string& attributeName, const std::string& substring, tinyxml2::XMLElement*& element);
+
+/**
+ * @brief Get the element following a given element in document order, without leaving the subtree of root
+ * 
+ * @param root root element of the subtree being visited
+ * @param element current element
+ * @return tinyxml2::XMLElement* next element, nullptr when the subtree has been fully visited
+ */
+tinyxml2::XMLElement* nextElementInTree(tinyxml2::XMLElement* root, tinyxml2::XMLElement* element);
+
+/**
+ * @brief Get the element following the subtree of a given element in document order, without leaving the subtree of root
+ * 
+ * @param root root element of the subtree being visited
+ * @param element current element, its children are skipped
+ * @return tinyxml2::XMLElement* next element, nullptr when the subtree has been fully visited
+ */
+tinyxml2::XMLElement* nextElementAfterSubtree(tinyxml2::XMLElement* root, tinyxml2::XMLElement* element);
+
+/**
+ * @brief Build the index of all the elements below root (tag -> attribute -> value -> elements) in a single traversal
+ * 
+ * @param root root element from which to start the traversal
+ * @param index element index passed by reference where the elements are stored
+ */
+void buildElementIndex(tinyxml2::XMLElement* root, elementIndexStr& index);
+
+/**
+ * @brief Find a XML element by tag and attribute name and value using the element index
+ * 
+ * @param index element index built with buildElementIndex
+ * @param tag tag name to look for
+ * @param attributeName attribute name to look for inside the tag
+ * @param attributeValue attribute value associated with the attribute name to look for
+ * @param element first element found in document order returned by reference
+ * @return true 
+ * @return false 
+ */
+bool findElementByTagAndAttValue(const elementIndexStr& index, std::string_view tag, std::string_view attributeName, std::string_view attributeValue, tinyxml2::XMLElement*& element);
+
+/**
+ * @brief Find a XML element by tag using the element index
+ * 
+ * @param index element index built with buildElementIndex
+ * @param tag tag name to look for
+ * @param element first element found in document order returned by reference
+ * @return true 
+ * @return false 
+ */
+bool findElementByTag(const elementIndexStr& index, std::string_view tag, tinyxml2::XMLElement*& element);
+
+/**
+ * @brief Find a vector of XML elements by tag and attribute name using the element index
+ * 
+ * @param index element index built with buildElementIndex
+ * @param tag tag name to look for
+ * @param attribute attribute name to look for inside the tag
+ * @param elementVector element vector where the elements found are appended in document order
+ */
+void findElementVectorByTagAndAttribute(const elementIndexStr& index, std::string_view tag, std::string_view attribute, std::vector<tinyxml2::XMLElement*>& elementVector);
+
+/**
+ * @brief Find a vector of XML elements by tag using the element index
+ * 
+ * @param index element index built with buildElementIndex
+ * @param tag tag name to look for
+ * @param elementVector element vector where the elements found are appended in document order
+ */
+void findElementVectorByTag(const elementIndexStr& index, std::string_view tag, std::vector<tinyxml2::XMLElement*>& elementVector);
+
+/**
+ * @brief Find a XML element by tag and attribute name where the attribute's value contains a specific substring using the element index
+ * 
+ * The substring is searched in each distinct value of the attribute, so a query is linear in the number of values;
+ * findElementByTagAndTypeSuffix looks up the type attributes in the index instead.
+ * 
+ * @param index element index built with buildElementIndex
+ * @param tag tag name to look for
+ * @param attributeName attribute name to look for inside the tag
+ * @param substring substring to check for in the attribute value
+ * @param element first element found in document order returned by reference
+ * @return true if an element with the tag and attribute containing the substring is found
+ * @return false otherwise
+ */
+bool findElementByTagAndAttValueContaining(const elementIndexStr& index, std::string_view tag, std::string_view attributeName, std::string_view substring, tinyxml2::XMLElement*& element);
+
+/**
+ * @brief Find a XML element by tag whose type attribute ends with a given suffix using the element index
+ * 
+ * The elements are looked up by the last part of their type (e.g. "HaltAction"), then their whole type is compared.
+ * 
+ * @param index element index built with buildElementIndex
+ * @param tag tag name to look for
+ * @param typeSuffix end of the type attribute (e.g. "bt_interfaces/HaltAction")
+ * @param element first element found in document order returned by reference
+ * @return true if an element with the tag and a type ending with the suffix is found
+ * @return false otherwise
+ */
+bool findElementByTagAndTypeSuffix(const elementIndexStr& index, std::string_view tag, std::string_view typeSuffix, tinyxml2::XMLElement*& element);
+
+/**
+ * @brief Find a vector of XML elements by tag and attribute name where the attribute's value starts with a specific prefix using the element index
+ * 
+ * @param index element index built with buildElementIndex
+ * @param tag tag name to look for
+ * @param attributeName attribute name to look for inside the tag
+ * @param prefix prefix of the attribute value
+ * @param elementVector element vector where the elements found are appended in document order
+ */
+void findElementVectorByTagAndAttValuePrefix(const elementIndexStr& index, std::string_view tag, std::string_view attributeName, std::string_view prefix, std::vector<tinyxml2::XMLElement*>& elementVector);
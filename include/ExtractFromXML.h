@@ -13,31 +13,45 @@
 #include <map>
 #include "tinyxml2.h"
 #include "Data.h"
+#include "InputFile.h"
+#include "InterfaceRegistry.h"
 #include "ExtractFromElement.h"
 
 
+/**
+ * @brief Load the High-Level SCXML file once and build the tables shared by all the events
+ * 
+ * @param fileName file name of the High-Level SCXML file
+ * @param hlModel model structure passed by reference where the document, the root, the datamodel types and the element index are stored
+ * @return true 
+ * @return false 
+ */
+bool loadHLModel(const std::string& fileName, hlModelDataStr& hlModel);
+
 /**
  * @brief  
  * 
  * @param fileData 
+ * @param hlModel High-Level SCXML model loaded with loadHLModel
  * @param eventData 
  * @return true 
  * @return false 
  */
-bool extractInterfaceData(const fileDataStr fileData, eventDataStr& eventData);
+bool extractInterfaceData(const fileDataStr& fileData, hlModelDataStr& hlModel, eventDataStr& eventData);
 
 
 /**
  * @brief 
  * 
  * @param fileData 
+ * @param hlModel High-Level SCXML model loaded with loadHLModel
  * @param eventData 
  * @param element 
  * @param rosInterfaceType 
  * @return true 
  * @return false 
  */
- bool findInterfaceType(const fileDataStr fileData, eventDataStr& eventData, tinyxml2::XMLElement*& element);
+ bool findInterfaceType(const fileDataStr& fileData, hlModelDataStr& hlModel, eventDataStr& eventData, tinyxml2::XMLElement*& element);
 
 /**
  * @brief Get the Interface Fields From Name object
@@ -114,6 +128,18 @@ bool getEventDataFields(tinyxml2::XMLElement * elementFunction, eventDataStr& ev
  * @return true 
  * @return false 
  */
-bool extractSCXMLData(const fileDataStr fileData, eventDataStr &eventData);
-bool parseInterfaceTypesFromSCXML(const fileDataStr fileData, eventDataStr& eventData);
+bool extractSCXMLData(const fileDataStr& fileData, eventDataStr &eventData);
+bool parseInterfaceTypesFromSCXML(const hlModelDataStr& hlModel, eventDataStr& eventData);
 bool extractFromSCXML(tinyxml2::XMLDocument& doc, const std::string fileName, std::string& rootName, std::vector<tinyxml2::XMLElement*>& elementsTransition, std::vector<tinyxml2::XMLElement*>& elementsSend); 
+
+/**
+ * @brief Extract data from a SCXML document already in memory (rootname, transition and send event elements)
+ * 
+ * @param doc SCXML document object, e.g. the document produced by the Translator
+ * @param rootName name value of the root element of the SCXML document
+ * @param elementsTransition vector of transition event elements found in the SCXML document
+ * @param elementsSend vector of send event elements found in the SCXML document
+ * @return true 
+ * @return false 
+ */
+bool extractFromSCXMLDocument(tinyxml2::XMLDocument& doc, std::string& rootName, std::vector<tinyxml2::XMLElement*>& elementsTransition, std::vector<tinyxml2::XMLElement*>& elementsSend);
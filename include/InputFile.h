@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file InputFile.h
+ * @brief This file contains the functions to map the input files (SCXML and templates) in memory once per process.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+
+#include "Data.h"
+
+/**
+ * @brief Map a file in memory, the mapping is shared with the other users of the file while it is alive
+ *
+ * @param filePath path of the file
+ * @return std::shared_ptr<const mappedFileStr> mapped file, nullptr if the file can not be read (no error is printed)
+ */
+std::shared_ptr<const mappedFileStr> mapInputFile(const std::string& filePath);
+
+/**
+ * @brief Enable or disable the mapping of the files, when disabled the files are read in memory
+ *
+ * @param enabled true to map the files (default), false to read them (e.g. files edited in place while watched)
+ */
+void setInputFileMapping(bool enabled);
+
+/**
+ * @brief Parse a XML file from its mapped content
+ *
+ * @param doc XMLDocument where the file is parsed
+ * @param filePath path of the file
+ * @return true
+ * @return false if the file can not be read or parsed, the error is printed
+ */
+bool parseInputFile(tinyxml2::XMLDocument& doc, const std::string& filePath);
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file InterfaceRegistry.h
+ * @brief This file contains the functions to read the components and the interfaces of the specification once per process.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+
+#include "Data.h"
+
+/**
+ * @brief Parse the components of the model file and the interfaces of the interface file in a registry
+ *
+ * @param modelFileName model file with the componentDeclaration elements (e.g. full-model.xml)
+ * @param interfaceFileName interface file with the interface elements (e.g. interfaces.xml), empty to use the path of the interfaces element of the model file
+ * @param registry registry passed by reference where the components and their functions are stored
+ * @return true
+ * @return false if a file can not be read or parsed, the error is printed
+ */
+bool loadInterfaceRegistry(const std::string& modelFileName, const std::string& interfaceFileName, interfaceRegistryStr& registry);
+
+/**
+ * @brief Get the registry of the specification, parsed once and shared by all the skills while its files do not change
+ *
+ * @param modelFileName model file with the componentDeclaration elements, empty if there is no specification
+ * @param interfaceFileName interface file, empty to use the path of the interfaces element of the model file
+ * @return std::shared_ptr<const interfaceRegistryStr> registry, nullptr if there is no specification or it can not be loaded
+ */
+std::shared_ptr<const interfaceRegistryStr> getInterfaceRegistry(const std::string& modelFileName, const std::string& interfaceFileName);
+
+/**
+ * @brief Find the function of an event in the registry (key "componentName.functionName")
+ *
+ * @param registry registry of the specification
+ * @param componentName component of the event
+ * @param functionName function of the event
+ * @return const interfaceFunctionStr* function, nullptr if the component or its function is not in the specification
+ */
+const interfaceFunctionStr* findInterfaceFunction(const interfaceRegistryStr& registry, const std::string& componentName, const std::string& functionName);
+
+/**
+ * @brief Set the interface data of an event from the specification, used for the events without a ROS element in the High-Level SCXML
+ *
+ * @param registry registry of the specification
+ * @param eventData event data structure passed by reference where the interface data is stored
+ * @return true
+ * @return false if the function of the event is not in the specification or has no protocol
+ */
+bool getInterfaceFromRegistry(const interfaceRegistryStr& registry, eventDataStr& eventData);
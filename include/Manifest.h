@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file Manifest.h
+ * @brief This file contains the functions to skip the generation of the skills whose inputs did not change.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+
+#include "Data.h"
+
+/**
+ * @brief Compute the hash of a content (64 bit FNV-1a, stable across platforms and runs)
+ *
+ * @param content content to be hashed
+ * @return std::string hexadecimal hash
+ */
+std::string hashContent(std::string_view content);
+
+/**
+ * @brief Get the generation key of a skill: tool version, options, input SCXML and templates
+ *
+ * @param fileData file data structure of the skill
+ * @param templateFileData template file data structure with the templates already read
+ * @param manifest manifest passed by reference where the generation key is stored
+ * @return true
+ * @return false if the input file can not be read
+ */
+bool getGenerationKey(const fileDataStr& fileData, const templateFileDataStr& templateFileData, generationManifestStr& manifest);
+
+/**
+ * @brief Check if the output directory already contains the code generated with the same generation key
+ *
+ * @param fileData file data structure of the skill
+ * @param manifest manifest with the generation key of the skill
+ * @return true if the manifest of the output directory has the same key and all the generated files are unchanged
+ * @return false
+ */
+bool isGenerationUpToDate(const fileDataStr& fileData, const generationManifestStr& manifest);
+
+/**
+ * @brief Write the manifest of the generated files in the output directory
+ *
+ * @param fileData file data structure of the skill, with the names of the generated files
+ * @param manifest manifest with the generation key of the skill, the hashes of the generated files are added
+ * @return true
+ * @return false
+ */
+bool writeManifest(const fileDataStr& fileData, generationManifestStr& manifest);
@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file Model2Code.h
+ * @brief This file contains the functions of the model2code library to translate and generate the skills, used by the command line tool.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+
+#include "Translator.h"
+#include "Manifest.h"
+#include "Validator.h"
+
+/**
+ * @brief Set the output paths of a skill, if no output path is provided it is taken from the input file name
+ * 
+ * @param fileData file data structure passed by reference where the output paths are stored
+ * @return true 
+ * @return false 
+ */
+bool setOutputPaths(fileDataStr& fileData);
+
+/**
+ * @brief Translate and generate the code of a skill
+ * 
+ * The files are written in background: the result of their writes is returned by join_generation_tasks.
+ * 
+ * @param fileData file data structure of the skill
+ * @param templateFileData template file data structure, the templates are read by the first skill and reused by the next ones
+ * @param upToDate set to true if the skill is skipped because its inputs and its generated files did not change
+ * @return true if the skill is generated successfully or is up to date
+ * @return false 
+ */
+bool generateSkill(fileDataStr fileData, templateFileDataStr& templateFileData, bool& upToDate);
+
+/**
+ * @brief Translate the High-Level SCXML of a skill in memory
+ * 
+ * The translated SCXML is kept in the files of the context instead of being written, and the messages are written in
+ * the context (buffered if context.buffered is true). Generations with different contexts can run concurrently.
+ * 
+ * @param context generation context of the translation, set as the context of the current thread while translating
+ * @param fileData file data structure of the skill with the input file name and the options
+ * @param translatedDoc document passed by reference where the translated SCXML is stored
+ * @return true if the skill is translated successfully
+ * @return false 
+ */
+bool translate(generationContextStr& context, fileDataStr fileData, tinyxml2::XMLDocument& translatedDoc);
+
+/**
+ * @brief Translate and generate the code of a skill in memory
+ * 
+ * The generated files (translated SCXML, header, source, CMakeLists.txt, package.xml, ...) are kept in the files of the
+ * context instead of being written, and the messages are written in the context (buffered if context.buffered is
+ * true). Generations with different contexts can run concurrently and share templateFileData: its templates are read by
+ * the first one, the others wait for them. Its templates must not be cleared or changed (e.g. templatePath) while a
+ * generation sharing it runs.
+ * 
+ * @param context generation context of the skill, set as the context of the current thread while generating
+ * @param fileData file data structure of the skill with the input file name and the options, the output path is only used as path of the files
+ * @param templateFileData template file data structure, the templates are read by the first generation and reused by the next ones
+ * @return true if the skill is generated successfully
+ * @return false 
+ */
+bool generate(generationContextStr& context, fileDataStr fileData, templateFileDataStr& templateFileData);
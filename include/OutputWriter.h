@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file OutputWriter.h
+ * @brief This file contains the functions to write the generated files in background, without leaving partially written files.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+
+#include "Data.h"
+#include <future>
+#include <functional>
+#include <cstdio>
+
+/**
+ * @brief Queue files to the background writer, the files are written in order of queueing
+ *
+ * The messages and the phases of the writer are kept in a task of the generation context of the current thread and
+ * merged by join_generation_tasks once the returned future is ready. When the generation context is in memory the files
+ * are moved to its files instead and nothing is written.
+ *
+ * @param phase name of the traced phase of the write (e.g. "writeFiles")
+ * @param files files to be written, an existing file with the same content is left untouched
+ * @return std::future<bool> true when all the files are written
+ */
+std::future<bool> queueOutputFiles(const char* phase, std::vector<outputFileStr> files);
+
+/**
+ * @brief Queue a task to the background writer, it is run once the files queued before it are written
+ *
+ * The messages and the phases of the task are kept as the ones of queueOutputFiles.
+ *
+ * @param phase name of the traced phase of the task (e.g. "writeManifest")
+ * @param task task to be run by the writer thread
+ * @return std::future<bool> result of the task
+ */
+std::future<bool> queueOutputTask(const char* phase, std::function<bool()> task);
+
+/**
+ * @brief Open the temporary file of a file written as a stream, it replaces the previous file with commitOutputStream
+ *
+ * @param filePath directory of the file
+ * @param fileName name of the file
+ * @return FILE* temporary file, nullptr if it can not be opened (the error is printed)
+ */
+FILE* openOutputStream(const std::string& filePath, const std::string& fileName);
+
+/**
+ * @brief Close a file opened with openOutputStream and rename it over the previous file, unless they have the same content
+ *
+ * The messages and the phase of the write are kept in a task of the generation context of the current thread, in the
+ * same order as the files queued with queueOutputFiles.
+ *
+ * @param stream temporary file, closed
+ * @param phase name of the traced phase of the write (e.g. "writeTranslatedSM")
+ * @param filePath directory of the file
+ * @param fileName name of the file
+ * @return true
+ * @return false if the file can not be written
+ */
+bool commitOutputStream(FILE* stream, const char* phase, const std::string& filePath, const std::string& fileName);
+
+/**
+ * @brief Wait for the queued files and sync the directories of the written files when the sync is enabled
+ *
+ * @return true
+ * @return false if a directory can not be synced
+ */
+bool flushOutputFiles();
+
+/**
+ * @brief Enable or disable the sync of the generated files to disk
+ *
+ * @param enabled true to sync the files before they replace the previous ones and their directories at the flush
+ */
+void setOutputSync(bool enabled);
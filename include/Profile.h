@@ -0,0 +1,33 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file Profile.h
+ * @brief This file contains the functions to write the phases traced during the generation as a profile.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+
+#include "Data.h"
+
+/**
+ * @brief Write the traced phases as Chrome trace-event JSON, which can be opened in Perfetto or chrome://tracing
+ *
+ * @param fileName profile file
+ * @param events traced phases
+ * @param counters counters of the generation, written as counter events at the end of the profile
+ * @return true
+ * @return false if the file can not be written
+ */
+bool writeProfile(const std::string& fileName, const std::vector<traceEventStr>& events, const std::map<std::string, uint64_t>& counters);
+
+/**
+ * @brief Print the phases with the highest self time (time not spent in nested phases) and the counters
+ *
+ * @param events traced phases
+ * @param counters counters of the generation
+ * @param topCount number of phases printed
+ */
+void printProfileSummary(const std::vector<traceEventStr>& events, const std::map<std::string, uint64_t>& counters, size_t topCount);
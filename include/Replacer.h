@@ -10,90 +10,144 @@
  */
 
 #include "ExtractFromXML.h"
+#include "Template.h"
+#include "OutputWriter.h"
+#include "EventCache.h"
 #include <fstream>
 
 /**
  * @brief Get the Event Data from the model and interface files 
  * 
  * @param fileData file data structure passed by reference from which the event data is extracted
- * @param eventData event data structure passed by reference where the event data is stored
+ * @param hlModel High-Level SCXML model shared by all the events, loaded by the first event missing from the cache
+ * @param eventCache cached events of the skill passed by reference, the resolved events are added to it
+ * @param eventData event data structure of the event, moved to eventsMap once resolved
+ * @param eventsMap events of the skill passed by reference where the event data is stored
  */
-bool getEventData(fileDataStr fileData, eventDataStr& eventData);
+bool getEventData(const fileDataStr& fileData, hlModelDataStr& hlModel, eventCacheStr& eventCache, eventDataStr& eventData, std::map<std::string, eventDataStr>& eventsMap);
 
 /**
  * @brief Get the Event Data from the vector of event elements
  * 
  * @param fileData file data structure passed by reference where the file data is stored
+ * @param hlModel High-Level SCXML model shared by all the events, loaded by the first event missing from the cache
+ * @param eventCache cached events of the skill passed by reference, the resolved events are added to it
  * @param elementsTransition vector of transition event elements
  * @param elementsSend vector of send event elements
+ * @param eventsMap events of the skill passed by reference where the event data is stored
  */
-bool getEventsVecData(fileDataStr fileData, const std::vector<tinyxml2::XMLElement*> elementsTransition, const std::vector<tinyxml2::XMLElement*> elementsSend);
+bool getEventsVecData(const fileDataStr& fileData, hlModelDataStr& hlModel, eventCacheStr& eventCache, const std::vector<tinyxml2::XMLElement*>& elementsTransition, const std::vector<tinyxml2::XMLElement*>& elementsSend, std::map<std::string, eventDataStr>& eventsMap);
 
 /**
  * @brief function to keep or delete the sections of the code related to the Command Tick event
  * 
- * @param code string of code to be modified
+ * @param context template context where the sections to keep or delete are stored
  * @param keepFlag flag to keep or delete the sections
  */
-void handleCmdTickEvent(std::string& code,const bool keepFlag);
+void handleCmdTickEvent(templateContextStr& context, const bool keepFlag);
 
 /**
  * @brief function to keep or delete the sections of the code related to the Command Halt event
  * 
- * @param code string of code to be modified
+ * @param context template context where the sections to keep or delete are stored
  * @param keepFlag flag to keep or delete the sections
  */
-void handleCmdHaltEvent(std::string& code,const bool keepFlag);
+void handleCmdHaltEvent(templateContextStr& context, const bool keepFlag);
 
 /**
  * @brief function to keep or delete the sections of the code related to the Response Tick event
  * 
- * @param code string of code to be modified
+ * @param context template context where the sections to keep or delete are stored
  * @param keepFlag flag to keep or delete the sections
  */
-void handleRspTickEvent(std::string& code,const bool keepFlag);
+void handleRspTickEvent(templateContextStr& context, const bool keepFlag);
 
 /**
  * @brief function to keep or delete the sections of the code related to the Response Halt event
  * 
- * @param code string of code to be modified
+ * @param context template context where the sections to keep or delete are stored
  * @param keepFlag flag to keep or delete the sections
  */
-void handleRspHaltEvent(std::string& code,const bool keepFlag);
+void handleRspHaltEvent(templateContextStr& context, const bool keepFlag);
 
 /**
- * @brief function to write the generic event code in the output string
+ * @brief function that sets the common event placeholders of a fragment
  * 
+ * @param fragment fragment where the placeholder values are stored
  * @param eventData event data structure containing event information
+ */
+void setCommonEventValues(templateFragmentStr& fragment, const eventDataStr& eventData);
+
+/**
+ * @brief function that adds an interface to the dependencies of the skill, if it is not already there
+ * 
+ * @param dependencies dependencies of the skill
+ * @param interfaceName interface package name
+ */
+void addInterfaceDependency(interfaceDependenciesStr& dependencies, const std::string& interfaceName);
+
+/**
+ * @brief function that writes the dependency code of the interfaces in the CMakeLists.txt and package.xml slots
+ * 
+ * The interfaces already declared by the template (e.g. std_msgs) are not written again.
+ * 
+ * @param dependencies dependencies of the skill
  * @param savedCode saved code structure containing the saved code to be written
- * @param str output string to be modified
+ * @param document document fragment to be modified
+ * @param context template context
  */
-void handleGenericEvent(const eventDataStr eventData, const savedCodeStr savedCode, std::string& str);
+void writeInterfaceDependencies(const interfaceDependenciesStr& dependencies, const savedCodeStr& savedCode, templateFragmentStr& document, const templateContextStr& context);
+
+/**
+ * @brief function to write the generic event code in the document
+ * 
+ * @param eventData event data structure containing event information
+ * @param savedCode saved code structure containing the saved code to be written
+ * @param document document fragment to be modified
+ * @param context template context
+ * @param dependencies dependencies of the skill where the interface of the event is added, written by writeInterfaceDependencies
+ */
+void handleGenericEvent(const eventDataStr& eventData, const savedCodeStr& savedCode, templateFragmentStr& document, const templateContextStr& context, interfaceDependenciesStr& dependencies);
 
 /**
  * @brief function to save specific sections of the code in the saved code structure
  * 
  * @param savedCode saved code structure passed by reference where the saved code is stored
- * @param code code string where the code is extracted and then deleted
+ * @param nodes compiled template where the sections are searched
+ * @param context template context where the saved sections are marked as snippets, so that they are not written in place
  */
-void saveCode(savedCodeStr& savedCode, std::string& code);
+void saveCode(savedCodeStr& savedCode, const std::vector<templateNodeStr>& nodes, templateContextStr& context);
 
 /**
- * @brief function to replace the event code in the code map
+ * @brief function to render the templates with the event code
  * 
- * @param codeMap code map where the code is stored
+ * @param compiledMap compiled templates, not modified
+ * @param codeMap code map where the rendered code is stored
+ * @param context template context with the skill placeholders and the sections to keep or delete
+ * @param eventsMap events of the skill
  */
-void replaceEventCode(std::map <std::string, std::string>& codeMap, fileDataStr fileData);
+void replaceEventCode(const std::map <std::string, std::vector<templateNodeStr>>& compiledMap, std::map <std::string, std::string>& codeMap, templateContextStr& context, const std::map<std::string, eventDataStr>& eventsMap);
 
 /**
  * @brief function to read the template files and store the code in the code map
  * 
- * @param templateFileData template file data structure passed by reference where the template file data is stored
- * @param codeMap code map where the code is stored
+ * The templates are read by the first call, concurrent calls wait for it. The code map and the compiled templates are
+ * only filled if all the templates are read, so a failed call leaves them empty and the next call reads them again.
+ * 
+ * @param templateFileData template file data structure passed by reference where the template file data and the compiled templates are stored
+ * @param codeMap code map where the code is stored, the templates are not read again if it is already filled
  * @return true 
  * @return false 
  */
-bool readTemplates(templateFileDataStr& templateFileData, std::map <std::string, std::string>& codeMap);
+bool readTemplates(templateFileDataStr& templateFileData, std::map <std::string, std::string_view>& codeMap);
+
+/**
+ * @brief function to get a description of where the templates are read from, for the messages
+ * 
+ * @param templateFileData template file data structure
+ * @return std::string template path or "embedded template_skill"
+ */
+std::string getTemplateSource(const templateFileDataStr& templateFileData);
 
 /**
  * @brief function to create a directory
@@ -108,7 +162,9 @@ bool createDirectory(const std::string& path);
  * 
  * @param fileData file data structure passed by reference where the file data is stored
  * @param templateFileData template file data structure passed by reference where the template file data is stored
+ * @param doc SCXML document translated in memory, if empty the SCXML is loaded from fileData.inputFileNameGeneration
+ * @param filesWritten result of the background write of the generated files
  * @return true 
  * @return false 
  */
-bool Replacer(fileDataStr& fileData, templateFileDataStr& templateFileData);
\ No newline at end of file
+bool Replacer(fileDataStr& fileData, templateFileDataStr& templateFileData, tinyxml2::XMLDocument& doc, std::future<bool>& filesWritten);
\ No newline at end of file
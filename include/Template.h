@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file Template.h
+ * @brief This file contains the functions to compile the template files and render them with the event code.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+
+#include "Data.h"
+
+/**
+ * @brief Compile a template into a tree of literals, placeholders, sections and slots
+ *
+ * @param code template code
+ * @param slotMarkers markers of the repeat slots (e.g. PARAM_LIST in its comment delimiters)
+ * @param nodes compiled template returned by reference
+ */
+void compileTemplate(std::string_view code, const std::set<std::string>& slotMarkers, std::vector<templateNodeStr>& nodes);
+
+/**
+ * @brief Find the first section with a given marker, the sections deleted by the context are skipped
+ *
+ * @param nodes compiled template
+ * @param marker section marker (e.g. PARAM in its comment delimiters)
+ * @param context template context with the sections to keep or delete
+ * @return const templateNodeStr* section found, nullptr otherwise
+ */
+const templateNodeStr* findTemplateSection(const std::vector<templateNodeStr>& nodes, const std::string& marker, const templateContextStr& context);
+
+/**
+ * @brief Create a fragment from a compiled template
+ *
+ * @param nodes compiled template
+ * @return templateFragmentStr fragment
+ */
+templateFragmentStr makeTemplateFragment(const std::vector<templateNodeStr>& nodes);
+
+/**
+ * @brief Create a fragment from a snippet section
+ *
+ * @param section snippet section, nullptr for an empty fragment
+ * @return templateFragmentStr fragment
+ */
+templateFragmentStr makeTemplateFragment(const templateNodeStr* section);
+
+/**
+ * @brief Create a fragment from plain text
+ *
+ * @param text text of the fragment
+ * @return templateFragmentStr fragment
+ */
+templateFragmentStr makeTemplateFragment(const std::string& text);
+
+/**
+ * @brief Write a fragment in all the slots with a given marker, including the slots of the fragments already written
+ *
+ * @param fragment fragment where the slots are searched
+ * @param slotMarker slot marker (e.g. SEND_EVENT_LIST in its comment delimiters)
+ * @param content fragment to be written
+ * @param context template context
+ * @return true if at least one slot was found
+ * @return false otherwise
+ */
+bool writeToSlot(templateFragmentStr& fragment, const std::string& slotMarker, const templateFragmentStr& content, const templateContextStr& context);
+
+/**
+ * @brief Check if a fragment contains a slot with a given marker
+ *
+ * @param fragment fragment where the slot is searched
+ * @param slotMarker slot marker (e.g. "#PACKAGE_LIST#")
+ * @param context template context
+ * @return true
+ * @return false
+ */
+bool hasSlot(const templateFragmentStr& fragment, const std::string& slotMarker, const templateContextStr& context);
+
+/**
+ * @brief Collect the literal text written by a fragment, without rendering it
+ *
+ * The literal nodes of the sections written by the context and of the fragments written in the slots are collected up
+ * to the truncate marker, the placeholders and the markers are skipped.
+ *
+ * @param fragment fragment whose literal text is collected
+ * @param context template context
+ * @param literals literal text returned by reference, views of the compiled templates and of the fragments
+ */
+void getTemplateLiterals(const templateFragmentStr& fragment, const templateContextStr& context, std::vector<std::string_view>& literals);
+
+/**
+ * @brief Render a fragment in a single pass
+ *
+ * @param fragment fragment to be rendered
+ * @param context template context
+ * @param withSlotMarkers write the slot markers before their content, as in the template
+ * @return std::string rendered code
+ */
+std::string renderTemplate(const templateFragmentStr& fragment, const templateContextStr& context, const bool withSlotMarkers = false);
@@ -10,6 +10,8 @@
  */
 #include "Replacer.h"
 #include <fstream>
+#include <tuple>
+#include <future>
 
 /**
  * @brief Deletes a specific attribute of a given XML element
@@ -42,6 +44,8 @@ bool readHLXMLFile(tinyxml2::XMLDocument& doc, const std::string fileName);
  * @brief translate the XML file from High-Level SCXML to SCXML
  * 
  * @param fileData file data structure passed by reference where the file data is stored
+ * @param doc XMLDocument passed by reference where the translated SCXML is kept for the code generation, cleared with fileData.stream_mode
+ * @param translatedSMWritten result of the background write of the translated SCXML file
  * @return true if the translation is successful
  */
-bool Translator(fileDataStr& fileData);
\ No newline at end of file
+bool Translator(fileDataStr& fileData, tinyxml2::XMLDocument& doc, std::future<bool>& translatedSMWritten);
\ No newline at end of file
@@ -0,0 +1,33 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file Validator.h
+ * @brief This file contains the functions to check the input SCXML of a skill before its generation.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+#pragma once
+
+#include "Data.h"
+
+/**
+ * @brief Check the input SCXML of a skill: ids, state references, ROS declarations and their events, datamodel
+ * variables and, when the specification is given, the fields of the events and their types
+ *
+ * @param fileData file data structure of the skill with the input file name and the specification files
+ * @param diagnostics problems found passed by reference, sorted by line
+ * @return true if no error is found, the warnings do not stop the generation
+ * @return false if the file can not be parsed (the error is printed) or an error is found
+ */
+bool validateSkill(const fileDataStr& fileData, std::vector<validationDiagnosticStr>& diagnostics);
+
+/**
+ * @brief Check the input SCXML of a skill and print the problems found as "file:line: error: message"
+ *
+ * @param fileData file data structure of the skill with the input file name and the specification files
+ * @return true if no error is found
+ * @return false if the file can not be parsed or an error is found
+ */
+bool validateSkill(const fileDataStr& fileData);
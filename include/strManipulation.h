@@ -13,6 +13,9 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <string_view>
+#include <vector>
+#include <utility>
 
 /**
  * @brief Convert string to snake case
@@ -57,16 +60,6 @@ void getPath(const std::string filePath, std::string& output);
  */
 bool readTemplateFile(const std::string filePath, std::string& fileContent);
 
-/**
- * @brief function to write the file
- * 
- * @param filePath constant string of the file path
- * @param fileContent constant string of the file content to be written
- * @return true 
- * @return false 
- */
-bool writeFile(const std::string filePath, const std::string fileName, const std::string fileContent);
-
 /**
  * @brief function that replaces all the occurences of a string with another string
  * 
@@ -76,6 +69,14 @@ bool writeFile(const std::string filePath, const std::string fileName, const std
  */
 void replaceAll(std::string& str, const std::string& from, const std::string& to);
 
+/**
+ * @brief function that replaces all the occurences of several strings in a single pass, the replaced text is not searched again
+ * 
+ * @param str string to be modified passed by reference
+ * @param replacements original strings and new strings, the longest original string is replaced where several match
+ */
+void replaceMany(std::string& str, const std::vector<std::pair<std::string_view, std::string_view>>& replacements);
+
 /**
  * @brief function that checks if a string is present in another string
  * 
@@ -137,3 +138,22 @@ void deleteCommand(std::string& str, const std::string& command);
  * @return std::string formatted datetime string (e.g., "2025-11-26 10:12:41 CET")
  */
 std::string getCurrentDatetime();
+
+/**
+ * @brief Get the datetime written in the generated files
+ * 
+ * SOURCE_DATE_EPOCH is used if set, otherwise in reproducible mode the Unix epoch is used. Fixed datetimes are written in UTC.
+ * 
+ * @param reproducible true to write a fixed datetime when SOURCE_DATE_EPOCH is not set
+ * @return std::string formatted datetime string (e.g., "2025-11-26 09:12:41 UTC")
+ */
+std::string getGenerationDatetime(const bool reproducible);
+
+/**
+ * @brief Check if the datetime written in the generated files is fixed (reproducible mode or SOURCE_DATE_EPOCH)
+ * 
+ * @param reproducible true in reproducible mode
+ * @return true 
+ * @return false if the current datetime is written
+ */
+bool isGenerationDatetimeFixed(const bool reproducible);
@@ -10,8 +10,12 @@
  */
 
 #include "Data.h"
+#include <atomic>
+
+// Each thread generates one skill at a time, the default context prints the messages directly
+static thread_local generationContextStr defaultGenerationContext;
+static thread_local generationContextStr* currentGenerationContext = &defaultGenerationContext;
 
-std::string log_str;
 /**
  * @brief Get component and function data from event string (Format: componentName.functionName.eventName)
  * 
@@ -22,9 +26,9 @@ void getDataFromEvent(eventDataStr& eventData)
 
     std::string firstWord, secondWord, thirdWord;
     std::string event = eventData.event;
-    std::cout << "Event: " << event << std::endl;
+    LOG_DEBUG("Event: " << event);
     if (event == ""){
-        std::cerr << "Event has no value" << std::endl;
+        error_stream() << "Event has no value" << std::endl;
         return;
     }
     size_t firstDotPos = event.find('.');
@@ -36,11 +40,11 @@ void getDataFromEvent(eventDataStr& eventData)
             thirdWord = event.substr(secondDotPos + 1);
         }
         else{
-            std::cerr << "only 2 words found, : "<< event << std::endl;
+            error_stream() << "only 2 words found, : "<< event << std::endl;
         }
     }
     else{
-        std::cerr << "Error in name format for event: "<< event << std::endl;
+        error_stream() << "Error in name format for event: "<< event << std::endl;
     }
     eventData.componentName = firstWord;
     eventData.functionName  = secondWord;
@@ -54,11 +58,11 @@ void getDataFromEvent(eventDataStr& eventData)
  * @param skillData skill data structure passed by reference where the skill data is stored
  * @return bool 
  */
-bool getDataFromRootName(const std::string attributeName, skillDataStr& skillData)
+bool getDataFromRootName(const std::string& attributeName, skillDataStr& skillData)
 {
     // e.g. attributeName = "FirstTemplateSkillAction"
     if (attributeName != ""){
-        add_to_log("Root attribute name: " + attributeName);
+        LOG_DEBUG("Root attribute name: " << attributeName);
         size_t dotPos = attributeName.find("Skill");
         if (dotPos != std::string::npos){
             skillData.SMName = attributeName; // e.g. SMName = "FirstTemplateSkillAction"
@@ -67,10 +71,10 @@ bool getDataFromRootName(const std::string attributeName, skillDataStr& skillDat
             turnToSnakeCase(skillData.className, skillData.classNameSnakeCase);
             skillData.skillType = attributeName.substr(dotPos + 5); // e.g. skillType = "Action"
             if(skillData.skillType == ""){
-                std::cerr << "Skill type not found" << std::endl;
+                error_stream() << "Skill type not found" << std::endl;
                 return false;
             }
-            std::cerr << "Skill type: " << skillData.skillType << std::endl;
+            LOG_DEBUG("Skill type: " << skillData.skillType);
             // convert skillType to lowercase
             skillData.skillTypeLC = skillData.skillType; 
             for (char &c : skillData.skillTypeLC) 
@@ -79,12 +83,12 @@ bool getDataFromRootName(const std::string attributeName, skillDataStr& skillDat
             } 
         }
         else{
-            std::cerr << "Skill name not found" << std::endl;
+            error_stream() << "Skill name not found" << std::endl;
             return false;
         }
     } 
     else{
-        std::cerr << "Attribute 'name' not found or has no value" << std::endl;
+        error_stream() << "Attribute 'name' not found or has no value" << std::endl;
         return false;
     }
     return true;
@@ -108,101 +112,104 @@ bool getDataFromRootName(const std::string attributeName, skillDataStr& skillDat
  * 
  * @param eventData event data structure to be printed
  */
-void printEventData(eventDataStr eventData)
+void printEventData(const eventDataStr& eventData)
 {
+    if (!log_enabled(logLevel::debug)) {
+        return;
+    }
 
-    add_to_log("-----------");
-    add_to_log("Event data:");
-    add_to_log("\tevent=" + eventData.event + ", target=" + eventData.target);
-    add_to_log("\teventName=" + eventData.eventName + ", eventType=" + eventData.eventType);
-    add_to_log("\tparamMap:");
+    LOG_DEBUG("-----------");
+    LOG_DEBUG("Event data:");
+    LOG_DEBUG("\tevent=" << eventData.event << ", target=" << eventData.target);
+    LOG_DEBUG("\teventName=" << eventData.eventName << ", eventType=" << eventData.eventType);
+    LOG_DEBUG("\tparamMap:");
     // print the paramMap
     for (const auto& param : eventData.paramMap) {
-        add_to_log("\t\t" + param.first + ": " + param.second);
-    }
-    add_to_log("\tcomponentName=" + eventData.componentName);
-    add_to_log("\tfunctionName=" + eventData.functionName);
-    add_to_log("\tfunctionNameSnakeCase=" + eventData.functionNameSnakeCase);
-    add_to_log("\tnodeName=" + eventData.nodeName);
-    add_to_log("\tserverName=" + eventData.serverName);
-    add_to_log("\tclientName=" + eventData.clientName);
-    add_to_log("\ttopicName=" + eventData.topicName);
-    add_to_log("\tinterfaceName=" + eventData.interfaceName);
-    add_to_log("\tinterfaceType=" + eventData.interfaceType);
-    add_to_log("\tscxmlInterfaceName=" + eventData.scxmlInterfaceName);
-    add_to_log("\tvirtualInterface=" + std::to_string(eventData.virtualInterface));
-    add_to_log("\tinterfaceTopicFields:");
+        LOG_DEBUG("\t\t" << param.first << ": " << param.second);
+    }
+    LOG_DEBUG("\tcomponentName=" << eventData.componentName);
+    LOG_DEBUG("\tfunctionName=" << eventData.functionName);
+    LOG_DEBUG("\tfunctionNameSnakeCase=" << eventData.functionNameSnakeCase);
+    LOG_DEBUG("\tnodeName=" << eventData.nodeName);
+    LOG_DEBUG("\tserverName=" << eventData.serverName);
+    LOG_DEBUG("\tclientName=" << eventData.clientName);
+    LOG_DEBUG("\ttopicName=" << eventData.topicName);
+    LOG_DEBUG("\tinterfaceName=" << eventData.interfaceName);
+    LOG_DEBUG("\tinterfaceType=" << eventData.interfaceType);
+    LOG_DEBUG("\tscxmlInterfaceName=" << eventData.scxmlInterfaceName);
+    LOG_DEBUG("\tvirtualInterface=" << eventData.virtualInterface);
+    LOG_DEBUG("\tinterfaceTopicFields:");
     // print the interface topic fields
     for (const auto& field : eventData.interfaceTopicFields) {
-        add_to_log("\t\t" + field);
+        LOG_DEBUG("\t\t" << field);
     }
-    add_to_log("\tinterfaceRequestFields:");
+    LOG_DEBUG("\tinterfaceRequestFields:");
     // print the interface request fields
     for (const auto& field : eventData.interfaceRequestFields) {
-        add_to_log("\t\t" + field);
+        LOG_DEBUG("\t\t" << field);
     }
-    add_to_log("\tinterfaceResponseFields:");
+    LOG_DEBUG("\tinterfaceResponseFields:");
     // print the interface response fields
     for (const auto& field : eventData.interfaceResponseFields) {
-        add_to_log("\t\t" + field);
+        LOG_DEBUG("\t\t" << field);
     }
-    add_to_log("\tinterfaceData:");
+    LOG_DEBUG("\tinterfaceData:");
     // print the interface data
     for (const auto& data : eventData.interfaceData) {
-        add_to_log("\t\t" + data.second + " " + data.first);
+        LOG_DEBUG("\t\t" << data.second << " " << data.first);
     }
-    add_to_log("\tMessage Interface Type: " + eventData.messageInterfaceType);
-    add_to_log("\tROS Interface Type: " + eventData.rosInterfaceType);
-    add_to_log("-----------");
+    LOG_DEBUG("\tMessage Interface Type: " << eventData.messageInterfaceType);
+    LOG_DEBUG("\tROS Interface Type: " << eventData.rosInterfaceType);
+    LOG_DEBUG("-----------");
 
 
     
 }
 
 // equal to printEventData but prints to cerr
-void printEventDataToCerr(const eventDataStr eventData)
+void printEventDataToCerr(const eventDataStr& eventData)
 {
-    std::cerr << "-----------" << std::endl;
-    std::cerr << "Event data: " << std::endl;
-    std::cerr << "\tevent=" << eventData.event << ", target=" << eventData.target << std::endl;
-    std::cerr << "\teventName=" << eventData.eventName << ", eventType=" << eventData.eventType << std::endl;   
-    std::cerr << "\tparamMap:" << std::endl;
+    error_stream() << "-----------" << std::endl;
+    error_stream() << "Event data: " << std::endl;
+    error_stream() << "\tevent=" << eventData.event << ", target=" << eventData.target << std::endl;
+    error_stream() << "\teventName=" << eventData.eventName << ", eventType=" << eventData.eventType << std::endl;   
+    error_stream() << "\tparamMap:" << std::endl;
     // print the paramMap
     for (const auto& param : eventData.paramMap) {
-        std::cerr << "\t\t" << param.first << ": " << param.second << std::endl;
-    }
-    std::cerr << "\tcomponentName=" << eventData.componentName << std::endl;
-    std::cerr << "\tfunctionName=" << eventData.functionName << std::endl;
-    std::cerr << "\tfunctionNameSnakeCase=" << eventData.functionNameSnakeCase << std::endl;
-    std::cerr << "\tnodeName=" << eventData.nodeName << std::endl;
-    std::cerr << "\tserverName=" << eventData.serverName << std::endl;
-    std::cerr << "\tclientName=" << eventData.clientName    << std::endl;   
-    std::cerr << "\ttopicName=" << eventData.topicName << std::endl;
-    std::cerr << "\tinterfaceName=" << eventData.interfaceName << std::endl;
-    std::cerr << "\tinterfaceType=" << eventData.interfaceType << std::endl;
-    std::cerr << "\tscxmlInterfaceName=" << eventData.scxmlInterfaceName << std::endl;
-    std::cerr << "\tvirtualInterface=" << std::boolalpha << eventData.virtualInterface << std::endl;
-    std::cerr << "\tinterfaceTopicFields:" << std::endl;
+        error_stream() << "\t\t" << param.first << ": " << param.second << std::endl;
+    }
+    error_stream() << "\tcomponentName=" << eventData.componentName << std::endl;
+    error_stream() << "\tfunctionName=" << eventData.functionName << std::endl;
+    error_stream() << "\tfunctionNameSnakeCase=" << eventData.functionNameSnakeCase << std::endl;
+    error_stream() << "\tnodeName=" << eventData.nodeName << std::endl;
+    error_stream() << "\tserverName=" << eventData.serverName << std::endl;
+    error_stream() << "\tclientName=" << eventData.clientName    << std::endl;   
+    error_stream() << "\ttopicName=" << eventData.topicName << std::endl;
+    error_stream() << "\tinterfaceName=" << eventData.interfaceName << std::endl;
+    error_stream() << "\tinterfaceType=" << eventData.interfaceType << std::endl;
+    error_stream() << "\tscxmlInterfaceName=" << eventData.scxmlInterfaceName << std::endl;
+    error_stream() << "\tvirtualInterface=" << std::boolalpha << eventData.virtualInterface << std::endl;
+    error_stream() << "\tinterfaceTopicFields:" << std::endl;
     // print the interface topic fields
     for (const auto& field : eventData.interfaceTopicFields) {
-        std::cerr << "\t\t" << field << std::endl;
+        error_stream() << "\t\t" << field << std::endl;
     }
-    std::cerr << "\tinterfaceRequestFields:" << std::endl;
+    error_stream() << "\tinterfaceRequestFields:" << std::endl;
     // print the interface request fields
     for (const auto& field : eventData.interfaceRequestFields) {
-        std::cerr << "\t\t" << field << std::endl;
+        error_stream() << "\t\t" << field << std::endl;
     }
-    std::cerr << "\tinterfaceResponseFields:" << std::endl;
+    error_stream() << "\tinterfaceResponseFields:" << std::endl;
     // print the interface response fields
     for (const auto& field : eventData.interfaceResponseFields) {
-        std::cerr << "\t\t" << field << std::endl;
+        error_stream() << "\t\t" << field << std::endl;
     }
-    std::cerr << "\tinterfaceData:" << std::endl;
+    error_stream() << "\tinterfaceData:" << std::endl;
     // print the interface data
     for (const auto& data : eventData.interfaceData) {
-        std::cerr << "\t\t" << data.second << " " << data.first << std::endl;
+        error_stream() << "\t\t" << data.second << " " << data.first << std::endl;
     }
-    std::cerr << "-----------" << std::endl;
+    error_stream() << "-----------" << std::endl;
 }
 
 /**
@@ -210,11 +217,11 @@ void printEventDataToCerr(const eventDataStr eventData)
  * 
  * @param skillData skill data structure to be printed
  */
-void printSkillData(skillDataStr skillData)
+void printSkillData(const skillDataStr& skillData)
 {
-    add_to_log("-----------");
-    add_to_log("Class name: " + skillData.className + "\nSkill name: " + skillData.skillName + "\nSkill type: " + skillData.skillType);
-    add_to_log("-----------");
+    LOG_DEBUG("-----------");
+    LOG_DEBUG("Class name: " << skillData.className << "\nSkill name: " << skillData.skillName << "\nSkill type: " << skillData.skillType);
+    LOG_DEBUG("-----------");
 }
 /** @} */ // end of printData subgroup
 
@@ -224,7 +231,7 @@ void printSkillData(skillDataStr skillData)
  * @param fileData file data structure passed by reference where the file data is stored
  * @param skillData const skill data structure used to set the file data
  */
-void setFileData(fileDataStr& fileData, const skillDataStr skillData)
+void setFileData(fileDataStr& fileData, const skillDataStr& skillData)
 {
     fileData.outputFileNameCPP = skillData.className + ".cpp";
     fileData.outputFileNameH = skillData.className + ".h";
@@ -236,18 +243,185 @@ void setFileData(fileDataStr& fileData, const skillDataStr skillData)
 }
 
 /**
- * @brief Add a message to the log
+ * @brief Start a phase of the generation, used by TRACE_PHASE
+ * 
+ * @param name phase name, must outlive the generation context (e.g. a string literal)
+ */
+traceScopeStr::traceScopeStr(const char* name) : name(name), enabled(get_generation_context().trace), allocations(allocationCount) {
+    if (enabled) {
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+/**
+ * @brief End a phase of the generation and record it in the generation context if it traces the phases
+ * 
+ */
+traceScopeStr::~traceScopeStr() {
+    if (enabled) {
+        // the trace thread indexes are given in order of first traced phase, so that they are small in the profiles
+        static std::atomic<unsigned int> nextTraceThread = 0;
+        static thread_local unsigned int traceThread = nextTraceThread++;
+        get_generation_context().traceEvents.push_back({name, start, std::chrono::steady_clock::now() - start, allocationCount - allocations, std::move(detail), traceThread});
+    }
+}
+
+/**
+ * @brief Write a message to the log, use the LOG_ macros instead so that disabled messages are not formatted
+ * 
+ * @param level log level
+ * @param message log message
+ */
+void write_log(const logLevel level, const std::string& message) {
+    if (level >= logConfig.level) {
+        switch (level) {
+            case logLevel::error:
+                error_stream() << "Error: " << message << std::endl;
+                break;
+            case logLevel::warning:
+                error_stream() << "Warning: " << message << std::endl;
+                break;
+            default:
+                output_stream() << message << std::endl;
+                break;
+        }
+    }
+    if (logConfig.bufferSize > 0) {
+        std::deque<std::string>& log = get_generation_context().log;
+        if (log.size() == logConfig.bufferSize) {
+            log.pop_front();
+        }
+        log.push_back(message);
+    }
+}
+
+/**
+ * @brief Get a log level from its name
  * 
- * @param fileName file name
- * @param path path passed by reference where the path is stored
+ * @param name level name (debug, info, warning, error, off)
+ * @param level log level returned by reference
+ * @return true 
+ * @return false if the name is not a log level
  */
-void add_to_log(const std::string& message) {
-    log_str += message + "\n";
+bool getLogLevel(const std::string& name, logLevel& level) {
+    static const std::map<std::string, logLevel> levels = {
+        {"debug", logLevel::debug}, {"info", logLevel::info}, {"warning", logLevel::warning}, {"error", logLevel::error}, {"off", logLevel::off}
+    };
+    auto it = levels.find(name);
+    if (it == levels.end()) {
+        return false;
+    }
+    level = it->second;
+    return true;
 }
+
 /**
- * @brief print the log
+ * @brief print the last log messages kept in the generation context, used when a skill fails
  * 
  */
 void print_log() {
-    std::cout << log_str;
+    std::deque<std::string>& log = get_generation_context().log;
+    if (log.empty()) {
+        return;
+    }
+    error_stream() << "----------- Last " << log.size() << " log messages -----------" << std::endl;
+    for (const auto& message : log) {
+        error_stream() << message << std::endl;
+    }
+    error_stream() << "-----------" << std::endl;
+}
+/**
+ * @brief clear the log messages kept in the generation context, used between the skills generated in batch mode
+ * 
+ */
+void clear_log() {
+    get_generation_context().log.clear();
+}
+
+/**
+ * @brief Set the generation context of the current thread
+ * 
+ * @param context generation context of the skill, nullptr to go back to the default context that prints the messages directly
+ */
+void set_generation_context(generationContextStr* context) {
+    currentGenerationContext = context ? context : &defaultGenerationContext;
+}
+
+/**
+ * @brief Get the generation context of the current thread
+ * 
+ * @return generationContextStr& 
+ */
+generationContextStr& get_generation_context() {
+    return *currentGenerationContext;
+}
+
+/**
+ * @brief Merge the messages, phases and counters of a finished context in the generation context of the current thread
+ * 
+ * @param finished context of a task or of a step of the generation, run with set_generation_context
+ */
+void merge_generation_context(const generationContextStr& finished) {
+    generationContextStr& context = get_generation_context();
+    for (const auto& message : finished.log) {
+        if (context.log.size() == logConfig.bufferSize) {
+            context.log.pop_front();
+        }
+        context.log.push_back(message);
+    }
+    context.traceEvents.insert(context.traceEvents.end(), finished.traceEvents.begin(), finished.traceEvents.end());
+    for (const auto& [counter, value] : finished.traceCounters) {
+        context.traceCounters[counter] += value;
+    }
+    output_stream() << finished.output.str();
+    error_stream() << finished.errors.str();
+}
+
+/**
+ * @brief Wait for the background writes of the generation context of the current thread and merge the messages of its tasks
+ * 
+ * @return true if all the writes succeeded
+ * @return false 
+ */
+bool join_generation_tasks() {
+    generationContextStr& context = get_generation_context();
+    bool written = true;
+    if (!context.writes.empty()) {
+        TRACE_PHASE("waitWrites");
+        for (const auto& write : context.writes) {
+            written = write.get() && written;
+        }
+        context.writes.clear();
+    }
+    for (const auto& task : context.tasks) {
+        merge_generation_context(*task);
+    }
+    context.tasks.clear();
+    return written;
+}
+
+/**
+ * @brief Get the standard output stream of the skill being generated by the current thread
+ * 
+ * @return std::ostream& buffered stream of the skill or std::cout
+ */
+std::ostream& output_stream() {
+    generationContextStr& context = get_generation_context();
+    if (context.buffered) {
+        return context.output;
+    }
+    return std::cout;
+}
+
+/**
+ * @brief Get the standard error stream of the skill being generated by the current thread
+ * 
+ * @return std::ostream& buffered stream of the skill or std::cerr
+ */
+std::ostream& error_stream() {
+    generationContextStr& context = get_generation_context();
+    if (context.buffered) {
+        return context.errors;
+    }
+    return std::cerr;
 }
\ No newline at end of file
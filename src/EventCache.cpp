@@ -0,0 +1,337 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file EventCache.cpp
+ * @brief This file contains the functions to keep the resolved event data of the skills on disk between the runs.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+
+#include "EventCache.h"
+#include "InputFile.h"
+#include "Manifest.h"
+#include "InterfaceRegistry.h"
+#include <filesystem>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+/**
+ * \defgroup EventCache EventCache
+ * The event data resolved from the High-Level SCXML (interface name, type and fields) is kept in one file per skill in
+ * the cache directory. The file name is the hash of the cache format, the model2code version, the path and the content
+ * of the input file and the content of the specification, so a changed input or a new model2code version never reads
+ * stale events: their files are left unused and removed by trimEventCache when the cache is over its maximum size.
+ * eventCacheFormat is increased when the serialized fields change.
+ * @{
+ */
+
+static const char* const eventCacheFormat = "1";
+
+static std::string eventCacheDirectory; // empty if the cache is disabled
+static uintmax_t eventCacheMaxSize = 0;
+
+// serialized fields of eventDataStr, in file order
+static std::string eventDataStr::* const eventStringFields[] = {
+    &eventDataStr::event, &eventDataStr::target, &eventDataStr::eventName, &eventDataStr::eventType,
+    &eventDataStr::componentName, &eventDataStr::functionName, &eventDataStr::functionNameSnakeCase,
+    &eventDataStr::nodeName, &eventDataStr::serverName, &eventDataStr::clientName, &eventDataStr::topicName,
+    &eventDataStr::interfaceName, &eventDataStr::interfaceType, &eventDataStr::messageInterfaceType,
+    &eventDataStr::serviceTypeName, &eventDataStr::serviceTypeNameSnakeCase, &eventDataStr::rosInterfaceType,
+    &eventDataStr::scxmlInterfaceName
+};
+static std::vector<std::string> eventDataStr::* const eventVectorFields[] = {
+    &eventDataStr::interfaceRequestFields, &eventDataStr::interfaceResponseFields, &eventDataStr::interfaceTopicFields
+};
+static std::map<std::string, std::string> eventDataStr::* const eventMapFields[] = {
+    &eventDataStr::paramMap, &eventDataStr::interfaceData, &eventDataStr::responseFieldToDatamodelMap
+};
+
+/**
+ * @brief Enable or disable the event cache
+ *
+ * @param directory cache directory, empty to disable the cache
+ * @param maxSize maximum size in bytes of the cache files, see trimEventCache
+ */
+void setEventCache(const std::string& directory, uintmax_t maxSize)
+{
+    eventCacheDirectory = directory.empty() ? "" : (std::filesystem::path(directory) / (std::string("events-v") + eventCacheFormat)).string();
+    eventCacheMaxSize = maxSize;
+}
+
+/**
+ * @brief Get the default cache directory: $XDG_CACHE_HOME/model2code or ~/.cache/model2code
+ *
+ * @return std::string cache directory, empty if neither XDG_CACHE_HOME nor HOME is set
+ */
+std::string getDefaultCacheDirectory()
+{
+    const char* cacheHome = std::getenv("XDG_CACHE_HOME");
+    if (cacheHome && cacheHome[0] != '\0') {
+        return (std::filesystem::path(cacheHome) / "model2code").string();
+    }
+    const char* home = std::getenv("HOME");
+    if (home && home[0] != '\0') {
+        return (std::filesystem::path(home) / ".cache" / "model2code").string();
+    }
+    return "";
+}
+
+/**
+ * @brief Write a string prefixed by its length, so that any content can be read back
+ *
+ * @param stream output stream
+ * @param value string to be written
+ */
+static void writeCacheString(std::ostream& stream, const std::string& value)
+{
+    stream << value.size() << ':' << value << '\n';
+}
+
+/**
+ * @brief Read a string written by writeCacheString
+ *
+ * @param stream input stream
+ * @param value string passed by reference where the read string is stored
+ * @return true
+ * @return false if the stream does not contain a valid string
+ */
+static bool readCacheString(std::istream& stream, std::string& value)
+{
+    size_t size;
+    if (!(stream >> size) || stream.get() != ':') {
+        return false;
+    }
+    value.resize(size);
+    return static_cast<bool>(stream.read(value.data(), size)) && stream.get() == '\n';
+}
+
+/**
+ * @brief Write a cache entry
+ *
+ * @param stream output stream
+ * @param entry entry to be written
+ */
+static void writeCacheEntry(std::ostream& stream, const eventCacheEntryStr& entry)
+{
+    const eventDataStr& eventData = entry.eventData;
+    for (const auto field : eventStringFields) {
+        writeCacheString(stream, eventData.*field);
+    }
+    stream << eventData.virtualInterface << '\n';
+    for (const auto field : eventVectorFields) {
+        stream << (eventData.*field).size() << '\n';
+        for (const auto& value : eventData.*field) {
+            writeCacheString(stream, value);
+        }
+    }
+    for (const auto field : eventMapFields) {
+        stream << (eventData.*field).size() << '\n';
+        for (const auto& [key, value] : eventData.*field) {
+            writeCacheString(stream, key);
+            writeCacheString(stream, value);
+        }
+    }
+    writeCacheString(stream, entry.errors);
+}
+
+/**
+ * @brief Read a cache entry written by writeCacheEntry
+ *
+ * @param stream input stream
+ * @param entry entry passed by reference where the read entry is stored
+ * @return true
+ * @return false if the stream does not contain a valid entry
+ */
+static bool readCacheEntry(std::istream& stream, eventCacheEntryStr& entry)
+{
+    eventDataStr& eventData = entry.eventData;
+    for (const auto field : eventStringFields) {
+        if (!readCacheString(stream, eventData.*field)) {
+            return false;
+        }
+    }
+    if (!(stream >> eventData.virtualInterface)) {
+        return false;
+    }
+    size_t count;
+    for (const auto field : eventVectorFields) {
+        if (!(stream >> count)) {
+            return false;
+        }
+        (eventData.*field).resize(count);
+        for (auto& value : eventData.*field) {
+            if (!readCacheString(stream, value)) {
+                return false;
+            }
+        }
+    }
+    for (const auto field : eventMapFields) {
+        if (!(stream >> count)) {
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            std::string key, value;
+            if (!readCacheString(stream, key) || !readCacheString(stream, value)) {
+                return false;
+            }
+            (eventData.*field)[key] = value;
+        }
+    }
+    return readCacheString(stream, entry.errors);
+}
+
+/**
+ * @brief Get the header line of the cache files, a file with a different header is not read
+ *
+ * @return std::string header line
+ */
+static std::string getCacheHeader()
+{
+    return std::string("model2code event cache ") + eventCacheFormat + " " + MODEL2CODE_VERSION;
+}
+
+/**
+ * @brief Read the cached events of a skill, the cache file is identified by the content and the path of the input file
+ *
+ * @param fileData file data structure of the skill
+ * @param cache cache of the skill passed by reference, its file path is left empty when the cache is disabled
+ * @return true if cached events were read
+ * @return false if the cache is disabled or has no valid file for the skill (no error is printed)
+ */
+bool readEventCache(const fileDataStr& fileData, eventCacheStr& cache)
+{
+    cache.filePath.clear();
+    cache.entries.clear();
+    cache.modified = false;
+    if (eventCacheDirectory.empty()) {
+        return false;
+    }
+    TRACE_PHASE("readEventCache");
+    std::shared_ptr<const mappedFileStr> inputFile = mapInputFile(fileData.inputFileName);
+    if (!inputFile) {
+        return false;
+    }
+    // the path is part of the key because it is written in the cached messages, and the warnings because they are
+    // cached only when they are shown
+    std::string key = getCacheHeader() + "\n" + fileData.inputFileName + "\n" + (log_enabled(logLevel::warning) ? "warnings" : "") + "\n" + hashContent(inputFile->view());
+    // the events without a ROS element are resolved from the specification
+    if (std::shared_ptr<const interfaceRegistryStr> registry = getInterfaceRegistry(fileData.modelFileName, fileData.interfaceFileName)) {
+        key += "\n" + registry->hash;
+    }
+    cache.filePath = (std::filesystem::path(eventCacheDirectory) / hashContent(key)).string();
+
+    std::ifstream cacheFile(cache.filePath, std::ios::binary);
+    if (!cacheFile.is_open()) {
+        LOG_DEBUG("No event cache for " << fileData.inputFileName);
+        return false;
+    }
+    std::string header;
+    size_t count;
+    if (!std::getline(cacheFile, header) || header != getCacheHeader() || !(cacheFile >> count)) {
+        LOG_DEBUG("Invalid event cache file: " << cache.filePath);
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        eventCacheEntryStr entry;
+        if (!readCacheEntry(cacheFile, entry)) {
+            LOG_DEBUG("Invalid event cache file: " << cache.filePath);
+            cache.entries.clear();
+            return false;
+        }
+        std::string event = entry.eventData.event;
+        cache.entries[event] = std::move(entry);
+    }
+    // the modification time orders the files for trimEventCache, the files read last are kept
+    std::error_code ec;
+    std::filesystem::last_write_time(cache.filePath, std::filesystem::file_time_type::clock::now(), ec);
+    LOG_DEBUG("Read " << cache.entries.size() << " cached events from " << cache.filePath);
+    return true;
+}
+
+/**
+ * @brief Write the cache file of a skill if events were added to it
+ *
+ * @param cache cache of the skill
+ * @return true
+ * @return false if the file can not be written, a warning is printed
+ */
+bool writeEventCache(eventCacheStr& cache)
+{
+    if (cache.filePath.empty() || !cache.modified) {
+        return true;
+    }
+    TRACE_PHASE("writeEventCache");
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(fs::path(cache.filePath).parent_path(), ec);
+    // the file is written to a temporary file and renamed, so that other runs never read a partial file
+#if defined(__unix__) || defined(__APPLE__)
+    std::string tempPath = cache.filePath + ".tmp" + std::to_string(getpid());
+#else
+    std::string tempPath = cache.filePath + ".tmp";
+#endif
+    std::ofstream cacheFile(tempPath, std::ios::binary);
+    if (cacheFile.is_open()) {
+        cacheFile << getCacheHeader() << '\n' << cache.entries.size() << '\n';
+        for (const auto& [event, entry] : cache.entries) {
+            writeCacheEntry(cacheFile, entry);
+        }
+        cacheFile.close();
+    }
+    if (!cacheFile || (fs::rename(tempPath, cache.filePath, ec), ec)) {
+        LOG_WARNING("Failed to write the event cache file: " << cache.filePath);
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    cache.modified = false;
+    LOG_DEBUG("Wrote " << cache.entries.size() << " cached events to " << cache.filePath);
+    return true;
+}
+
+/**
+ * @brief Remove the least recently used cache files until the cache fits in its maximum size
+ *
+ */
+void trimEventCache()
+{
+    if (eventCacheDirectory.empty()) {
+        return;
+    }
+    namespace fs = std::filesystem;
+    struct cacheFileStr{
+        fs::path path;
+        uintmax_t size;
+        fs::file_time_type lastUse;
+    };
+    std::vector<cacheFileStr> files;
+    uintmax_t totalSize = 0;
+    std::error_code ec;
+    for (fs::directory_iterator it(eventCacheDirectory, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code fileEc;
+        cacheFileStr file{it->path(), it->file_size(fileEc), it->last_write_time(fileEc)};
+        if (!fileEc) {
+            totalSize += file.size;
+            files.push_back(std::move(file));
+        }
+    }
+    if (totalSize <= eventCacheMaxSize) {
+        return;
+    }
+    std::sort(files.begin(), files.end(), [](const cacheFileStr& a, const cacheFileStr& b) { return a.lastUse < b.lastUse; });
+    for (const auto& file : files) {
+        if (totalSize <= eventCacheMaxSize) {
+            break;
+        }
+        if (fs::remove(file.path, ec)) {
+            totalSize -= file.size;
+            LOG_DEBUG("Removed event cache file: " << file.path.string());
+        }
+    }
+}
+/** @} */ // end of EventCache group
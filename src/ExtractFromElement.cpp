@@ -38,7 +38,7 @@ bool getElementAttValue(tinyxml2::XMLElement* element, const std::string attribu
         return true;
     }
     else{
-        std::cerr << "Attribute '" << attribute << "' of element '"<< element->Value()<<"' not found or has no value" << std::endl;
+        error_stream() << "Attribute '" << attribute << "' of element '"<< element->Value()<<"' not found or has no value" << std::endl;
         return false;
     }
 }
@@ -58,7 +58,7 @@ bool getElementText(tinyxml2::XMLElement* element, std::string& textValue)
         return true;
     }
     else{
-        std::cerr << "Text of element '"<< element->Value()<<"' not found or has no value" << std::endl;
+        error_stream() << "Text of element '"<< element->Value()<<"' not found or has no value" << std::endl;
         return false;
     }
 }
@@ -70,6 +70,43 @@ bool getElementText(tinyxml2::XMLElement* element, std::string& textValue)
  * @{
  */
 
+/**
+ * @brief Get the element following a given element in document order, without leaving the subtree of root
+ * 
+ * @param root root element of the subtree being visited
+ * @param element current element
+ * @return tinyxml2::XMLElement* next element, nullptr when the subtree has been fully visited
+ */
+tinyxml2::XMLElement* nextElementInTree(tinyxml2::XMLElement* root, tinyxml2::XMLElement* element)
+{
+    tinyxml2::XMLElement* child = element->FirstChildElement();
+    if (child) {
+        return child;
+    }
+    return nextElementAfterSubtree(root, element);
+}
+
+/**
+ * @brief Get the element following the subtree of a given element in document order, without leaving the subtree of root
+ * 
+ * @param root root element of the subtree being visited
+ * @param element current element, its children are skipped
+ * @return tinyxml2::XMLElement* next element, nullptr when the subtree has been fully visited
+ */
+tinyxml2::XMLElement* nextElementAfterSubtree(tinyxml2::XMLElement* root, tinyxml2::XMLElement* element)
+{
+    // go up until an element with a following sibling is found
+    while (element && element != root) {
+        tinyxml2::XMLElement* sibling = element->NextSiblingElement();
+        if (sibling) {
+            return sibling;
+        }
+        tinyxml2::XMLNode* parent = element->Parent();
+        element = parent ? parent->ToElement() : nullptr;
+    }
+    return nullptr;
+}
+
 /**
  * @brief Find a XML element by tag and attribute name and value
  * 
@@ -83,8 +120,7 @@ bool getElementText(tinyxml2::XMLElement* element, std::string& textValue)
  */
 bool findElementByTagAndAttValue(tinyxml2::XMLElement* root, const std::string tag, const std::string attributeName, const std::string attributeValue, tinyxml2::XMLElement*& element)
 {
-
-    for (tinyxml2::XMLElement* child = root->FirstChildElement(); child; child = child->NextSiblingElement()) {
+    for (tinyxml2::XMLElement* child = root->FirstChildElement(); child; child = nextElementInTree(root, child)) {
         if (strcmp(child->Value(), tag.c_str()) == 0) {
             const char* id = child->Attribute(attributeName.c_str());
             if (id && std::string(id) == attributeValue){
@@ -92,9 +128,6 @@ bool findElementByTagAndAttValue(tinyxml2::XMLElement* root, const std::string t
                 return true;
             }
         }
-        if (findElementByTagAndAttValue(child, tag, attributeName, attributeValue, element)) {
-            return true;
-        }
     }
 
     return false;
@@ -111,14 +144,11 @@ bool findElementByTagAndAttValue(tinyxml2::XMLElement* root, const std::string t
  */
 bool findElementByTag(tinyxml2::XMLElement* root, const std::string tag, tinyxml2::XMLElement*& element)
 {
-    for (tinyxml2::XMLElement* child = root->FirstChildElement(); child; child = child->NextSiblingElement()) {
+    for (tinyxml2::XMLElement* child = root->FirstChildElement(); child; child = nextElementInTree(root, child)) {
         if (strcmp(child->Value(), tag.c_str()) == 0){
             element = child;
             return true;
         }
-        if (findElementByTag(child, tag, element)) {
-            return true;
-        }
     }
 
     return false;
@@ -134,14 +164,13 @@ bool findElementByTag(tinyxml2::XMLElement* root, const std::string tag, tinyxml
  */
 void findElementVectorByTagAndAttribute(tinyxml2::XMLElement* root, const std::string tag, const std::string attribute, std::vector<tinyxml2::XMLElement*>& elementVector)
 {
-    for (tinyxml2::XMLElement* child = root->FirstChildElement(); child; child = child->NextSiblingElement()){
+    for (tinyxml2::XMLElement* child = root->FirstChildElement(); child; child = nextElementInTree(root, child)){
         if (strcmp(child->Value(), tag.c_str()) == 0) {
             const char* childAttribute = child->Attribute(attribute.c_str());
             if (childAttribute) {
                 elementVector.push_back(child);
             }
         }
-        findElementVectorByTagAndAttribute(child, tag, attribute, elementVector);
     }
 }
 
@@ -154,11 +183,265 @@ void findElementVectorByTagAndAttribute(tinyxml2::XMLElement* root, const std::s
  */
 void findElementVectorByTag(tinyxml2::XMLElement* root, const std::string tag, std::vector<tinyxml2::XMLElement*>& elementVector)
 {
-    for (tinyxml2::XMLElement* child = root->FirstChildElement(); child; child = child->NextSiblingElement()){
+    for (tinyxml2::XMLElement* child = root->FirstChildElement(); child; child = nextElementInTree(root, child)){
         if (strcmp(child->Value(), tag.c_str()) == 0) {
             elementVector.push_back(child);
         }
-        findElementVectorByTag(child, tag, elementVector);
     }
 }
-/** @} */ // end of findElements subgroup
\ No newline at end of file
+
+/**
+ * @brief Find a XML element by tag and attribute name where the attribute's value contains a specific substring
+ * 
+ * @param root root element from which to start the search
+ * @param tag tag name to look for
+ * @param attributeName attribute name to look for inside the tag
+ * @param substring substring to check for in the attribute value
+ * @param element element found returned by reference
+ * @return true if an element with the tag and attribute containing the substring is found
+ * @return false otherwise
+ */
+bool findElementByTagAndAttValueContaining(tinyxml2::XMLElement* root, const std::string& tag, const std::string& attributeName, const std::string& substring, tinyxml2::XMLElement*& element)
+{
+    for (tinyxml2::XMLElement* child = root->FirstChildElement(); child; child = nextElementInTree(root, child)) {
+        if (strcmp(child->Value(), tag.c_str()) == 0) {
+            const char* attributeValue = child->Attribute(attributeName.c_str());
+            if (attributeValue && std::string(attributeValue).find(substring) != std::string::npos) {
+                element = child;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+/** @} */ // end of findElements subgroup
+
+/**
+ * \defgroup elementIndex Element Index
+ * \ingroup ExtractFromXMLFunctions
+ * Index of the elements of a document, built once and queried without visiting the document again
+ * @{
+ */
+
+/**
+ * @brief Build the index of all the elements below root (tag -> attribute -> value -> elements) in a single traversal
+ * 
+ * @param root root element from which to start the traversal
+ * @param index element index passed by reference where the elements are stored
+ */
+void buildElementIndex(tinyxml2::XMLElement* root, elementIndexStr& index)
+{
+    TRACE_PHASE("buildElementIndex");
+    index.tagMap.clear();
+    index.documentOrder.clear();
+    size_t position = 0;
+    for (tinyxml2::XMLElement* child = root->FirstChildElement(); child; child = nextElementInTree(root, child)) {
+        tagIndexStr& tagIndex = index.tagMap[child->Value()];
+        tagIndex.elements.push_back(child);
+        index.documentOrder[child] = position++;
+        for (const tinyxml2::XMLAttribute* attribute = child->FirstAttribute(); attribute; attribute = attribute->Next()) {
+            attributeIndexStr& attributeIndex = tagIndex.attributeMap[attribute->Name()];
+            attributeIndex.elements.push_back(child);
+            attributeIndex.valueMap[attribute->Value()].push_back(child);
+            if (strcmp(attribute->Name(), "type") == 0) {
+                std::string_view type = attribute->Value();
+                tagIndex.typeNameMap[type.substr(type.find_last_of('/') + 1)].push_back(child);
+            }
+        }
+    }
+    TRACE_COUNTER("elements visited", position);
+}
+
+/**
+ * @brief Get the index of an attribute of a tag
+ * 
+ * @param index element index built with buildElementIndex
+ * @param tag tag name
+ * @param attributeName attribute name
+ * @return const attributeIndexStr* attribute index, nullptr if no element with the tag has the attribute
+ */
+static const attributeIndexStr* findAttributeIndex(const elementIndexStr& index, std::string_view tag, std::string_view attributeName)
+{
+    auto itTag = index.tagMap.find(tag);
+    if (itTag == index.tagMap.end()) {
+        return nullptr;
+    }
+    auto itAttribute = itTag->second.attributeMap.find(attributeName);
+    if (itAttribute == itTag->second.attributeMap.end()) {
+        return nullptr;
+    }
+    return &itAttribute->second;
+}
+
+/**
+ * @brief Find a XML element by tag and attribute name and value using the element index
+ * 
+ * @param index element index built with buildElementIndex
+ * @param tag tag name to look for
+ * @param attributeName attribute name to look for inside the tag
+ * @param attributeValue attribute value associated with the attribute name to look for
+ * @param element first element found in document order returned by reference
+ * @return true 
+ * @return false 
+ */
+bool findElementByTagAndAttValue(const elementIndexStr& index, std::string_view tag, std::string_view attributeName, std::string_view attributeValue, tinyxml2::XMLElement*& element)
+{
+    const attributeIndexStr* attributeIndex = findAttributeIndex(index, tag, attributeName);
+    if (!attributeIndex) {
+        return false;
+    }
+    auto itValue = attributeIndex->valueMap.find(attributeValue);
+    if (itValue == attributeIndex->valueMap.end()) {
+        return false;
+    }
+    element = itValue->second.front();
+    return true;
+}
+
+/**
+ * @brief Find a XML element by tag using the element index
+ * 
+ * @param index element index built with buildElementIndex
+ * @param tag tag name to look for
+ * @param element first element found in document order returned by reference
+ * @return true 
+ * @return false 
+ */
+bool findElementByTag(const elementIndexStr& index, std::string_view tag, tinyxml2::XMLElement*& element)
+{
+    auto itTag = index.tagMap.find(tag);
+    if (itTag == index.tagMap.end()) {
+        return false;
+    }
+    element = itTag->second.elements.front();
+    return true;
+}
+
+/**
+ * @brief Find a vector of XML elements by tag and attribute name using the element index
+ * 
+ * @param index element index built with buildElementIndex
+ * @param tag tag name to look for
+ * @param attribute attribute name to look for inside the tag
+ * @param elementVector element vector where the elements found are appended in document order
+ */
+void findElementVectorByTagAndAttribute(const elementIndexStr& index, std::string_view tag, std::string_view attribute, std::vector<tinyxml2::XMLElement*>& elementVector)
+{
+    const attributeIndexStr* attributeIndex = findAttributeIndex(index, tag, attribute);
+    if (attributeIndex) {
+        elementVector.insert(elementVector.end(), attributeIndex->elements.begin(), attributeIndex->elements.end());
+    }
+}
+
+/**
+ * @brief Find a vector of XML elements by tag using the element index
+ * 
+ * @param index element index built with buildElementIndex
+ * @param tag tag name to look for
+ * @param elementVector element vector where the elements found are appended in document order
+ */
+void findElementVectorByTag(const elementIndexStr& index, std::string_view tag, std::vector<tinyxml2::XMLElement*>& elementVector)
+{
+    auto itTag = index.tagMap.find(tag);
+    if (itTag != index.tagMap.end()) {
+        elementVector.insert(elementVector.end(), itTag->second.elements.begin(), itTag->second.elements.end());
+    }
+}
+
+/**
+ * @brief Find a XML element by tag and attribute name where the attribute's value contains a specific substring using the element index
+ * 
+ * The substring is searched in each distinct value of the attribute, so a query is linear in the number of values;
+ * findElementByTagAndTypeSuffix looks up the type attributes in the index instead.
+ * 
+ * @param index element index built with buildElementIndex
+ * @param tag tag name to look for
+ * @param attributeName attribute name to look for inside the tag
+ * @param substring substring to check for in the attribute value
+ * @param element first element found in document order returned by reference
+ * @return true if an element with the tag and attribute containing the substring is found
+ * @return false otherwise
+ */
+bool findElementByTagAndAttValueContaining(const elementIndexStr& index, std::string_view tag, std::string_view attributeName, std::string_view substring, tinyxml2::XMLElement*& element)
+{
+    const attributeIndexStr* attributeIndex = findAttributeIndex(index, tag, attributeName);
+    if (!attributeIndex) {
+        return false;
+    }
+    // only the distinct values are checked, the first element in document order wins
+    tinyxml2::XMLElement* found = nullptr;
+    size_t foundPosition = 0;
+    for (const auto& value : attributeIndex->valueMap) {
+        if (value.first.find(substring) == std::string_view::npos) {
+            continue;
+        }
+        size_t position = index.documentOrder.at(value.second.front());
+        if (!found || position < foundPosition) {
+            found = value.second.front();
+            foundPosition = position;
+        }
+    }
+    if (!found) {
+        return false;
+    }
+    element = found;
+    return true;
+}
+
+/**
+ * @brief Find a XML element by tag whose type attribute ends with a given suffix using the element index
+ * 
+ * The elements are looked up by the last part of their type (e.g. "HaltAction"), then their whole type is compared.
+ * 
+ * @param index element index built with buildElementIndex
+ * @param tag tag name to look for
+ * @param typeSuffix end of the type attribute (e.g. "bt_interfaces/HaltAction")
+ * @param element first element found in document order returned by reference
+ * @return true if an element with the tag and a type ending with the suffix is found
+ * @return false otherwise
+ */
+bool findElementByTagAndTypeSuffix(const elementIndexStr& index, std::string_view tag, std::string_view typeSuffix, tinyxml2::XMLElement*& element)
+{
+    auto itTag = index.tagMap.find(tag);
+    if (itTag == index.tagMap.end()) {
+        return false;
+    }
+    auto itTypeName = itTag->second.typeNameMap.find(typeSuffix.substr(typeSuffix.find_last_of('/') + 1));
+    if (itTypeName == itTag->second.typeNameMap.end()) {
+        return false;
+    }
+    for (tinyxml2::XMLElement* candidate : itTypeName->second) {
+        std::string_view type = candidate->Attribute("type");
+        if (type.size() >= typeSuffix.size() && type.compare(type.size() - typeSuffix.size(), typeSuffix.size(), typeSuffix) == 0) {
+            element = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Find a vector of XML elements by tag and attribute name where the attribute's value starts with a specific prefix using the element index
+ * 
+ * @param index element index built with buildElementIndex
+ * @param tag tag name to look for
+ * @param attributeName attribute name to look for inside the tag
+ * @param prefix prefix of the attribute value
+ * @param elementVector element vector where the elements found are appended in document order
+ */
+void findElementVectorByTagAndAttValuePrefix(const elementIndexStr& index, std::string_view tag, std::string_view attributeName, std::string_view prefix, std::vector<tinyxml2::XMLElement*>& elementVector)
+{
+    const attributeIndexStr* attributeIndex = findAttributeIndex(index, tag, attributeName);
+    if (!attributeIndex) {
+        return;
+    }
+    std::vector<tinyxml2::XMLElement*> found;
+    for (auto it = attributeIndex->valueMap.lower_bound(prefix); it != attributeIndex->valueMap.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+        found.insert(found.end(), it->second.begin(), it->second.end());
+    }
+    std::sort(found.begin(), found.end(), [&index](const tinyxml2::XMLElement* a, const tinyxml2::XMLElement* b) {
+        return index.documentOrder.at(a) < index.documentOrder.at(b);
+    });
+    elementVector.insert(elementVector.end(), found.begin(), found.end());
+}
+/** @} */ // end of elementIndex subgroup
@@ -21,39 +21,91 @@
 
 
 
-bool extractInterfaceData(const fileDataStr fileData, eventDataStr& eventData)
+/**
+ * @brief Load the High-Level SCXML file once and build the tables shared by all the events
+ * 
+ * @param fileName file name of the High-Level SCXML file
+ * @param hlModel model structure passed by reference where the document, the root, the datamodel types and the element index are stored
+ * @return true 
+ * @return false 
+ */
+bool loadHLModel(const std::string& fileName, hlModelDataStr& hlModel)
+{
+    TRACE_PHASE_DETAIL("loadHLModel", fileName);
+    hlModel.fileName = fileName;
+    hlModel.root = nullptr;
+    hlModel.datamodelTypes.clear();
+
+    LOG_DEBUG("opening file: " << fileName << " at line " << __LINE__);
+    if (!parseInputFile(hlModel.doc, fileName)) {
+        return false;
+    }
+
+    hlModel.root = hlModel.doc.RootElement();
+    if (!hlModel.root) {
+        LOG_ERROR("No root element found in file: " << fileName);
+        return false;
+    }
+
+    // Parse datamodel to get variable types directly
+    tinyxml2::XMLElement* datamodel = hlModel.root->FirstChildElement("datamodel");
+    if (datamodel) {
+        tinyxml2::XMLElement* dataElement = datamodel->FirstChildElement("data");
+        while (dataElement) {
+            const char* id = dataElement->Attribute("id");
+            const char* type = dataElement->Attribute("type");
+            
+            if (id && type) {
+                hlModel.datamodelTypes[id] = type;
+                LOG_DEBUG("Found datamodel variable: " << id << " -> " << type << " at line " << __LINE__);
+            }
+            dataElement = dataElement->NextSiblingElement("data");
+        }
+    }
+
+    buildElementIndex(hlModel.root, hlModel.elementIndex);
+    return true;
+}
+
+bool extractInterfaceData(const fileDataStr& fileData, hlModelDataStr& hlModel, eventDataStr& eventData)
 {
     std::string interfaceName;
     std::string fileName = fileData.modelFileName;
 
     // open the model file
     // and check if it exists
-    // add_to_log("opening file: " + fileName + " at line " + std::to_string(__LINE__));
+    // LOG_DEBUG("opening file: " << fileName << " at line " << __LINE__);
     // if (doc.LoadFile(fileName.c_str()) != tinyxml2::XML_SUCCESS) {
-    //     std::cerr << "Failed to load '" << fileName << "' file" << std::endl;
+    //     error_stream() << "Failed to load '" << fileName << "' file" << std::endl;
     //     return false;
     // }
-    // add_to_log("******************************** event DATA ********************************\n");
+    // LOG_DEBUG("******************************** event DATA ********************************\n");
     // printEventData(eventData);
-    // add_to_log("******************************** event DATA END ********************************\n");
+    // LOG_DEBUG("******************************** event DATA END ********************************\n");
 
     // open the input file and check if it exists
 
-    tinyxml2::XMLElement* element;
-    findInterfaceType(fileData, eventData, element);
+    tinyxml2::XMLElement* element = nullptr;
+    if (!findInterfaceType(fileData, hlModel, eventData, element) && eventData.interfaceType.empty()) {
+        // the events without a ROS element in the High-Level SCXML are looked up in the specification, if given
+        std::shared_ptr<const interfaceRegistryStr> registry = getInterfaceRegistry(fileData.modelFileName, fileData.interfaceFileName);
+        if (registry) {
+            getInterfaceFromRegistry(*registry, eventData);
+        }
+    }
     
     // Only populate interfaceData if we have interface fields that need type information
     if (!eventData.interfaceRequestFields.empty() || !eventData.interfaceResponseFields.empty() || !eventData.interfaceTopicFields.empty()) {
-        parseInterfaceTypesFromSCXML(fileData, eventData);
+        parseInterfaceTypesFromSCXML(hlModel, eventData);
     }
     
-    add_to_log("******************************** event DATA AFTER ********************************\n");
+    LOG_DEBUG("******************************** event DATA AFTER ********************************\n");
     printEventData(eventData);
-    add_to_log("******************************** event DATA AFTER END ********************************\n");
+    LOG_DEBUG("******************************** event DATA AFTER END ********************************\n");
 
     // find the interface name in the high level tag
     // if (!is_ros_service_server) {
-    //     std::cerr << "No rosServiceServer found for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'."<< std::endl;
+    //     error_stream() << "No rosServiceServer found for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'."<< std::endl;
     //     return false;
     // }
     return true;
@@ -61,35 +113,28 @@ bool extractInterfaceData(const fileDataStr fileData, eventDataStr& eventData)
 }
 
 
-bool findInterfaceType(const fileDataStr fileData, eventDataStr& eventData, tinyxml2::XMLElement*& element) 
+bool findInterfaceType(const fileDataStr& fileData, hlModelDataStr& hlModel, eventDataStr& eventData, tinyxml2::XMLElement*& element) 
 {
-    tinyxml2::XMLDocument doc;
-
-    add_to_log("opening file: " + fileData.inputFileName + " at line" + std::to_string(__LINE__));
-    if (doc.LoadFile(fileData.inputFileName.c_str()) != tinyxml2::XML_SUCCESS) {
-        std::cerr << "Failed to load '" << fileData.inputFileName << "' file" << std::endl;
-        return false;
-    }
-
-    tinyxml2::XMLElement* root = doc.RootElement();
+    TRACE_PHASE_DETAIL("findInterfaceType", eventData.event);
+    tinyxml2::XMLElement* root = hlModel.root;
     if (!root) {
-        std::cerr << "No root element found in file: " << fileData.inputFileName << std::endl;
+        LOG_ERROR("No root element found in file: " << fileData.inputFileName);
         return false;
     }
-    std::cout << std::string("/" + eventData.componentName + "/" + eventData.functionName) << std::endl;
+    LOG_DEBUG("/" << eventData.componentName << "/" << eventData.functionName);
 
     // ROS SERVICE SERVER
-    bool is_ros_service_server = findElementByTagAndAttValue(root, std::string("ros_service_server"), std::string("service_name"), std::string("/" + eventData.componentName + "/" + eventData.functionName), element);
-    add_to_log("is_ros_service_server: " + std::to_string(is_ros_service_server) + " at line " + std::to_string(__LINE__));
+    bool is_ros_service_server = findElementByTagAndAttValue(hlModel.elementIndex, "ros_service_server", "service_name", "/" + eventData.componentName + "/" + eventData.functionName, element);
+    LOG_DEBUG("is_ros_service_server: " << is_ros_service_server << " at line " << __LINE__);
     if (is_ros_service_server) {
         if (!getElementAttValue(element, std::string("type"), eventData.messageInterfaceType))
         {
-            std::cerr << "No type attribute found in ros_service_server element for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'."<< std::endl;
+            LOG_ERROR("No type attribute found in ros_service_server element for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'.");
             return false;
         }
         
         eventData.interfaceName = eventData.messageInterfaceType.substr(0, eventData.messageInterfaceType.find_last_of("/"));
-        add_to_log("interfaceName: " + eventData.interfaceName + " at line " + std::to_string(__LINE__));
+        LOG_DEBUG("interfaceName: " << eventData.interfaceName << " at line " << __LINE__);
         eventData.interfaceType = "async-service";
         eventData.rosInterfaceType = "service-server"; // type of the interface in ROS
         // eventData.serverName = "/" + eventData.componentName + "/" + eventData.functionName;
@@ -97,30 +142,30 @@ bool findInterfaceType(const fileDataStr fileData, eventDataStr& eventData, tiny
 
 
         // handle request fields
-        tinyxml2::XMLElement* fieldParent;
-        findElementByTagAndAttValue(root, std::string("ros_service_handle_request"), std::string("name"), std::string(eventData.serverName), fieldParent);
+        tinyxml2::XMLElement* fieldParent = nullptr;
+        findElementByTagAndAttValue(hlModel.elementIndex, "ros_service_handle_request", "name", eventData.serverName, fieldParent);
         if (!fieldParent) {
-            std::cerr << "No ros_service_handle_request element found for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'."<< std::endl;
+            LOG_WARNING("No ros_service_handle_request element found for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'.");
             // return false;
         }
         if (!getInterfaceFieldsFromAssignTag(fieldParent, eventData.interfaceRequestFields)) {
-            std::cerr << "Failed to get interface ros_service_handle_request fields for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'."<< std::endl;
+            LOG_WARNING("Failed to get interface ros_service_handle_request fields for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'.");
             // return false;
         }
 
 
         // handle response fields
-        tinyxml2::XMLElement* responseParent;
-        findElementByTagAndAttValue(root, std::string("ros_service_send_response"), std::string("name"), std::string(eventData.clientName), responseParent);
+        tinyxml2::XMLElement* responseParent = nullptr;
+        findElementByTagAndAttValue(hlModel.elementIndex, "ros_service_send_response", "name", eventData.clientName, responseParent);
         if (!responseParent) {
-            std::cerr << "No ros_service_send_response element found for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'."<< std::endl;
+            LOG_WARNING("No ros_service_send_response element found for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'.");
             // return false;
         }  
         if (!getInterfaceFieldsFromFieldTag(responseParent, eventData.interfaceResponseFields)) {
-            std::cerr << "Failed to get interface ros_service_send_response fields for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'."<< std::endl;
+            LOG_WARNING("Failed to get interface ros_service_send_response fields for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'.");
             // return false;
         }
-        add_to_log("fieldParent: " + std::string(fieldParent->Name()) + " at line " + std::to_string(__LINE__));
+        LOG_DEBUG("fieldParent: " << fieldParent->Name() << " at line " << __LINE__);
         return true;
     } 
 
@@ -141,61 +186,63 @@ bool findInterfaceType(const fileDataStr fileData, eventDataStr& eventData, tiny
         pos += 1; // Move past the replaced character
     }
     eventData.functionName = functionName;
+    // name of the services, topics and actions of the event in the High-Level SCXML
+    const std::string interfacePath = "/" + eventData.componentName + "/" + eventData.functionName;
     // ROS SERVICE CLIENT
     
-    bool is_ros_service_client = findElementByTagAndAttValue(root, std::string("ros_service_client"), std::string("service_name"), std::string("/" + eventData.componentName + "/" + eventData.functionName), element);
-    add_to_log("is_ros_service_client: " + std::to_string(is_ros_service_client) + " at line " + std::to_string(__LINE__));
+    bool is_ros_service_client = findElementByTagAndAttValue(hlModel.elementIndex, "ros_service_client", "service_name", interfacePath, element);
+    LOG_DEBUG("is_ros_service_client: " << is_ros_service_client << " at line " << __LINE__);
     if (is_ros_service_client) {
         if (!getElementAttValue(element, std::string("type"), eventData.messageInterfaceType))
         {
-            std::cerr << "No type attribute found in ros_service_client element for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'."<< std::endl;
+            LOG_ERROR("No type attribute found in ros_service_client element for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'.");
             return false;
         }
         eventData.rosInterfaceType = "service-client"; // type of the interface in ROS
         eventData.interfaceName = eventData.messageInterfaceType.substr(0, eventData.messageInterfaceType.find_last_of("/"));
-        add_to_log("interfaceName: " + eventData.interfaceName + " at line " + std::to_string(__LINE__));
+        LOG_DEBUG("interfaceName: " << eventData.interfaceName << " at line " << __LINE__);
         
         // Extract the service type name from messageInterfaceType for correct template generation
         size_t lastSlash = eventData.messageInterfaceType.find_last_of("/");
         if (lastSlash != std::string::npos) {
             eventData.serviceTypeName = eventData.messageInterfaceType.substr(lastSlash + 1);
             turnToSnakeCase(eventData.serviceTypeName, eventData.serviceTypeNameSnakeCase);
-            add_to_log("serviceTypeName: " + eventData.serviceTypeName + " (snake_case: " + eventData.serviceTypeNameSnakeCase + ") at line " + std::to_string(__LINE__));
+            LOG_DEBUG("serviceTypeName: " << eventData.serviceTypeName << " (snake_case: " << eventData.serviceTypeNameSnakeCase << ") at line " << __LINE__);
         }
         
         eventData.interfaceType = "async-service";
         // eventData.clientName = "/" + eventData.componentName + "/" + eventData.functionName;
         // eventData.serverName = "/" + eventData.componentName + "/" + eventData.functionName;        // handle request fields
-        tinyxml2::XMLElement* fieldParent;
-        if (!findElementByTagAndAttValue(root, std::string("ros_service_send_request"), std::string("name"), std::string("/" + eventData.componentName + "/" + eventData.functionName), fieldParent)) 
+        tinyxml2::XMLElement* fieldParent = nullptr;
+        if (!findElementByTagAndAttValue(hlModel.elementIndex, "ros_service_send_request", "name", interfacePath, fieldParent)) 
         {
-            std::cerr << "No ros_service_send_request element found for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'."<< std::endl;
+            LOG_WARNING("No ros_service_send_request element found for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'.");
             // return false;
         }
         if (fieldParent) {
-            add_to_log("fieldParent: " + std::string(fieldParent->Name()) + " at line " + std::to_string(__LINE__));
+            LOG_DEBUG("fieldParent: " << fieldParent->Name() << " at line " << __LINE__);
         }
         if (!getInterfaceFieldsFromFieldTag(fieldParent, eventData.interfaceRequestFields))
         {
-            std::cerr << "Failed to get interface ros_service_send_request fields for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'."<< std::endl;
+            LOG_WARNING("Failed to get interface ros_service_send_request fields for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'.");
             // return false;
         }
 
 
         // handle response fields
-        tinyxml2::XMLElement* responseParent;
-        if (!findElementByTagAndAttValue(root, std::string("ros_service_handle_response"), std::string("name"), std::string("/" + eventData.componentName + "/" + eventData.functionName), responseParent)) 
+        tinyxml2::XMLElement* responseParent = nullptr;
+        if (!findElementByTagAndAttValue(hlModel.elementIndex, "ros_service_handle_response", "name", interfacePath, responseParent)) 
         {
-            std::cerr << "No ros_service_handle_response element found for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'."<< std::endl;
+            LOG_WARNING("No ros_service_handle_response element found for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'.");
             // return false;
         }
         if(responseParent) 
         {
-            add_to_log("responseParent: " + std::string(responseParent->Name()) + " at line " + std::to_string(__LINE__));
+            LOG_DEBUG("responseParent: " << responseParent->Name() << " at line " << __LINE__);
         }
         if (!getInterfaceFieldsFromAssignTag(responseParent, eventData.interfaceResponseFields, eventData.responseFieldToDatamodelMap))
         {
-            std::cerr << "Failed to get interface ros_service_handle_response fields for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'."<< std::endl;
+            LOG_WARNING("Failed to get interface ros_service_handle_response fields for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'.");
             // return false;
         }
 
@@ -205,37 +252,37 @@ bool findInterfaceType(const fileDataStr fileData, eventDataStr& eventData, tiny
 
 
     // ROS TOPIC PUBLISHER
-    bool is_topic_publisher = findElementByTagAndAttValue(root, std::string("ros_topic_publisher"), std::string("topic"), std::string("/" + eventData.componentName + "/" + eventData.functionName), element);
-    add_to_log("is_topic_publisher: " + std::to_string(is_topic_publisher) + " at line " + std::to_string(__LINE__));
+    bool is_topic_publisher = findElementByTagAndAttValue(hlModel.elementIndex, "ros_topic_publisher", "topic", interfacePath, element);
+    LOG_DEBUG("is_topic_publisher: " << is_topic_publisher << " at line " << __LINE__);
     if (is_topic_publisher) {
 
         if (!getElementAttValue(element, std::string("type"), eventData.messageInterfaceType))
         {
-            std::cerr << "No type attribute found in ros_topic_publisher element for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'."<< std::endl;
+            LOG_ERROR("No type attribute found in ros_topic_publisher element for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'.");
             return false;
         }
         
         eventData.interfaceName = eventData.messageInterfaceType.substr(0, eventData.messageInterfaceType.find_last_of("/"));
 
-        add_to_log("interfaceName: " + eventData.interfaceName + " at line " + std::to_string(__LINE__));
+        LOG_DEBUG("interfaceName: " << eventData.interfaceName << " at line " << __LINE__);
         
         eventData.interfaceType = "topic";
         eventData.rosInterfaceType = "topic-publisher"; // type of the interface in ROS
         getElementAttValue(element, std::string("name"), eventData.scxmlInterfaceName);
         getElementAttValue(element, std::string("topic"), eventData.topicName);
-        tinyxml2::XMLElement* fieldParent;
+        tinyxml2::XMLElement* fieldParent = nullptr;
 
         //get the fields from the ros_topic_publish element
-        findElementByTagAndAttValue(root, std::string("ros_topic_publish"), std::string("name"), std::string(eventData.scxmlInterfaceName), fieldParent);
+        findElementByTagAndAttValue(hlModel.elementIndex, "ros_topic_publish", "name", eventData.scxmlInterfaceName, fieldParent);
         if (!fieldParent) {
-            std::cerr << "No ros_topic_publish element found for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'."<< std::endl;
+            LOG_WARNING("No ros_topic_publish element found for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'.");
             return false;
         }
         eventData.interfaceName = eventData.messageInterfaceType.substr(0, eventData.messageInterfaceType.find_last_of("/"));
-        add_to_log("interfaceName: " + eventData.interfaceName + " at line " + std::to_string(__LINE__));
+        LOG_DEBUG("interfaceName: " << eventData.interfaceName << " at line " << __LINE__);
 
         if (!getInterfaceFieldsFromFieldTag(fieldParent, eventData.interfaceTopicFields)) {
-            std::cerr << "Failed to get interface topic fields for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'."<< std::endl;
+            LOG_WARNING("Failed to get interface topic fields for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'.");
             return false;
         }
         return true;
@@ -247,7 +294,7 @@ bool findInterfaceType(const fileDataStr fileData, eventDataStr& eventData, tiny
     // For topic subscribers, we need to reconstruct the full topic name from the event
     // Event format: componentName.functionName.topicPart.Sub
     // We need to extract the topicPart and reconstruct: /componentName/functionName/topicPart
-    std::string fullTopicName = "/" + eventData.componentName + "/" + eventData.functionName;
+    std::string fullTopicName = interfacePath;
     if (eventData.eventName.find(".Sub") != std::string::npos) {
         std::string topicPart = eventData.eventName.substr(0, eventData.eventName.find(".Sub"));
         if (!topicPart.empty()) {
@@ -255,15 +302,15 @@ bool findInterfaceType(const fileDataStr fileData, eventDataStr& eventData, tiny
         }
     }
     
-    bool is_topic_subscriber = findElementByTagAndAttValue(root, std::string("ros_topic_subscriber"), std::string("topic"), fullTopicName, element);
-    add_to_log("is_topic_subscriber: " + std::to_string(is_topic_subscriber) + " for topic: " + fullTopicName + " at line " + std::to_string(__LINE__));
+    bool is_topic_subscriber = findElementByTagAndAttValue(hlModel.elementIndex, "ros_topic_subscriber", "topic", fullTopicName, element);
+    LOG_DEBUG("is_topic_subscriber: " << is_topic_subscriber << " for topic: " << fullTopicName << " at line " << __LINE__);
     if (is_topic_subscriber) {
         eventData.interfaceType = "topic";
         eventData.rosInterfaceType = "topic-subscriber"; // type of the interface in ROS
         getElementAttValue(element, std::string("type"), eventData.messageInterfaceType);
         getElementAttValue(element, std::string("topic"), eventData.topicName);
         getElementAttValue(element, std::string("name"), eventData.scxmlInterfaceName);
-        tinyxml2::XMLElement* fieldParent;
+        tinyxml2::XMLElement* fieldParent = nullptr;
 
         // For topic subscribers, derive a better function name from the topic name
         // Extract the last part of the topic path as the function identifier
@@ -285,15 +332,15 @@ bool findInterfaceType(const fileDataStr fileData, eventDataStr& eventData, tiny
         }
 
         eventData.interfaceName = eventData.messageInterfaceType.substr(0, eventData.messageInterfaceType.find_last_of("/"));
-        add_to_log("interfaceName: " + eventData.interfaceName + " at line " + std::to_string(__LINE__));
+        LOG_DEBUG("interfaceName: " << eventData.interfaceName << " at line " << __LINE__);
 
         //get the fields from the ros_topic_subscribe element
-        if (!findElementByTagAndAttValue(root, std::string("ros_topic_callback"), std::string("name"), std::string(eventData.topicName), fieldParent)){
-            std::cerr << "No ros_topic_callback element found for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'."<< std::endl;
+        if (!findElementByTagAndAttValue(hlModel.elementIndex, "ros_topic_callback", "name", eventData.topicName, fieldParent)){
+            LOG_WARNING("No ros_topic_callback element found for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'.");
             return false;
         }
         if(!getInterfaceFieldsFromAssignTag(fieldParent, eventData.interfaceTopicFields)) {
-            std::cerr << "Failed to get interface topic fields for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'."<< std::endl;
+            LOG_WARNING("Failed to get interface topic fields for component '" << eventData.componentName << "' and function '" << eventData.functionName << "' in file '" << fileData.inputFileName << "'.");
             return false;
         }
 
@@ -304,14 +351,14 @@ bool findInterfaceType(const fileDataStr fileData, eventDataStr& eventData, tiny
 
 
 
-    bool is_action_server = findElementByTagAndAttValue(root, std::string("ros_action_server"), std::string("action_name"), std::string("/" + eventData.componentName + "/" + eventData.functionName), element);
-    add_to_log("is_action_server: " + std::to_string(is_action_server) + " at line " + std::to_string(__LINE__));
+    bool is_action_server = findElementByTagAndAttValue(hlModel.elementIndex, "ros_action_server", "action_name", interfacePath, element);
+    LOG_DEBUG("is_action_server: " << is_action_server << " at line " << __LINE__);
     if (is_action_server) {
         getElementAttValue(element, std::string("type"), eventData.messageInterfaceType);
         eventData.rosInterfaceType = "action-server"; // type of the interface in ROS
         eventData.interfaceName = eventData.messageInterfaceType.substr(0, eventData.messageInterfaceType.find_last_of("/"));
         
-        add_to_log("interfaceName: " + eventData.interfaceName + " at line " + std::to_string(__LINE__));
+        LOG_DEBUG("interfaceName: " << eventData.interfaceName << " at line " << __LINE__);
         eventData.interfaceType = "action";
         // eventData.serverName = "/" + eventData.componentName + "/" + eventData.functionName;
         return true;
@@ -320,15 +367,15 @@ bool findInterfaceType(const fileDataStr fileData, eventDataStr& eventData, tiny
 
 
 
-    bool is_action_client = findElementByTagAndAttValue(root, std::string("ros_action_client"), std::string("action_name"), std::string("/" + eventData.componentName + "/" + eventData.functionName), element);
-    add_to_log("is_action_client: " + std::to_string(is_action_client) + " at line " + std::to_string(__LINE__));
+    bool is_action_client = findElementByTagAndAttValue(hlModel.elementIndex, "ros_action_client", "action_name", interfacePath, element);
+    LOG_DEBUG("is_action_client: " << is_action_client << " at line " << __LINE__);
     if (is_action_client) {
         getElementAttValue(element, std::string("type"), eventData.messageInterfaceType);
         eventData.rosInterfaceType = "action-client"; // type of the interface in ROS
         eventData.interfaceName = eventData.messageInterfaceType.substr(0, eventData.messageInterfaceType.find_last_of("/"));
-        add_to_log("interfaceName: " + eventData.interfaceName + " at line " + std::to_string(__LINE__));
+        LOG_DEBUG("interfaceName: " << eventData.interfaceName << " at line " << __LINE__);
         eventData.interfaceType = "action";
-        eventData.clientName = "/" + eventData.componentName + "/" + eventData.functionName;
+        eventData.clientName = interfacePath;
         return true;
     }
 
@@ -339,20 +386,20 @@ bool findInterfaceType(const fileDataStr fileData, eventDataStr& eventData, tiny
 bool getInterfaceFieldsFromAssignTag(tinyxml2::XMLElement* element, std::vector<std::string>& interfaceFields)
 {
     if (!element) {
-        std::cerr << "Element is null" << std::endl;
+        LOG_WARNING("Element is null");
         return false;
     }
     
     tinyxml2::XMLElement* fieldElement = element->FirstChildElement("assign");
     if (!fieldElement) {
-        std::cerr << "No assign element found in the provided element" << std::endl;
+        LOG_WARNING("No assign element found in the provided element");
         return false;
     }
     while (fieldElement) {
         const char* fieldName = fieldElement->Attribute("expr");
-        add_to_log("fieldName: " + std::string(fieldName) + " at line " + std::to_string(__LINE__));
+        LOG_DEBUG("fieldName: " << (fieldName ? fieldName : "null") << " at line " << __LINE__);
         if (fieldName) {
-            std::cerr << "Found field: " << fieldName << std::endl;
+            LOG_DEBUG("Found field: " << fieldName);
             // find . in the string
             std::string fieldNameStr(fieldName);
             size_t dotPos = fieldNameStr.find('.');
@@ -370,22 +417,22 @@ bool getInterfaceFieldsFromAssignTag(tinyxml2::XMLElement* element, std::vector<
 bool getInterfaceFieldsFromAssignTag(tinyxml2::XMLElement* element, std::vector<std::string>& interfaceFields, std::map<std::string, std::string>& responseFieldToDatamodelMap)
 {
     if (!element) {
-        std::cerr << "Element is null" << std::endl;
+        LOG_WARNING("Element is null");
         return false;
     }
     
     tinyxml2::XMLElement* fieldElement = element->FirstChildElement("assign");
     if (!fieldElement) {
-        std::cerr << "No assign element found in the provided element" << std::endl;
+        LOG_WARNING("No assign element found in the provided element");
         return false;
     }
     while (fieldElement) {
         const char* expr = fieldElement->Attribute("expr");
         const char* location = fieldElement->Attribute("location");
-        add_to_log("expr: " + std::string(expr ? expr : "null") + ", location: " + std::string(location ? location : "null") + " at line " + std::to_string(__LINE__));
+        LOG_DEBUG("expr: " << (expr ? expr : "null") << ", location: " << (location ? location : "null") << " at line " << __LINE__);
         
         if (expr && location) {
-            std::cerr << "Found assignment: " << location << " = " << expr << std::endl;
+            LOG_DEBUG("Found assignment: " << location << " = " << expr);
             
             // Extract response field name from expr (e.g., "_res.param" -> "param")
             std::string exprStr(expr);
@@ -398,7 +445,7 @@ bool getInterfaceFieldsFromAssignTag(tinyxml2::XMLElement* element, std::vector<
                 responseFieldToDatamodelMap[responseField] = datamodelVar;
                 interfaceFields.push_back(responseField);
                 
-                add_to_log("Mapped response field '" + responseField + "' to datamodel variable '" + datamodelVar + "'");
+                LOG_DEBUG("Mapped response field '" << responseField << "' to datamodel variable '" << datamodelVar << "'");
             }
         }
         fieldElement = fieldElement->NextSiblingElement("assign");
@@ -410,21 +457,21 @@ bool getInterfaceFieldsFromAssignTag(tinyxml2::XMLElement* element, std::vector<
 bool getInterfaceFieldsFromFieldTag(tinyxml2::XMLElement* element, std::vector<std::string>& interfaceFields)
 {
     if (element == nullptr) {
-        std::cerr << "Element is null" << std::endl;
+        LOG_WARNING("Element is null");
         return false;
     }
     
     // get the first child element
     tinyxml2::XMLElement* fieldElement = element->FirstChildElement("field");
     if (!fieldElement) {
-        std::cerr << "No field element found in the provided element" << std::endl;
+        LOG_WARNING("No field element found in the provided element");
         return false;
     }
     while (fieldElement) {
         const char* fieldName = fieldElement->Attribute("name");
-        add_to_log("fieldName: " + std::string(fieldName) + " at line " + std::to_string(__LINE__));
+        LOG_DEBUG("fieldName: " << (fieldName ? fieldName : "null") << " at line " << __LINE__);
         if (fieldName) {
-            std::cerr << "Found field: " << fieldName << std::endl;
+            LOG_DEBUG("Found field: " << fieldName);
             interfaceFields.push_back(fieldName);
         }
         fieldElement = fieldElement->NextSiblingElement("expr");
@@ -432,42 +479,12 @@ bool getInterfaceFieldsFromFieldTag(tinyxml2::XMLElement* element, std::vector<s
     return true;
 }
 
-bool parseInterfaceTypesFromSCXML(const fileDataStr fileData, eventDataStr& eventData)
+bool parseInterfaceTypesFromSCXML(const hlModelDataStr& hlModel, eventDataStr& eventData)
 {
-    // Parse the SCXML file to extract types directly from the datamodel
-    tinyxml2::XMLDocument doc;
-    
-    if (doc.LoadFile(fileData.inputFileName.c_str()) != tinyxml2::XML_SUCCESS) {
-        std::cerr << "Failed to load SCXML file: " << fileData.inputFileName << std::endl;
-        return false;
-    }
-    
-    tinyxml2::XMLElement* root = doc.RootElement();
-    if (!root) {
-        std::cerr << "No root element found in SCXML file: " << fileData.inputFileName << std::endl;
-        return false;
+    // The datamodel types are parsed once when the model is loaded
+    for (const auto& data : hlModel.datamodelTypes) {
+        eventData.interfaceData[data.first] = data.second;
     }
-    
-    // Parse datamodel to get variable types directly
-    tinyxml2::XMLElement* datamodel = root->FirstChildElement("datamodel");
-    if (datamodel) {
-        tinyxml2::XMLElement* dataElement = datamodel->FirstChildElement("data");
-        while (dataElement) {
-            const char* id = dataElement->Attribute("id");
-            const char* type = dataElement->Attribute("type");
-            
-            if (id && type) {
-                std::string varName(id);
-                std::string varType(type);
-                
-                // Store the type mapping for this variable
-                eventData.interfaceData[varName] = varType;
-                add_to_log("Found datamodel variable: " + varName + " -> " + varType + " at line " + std::to_string(__LINE__));
-            }
-            dataElement = dataElement->NextSiblingElement("data");
-        }
-    }
-    
     return true;
 }
 
@@ -485,42 +502,58 @@ bool parseInterfaceTypesFromSCXML(const fileDataStr fileData, eventDataStr& even
  */
 bool extractFromSCXML(tinyxml2::XMLDocument& doc, const std::string fileName, std::string& rootName, std::vector<tinyxml2::XMLElement*>& elementsTransition, std::vector<tinyxml2::XMLElement*>& elementsSend) 
 {
-    add_to_log("opening file: " + fileName + " at line " + std::to_string(__LINE__));
-    if (doc.LoadFile(fileName.c_str()) != tinyxml2::XML_SUCCESS) {
-        std::cerr << "Failed to load '" << fileName << "' file" << std::endl;
+    LOG_DEBUG("opening file: " << fileName << " at line " << __LINE__);
+    if (!parseInputFile(doc, fileName)) {
         return false;
     }
- 
+    return extractFromSCXMLDocument(doc, rootName, elementsTransition, elementsSend);
+}
+
+/**
+ * @brief Extract data from a SCXML document already in memory (rootname, transition and send event elements)
+ * 
+ * @param doc SCXML document object, e.g. the document produced by the Translator
+ * @param rootName name value of the root element of the SCXML document
+ * @param elementsTransition vector of transition event elements found in the SCXML document
+ * @param elementsSend vector of send event elements found in the SCXML document
+ * @return true 
+ * @return false 
+ */
+bool extractFromSCXMLDocument(tinyxml2::XMLDocument& doc, std::string& rootName, std::vector<tinyxml2::XMLElement*>& elementsTransition, std::vector<tinyxml2::XMLElement*>& elementsSend) 
+{
     tinyxml2::XMLElement* root = doc.RootElement();
     if (!root) {
-        std::cerr << "No root element found" << std::endl;
+        LOG_ERROR("No root element found");
         return false;
     }
     rootName = std::string(root->Attribute("name")); 
     if(rootName == std::string(""))
     {
-        std::cerr << "No root name found" << std::endl;
+        LOG_ERROR("No root name found");
         return false;
     }
       
+    elementIndexStr index;
+    buildElementIndex(root, index);
+
     // Get transitions
-    findElementVectorByTagAndAttribute(root, std::string("transition"), "event", elementsTransition);
+    findElementVectorByTagAndAttribute(index, "transition", "event", elementsTransition);
     if (elementsTransition.empty()) {
-        add_to_log("No transition elements found.");
+        LOG_DEBUG("No transition elements found.");
     } 
     else 
     {
-        add_to_log("Transition elements found.");
+        LOG_DEBUG("Transition elements found.");
     }
 
     // Get Send
-    findElementVectorByTagAndAttribute(root, std::string("send"), "event", elementsSend);
+    findElementVectorByTagAndAttribute(index, "send", "event", elementsSend);
     if (elementsSend.empty()) {
-        add_to_log("No Send elements found.");
+        LOG_DEBUG("No Send elements found.");
     } 
     else 
     {
-        add_to_log("Send elements found.");
+        LOG_DEBUG("Send elements found.");
     }
     return true;
 }
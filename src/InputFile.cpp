@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file InputFile.cpp
+ * @brief This file contains the functions to map the input files (SCXML and templates) in memory once per process.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+
+#include "InputFile.h"
+#include <filesystem>
+#include <mutex>
+#include <atomic>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+ * \defgroup InputFile InputFile
+ * The input files are mapped read-only and parsed from memory. A mapping is shared by all the users of the file while
+ * one of them keeps it (e.g. the translation, the generation and the manifest of a skill, the templates of a batch) and
+ * it is replaced when the size or the last write time of the file changes.
+ * @{
+ */
+
+static std::mutex mappedFilesMutex;
+static std::map<std::string, std::weak_ptr<const mappedFileStr>> mappedFiles;
+static std::atomic<bool> mappingEnabled{true};
+
+/**
+ * @brief Enable or disable the mapping of the files, when disabled the files are read in memory
+ *
+ * @param enabled true to map the files (default), false to read them (e.g. files edited in place while watched)
+ */
+void setInputFileMapping(bool enabled)
+{
+    mappingEnabled = enabled;
+}
+
+/**
+ * @brief Map the content of a regular file
+ *
+ * @param file mapped file structure with path and size already set, data is set on success
+ * @return true
+ * @return false if the file can not be mapped
+ */
+static bool mapFileContent(mappedFileStr& file)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = open(file.path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    void* data = mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid after the file is closed
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    file.data = static_cast<const char*>(data);
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Read the content of a file in the buffer of the mapped file structure
+ *
+ * @param file mapped file structure with path set, data and size are set on success
+ * @return true
+ * @return false if the file can not be read
+ */
+static bool readFileContent(mappedFileStr& file)
+{
+    std::ifstream stream(file.path, std::ios::binary);
+    if (!stream.is_open()) {
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << stream.rdbuf();
+    file.buffer = buffer.str();
+    file.data = file.buffer.data();
+    file.size = file.buffer.size();
+    return true;
+}
+
+/**
+ * @brief Map a file in memory, the mapping is shared with the other users of the file while it is alive
+ *
+ * @param filePath path of the file
+ * @return std::shared_ptr<const mappedFileStr> mapped file, nullptr if the file can not be read (no error is printed)
+ */
+std::shared_ptr<const mappedFileStr> mapInputFile(const std::string& filePath)
+{
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::file_status status = fs::status(filePath, ec);
+    if (ec || !fs::exists(status)) {
+        return nullptr;
+    }
+    bool regularFile = fs::is_regular_file(status);
+    uintmax_t size = regularFile ? fs::file_size(filePath, ec) : 0;
+    int64_t modificationTime = regularFile ? fs::last_write_time(filePath, ec).time_since_epoch().count() : 0;
+    if (ec) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mappedFilesMutex);
+    std::weak_ptr<const mappedFileStr>& cached = mappedFiles[filePath];
+    if (std::shared_ptr<const mappedFileStr> file = cached.lock()) {
+        if (regularFile && file->size == size && file->modificationTime == modificationTime) {
+            return file;
+        }
+    }
+
+    auto file = std::make_unique<mappedFileStr>();
+    file->path = filePath;
+    file->size = size;
+    file->modificationTime = modificationTime;
+    bool mapped = regularFile && size > 0 && mappingEnabled && mapFileContent(*file);
+    if (!mapped && (!regularFile || size > 0) && !readFileContent(*file)) {
+        return nullptr;
+    }
+    LOG_DEBUG((mapped ? "Mapped file: " : "Read file: ") << filePath << " (" << file->size << " bytes)");
+    std::shared_ptr<const mappedFileStr> shared(file.release(), [mapped](const mappedFileStr* file) {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mapped) {
+            munmap(const_cast<char*>(file->data), file->size);
+        }
+#endif
+        delete file;
+    });
+    cached = shared;
+    return shared;
+}
+
+/**
+ * @brief Parse a XML file from its mapped content
+ *
+ * @param doc XMLDocument where the file is parsed
+ * @param filePath path of the file
+ * @return true
+ * @return false if the file can not be read or parsed, the error is printed
+ */
+bool parseInputFile(tinyxml2::XMLDocument& doc, const std::string& filePath)
+{
+    std::shared_ptr<const mappedFileStr> file = mapInputFile(filePath);
+    if (!file) {
+        error_stream() << "Failed to load '" << filePath << "' file" << std::endl;
+        return false;
+    }
+    // tinyxml2 copies the content in its own buffer, the mapping is not needed after the parse
+    if (doc.Parse(file->view().data(), file->size) != tinyxml2::XML_SUCCESS) {
+        error_stream() << "Failed to load '" << filePath << "' file" << std::endl;
+        return false;
+    }
+    return true;
+}
+/** @} */ // end of InputFile group
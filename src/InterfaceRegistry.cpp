@@ -0,0 +1,251 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file InterfaceRegistry.cpp
+ * @brief This file contains the functions to read the components and the interfaces of the specification once per process.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+
+#include "InterfaceRegistry.h"
+#include "InputFile.h"
+#include "Manifest.h"
+#include "ExtractFromElement.h"
+#include <filesystem>
+#include <mutex>
+#include <algorithm>
+
+/**
+ * \defgroup InterfaceRegistry InterfaceRegistry
+ * The specification of the project (the componentDeclaration elements of full-model.xml and the interface, function
+ * and protocol elements of interfaces.xml) is parsed once in hash maps queried by "componentName.functionName". The
+ * registry is shared by all the skills of a run and parsed again only when one of its files changes.
+ * @{
+ */
+
+static std::mutex registriesMutex;
+static std::map<std::string, std::shared_ptr<const interfaceRegistryStr>> registries; // model file and interface file -> registry
+
+/**
+ * @brief Read the dataType and the dataField elements of a requestValue or returnValue element
+ *
+ * @param valueElement requestValue or returnValue element, nullptr if the function has none
+ * @param dataType dataType of the element passed by reference
+ * @param fields field names passed by reference, from the name attribute or the text of the dataField elements
+ * @param interfaceData field and type passed by reference, for the dataField elements with a type attribute
+ */
+static void readInterfaceValue(tinyxml2::XMLElement* valueElement, std::string& dataType, std::vector<std::string>& fields, std::map<std::string, std::string>& interfaceData)
+{
+    if (!valueElement) {
+        return;
+    }
+    tinyxml2::XMLElement* dataTypeElement = valueElement->FirstChildElement("dataType");
+    if (dataTypeElement && dataTypeElement->GetText()) {
+        dataType = dataTypeElement->GetText();
+    }
+    for (tinyxml2::XMLElement* field = valueElement->FirstChildElement("dataField"); field; field = field->NextSiblingElement("dataField")) {
+        const char* name = field->Attribute("name");
+        if (!name) {
+            name = field->GetText();
+        }
+        if (!name) {
+            continue;
+        }
+        fields.push_back(name);
+        if (const char* type = field->Attribute("type")) {
+            interfaceData[name] = type;
+        }
+    }
+}
+
+/**
+ * @brief Parse the components of the model file and the interfaces of the interface file in a registry
+ *
+ * @param modelFileName model file with the componentDeclaration elements (e.g. full-model.xml)
+ * @param interfaceFileName interface file with the interface elements (e.g. interfaces.xml), empty to use the path of the interfaces element of the model file
+ * @param registry registry passed by reference where the components and their functions are stored
+ * @return true
+ * @return false if a file can not be read or parsed, the error is printed
+ */
+bool loadInterfaceRegistry(const std::string& modelFileName, const std::string& interfaceFileName, interfaceRegistryStr& registry)
+{
+    TRACE_PHASE_DETAIL("loadInterfaceRegistry", modelFileName);
+    registry = interfaceRegistryStr();
+    registry.modelFileName = modelFileName;
+    registry.interfaceFileName = interfaceFileName;
+
+    tinyxml2::XMLDocument modelDoc;
+    // the mapping is kept by the registry and shared with the parse
+    std::shared_ptr<const mappedFileStr> modelFile = mapInputFile(modelFileName);
+    if (!parseInputFile(modelDoc, modelFileName) || !modelFile) {
+        return false;
+    }
+    tinyxml2::XMLElement* modelRoot = modelDoc.RootElement();
+    if (registry.interfaceFileName.empty()) {
+        // the interface file of the model is relative to the model file
+        tinyxml2::XMLElement* interfacesElement = nullptr;
+        const char* interfacesPath = findElementByTag(modelRoot, "interfaces", interfacesElement) ? interfacesElement->Attribute("path") : nullptr;
+        if (!interfacesPath) {
+            error_stream() << "No interfaces path found in file '" << modelFileName << "', use --interface_filename" << std::endl;
+            return false;
+        }
+        registry.interfaceFileName = (std::filesystem::path(modelFileName).parent_path() / interfacesPath).lexically_normal().string();
+    }
+
+    tinyxml2::XMLDocument interfaceDoc;
+    std::shared_ptr<const mappedFileStr> interfaceFile = mapInputFile(registry.interfaceFileName);
+    if (!parseInputFile(interfaceDoc, registry.interfaceFileName) || !interfaceFile) {
+        return false;
+    }
+    registry.files = {modelFile, interfaceFile};
+    registry.hash = hashContent(hashContent(modelFile->view()) + hashContent(interfaceFile->view()));
+
+    // functions of each interface, the nested interface elements of the protocols are not interfaces
+    std::unordered_map<std::string, std::vector<std::pair<std::string, interfaceFunctionStr>>> interfaceFunctions;
+    for (tinyxml2::XMLElement* interface = interfaceDoc.RootElement()->FirstChildElement("interface"); interface; interface = interface->NextSiblingElement("interface")) {
+        const char* interfaceId = interface->Attribute("id");
+        if (!interfaceId) {
+            continue;
+        }
+        auto& functions = interfaceFunctions[interfaceId];
+        for (tinyxml2::XMLElement* function = interface->FirstChildElement("function"); function; function = function->NextSiblingElement("function")) {
+            const char* functionId = function->Attribute("id");
+            if (!functionId) {
+                continue;
+            }
+            interfaceFunctionStr interfaceFunction;
+            interfaceFunction.interfaceName = interfaceId;
+            tinyxml2::XMLElement* protocol = function->FirstChildElement("protocol");
+            tinyxml2::XMLElement* rosData = protocol ? protocol->FirstChildElement("ROS2data") : nullptr;
+            tinyxml2::XMLElement* rosInterface = rosData ? rosData->FirstChildElement("interface") : nullptr;
+            if (rosInterface && rosInterface->Attribute("type")) {
+                interfaceFunction.interfaceType = rosInterface->Attribute("type");
+            }
+            readInterfaceValue(function->FirstChildElement("requestValue"), interfaceFunction.requestDataType, interfaceFunction.requestFields, interfaceFunction.interfaceData);
+            readInterfaceValue(function->FirstChildElement("returnValue"), interfaceFunction.returnDataType, interfaceFunction.returnFields, interfaceFunction.interfaceData);
+            functions.emplace_back(functionId, std::move(interfaceFunction));
+        }
+    }
+
+    std::vector<tinyxml2::XMLElement*> components;
+    findElementVectorByTag(modelRoot, "componentDeclaration", components);
+    for (const auto& component : components) {
+        const char* componentId = component->Attribute("id");
+        const char* interfaceId = component->Attribute("interface");
+        if (!componentId || !interfaceId) {
+            LOG_WARNING("componentDeclaration without id or interface in file '" << modelFileName << "'");
+            continue;
+        }
+        registry.componentInterfaces[componentId] = interfaceId;
+        auto functions = interfaceFunctions.find(interfaceId);
+        if (functions == interfaceFunctions.end()) {
+            LOG_WARNING("Interface '" << interfaceId << "' of component '" << componentId << "' not found in file '" << registry.interfaceFileName << "'");
+            continue;
+        }
+        for (const auto& [functionId, interfaceFunction] : functions->second) {
+            registry.functions[std::string(componentId) + "." + functionId] = interfaceFunction;
+        }
+    }
+    LOG_DEBUG("Interface registry: " << registry.componentInterfaces.size() << " components, " << registry.functions.size() << " functions");
+    return true;
+}
+
+/**
+ * @brief Get the registry of the specification, parsed once and shared by all the skills while its files do not change
+ *
+ * @param modelFileName model file with the componentDeclaration elements, empty if there is no specification
+ * @param interfaceFileName interface file, empty to use the path of the interfaces element of the model file
+ * @return std::shared_ptr<const interfaceRegistryStr> registry, nullptr if there is no specification or it can not be loaded
+ */
+std::shared_ptr<const interfaceRegistryStr> getInterfaceRegistry(const std::string& modelFileName, const std::string& interfaceFileName)
+{
+    if (modelFileName.empty()) {
+        return nullptr;
+    }
+    // the lock is kept while parsing, so that the skills generated in parallel wait for a single parse
+    std::lock_guard<std::mutex> lock(registriesMutex);
+    std::shared_ptr<const interfaceRegistryStr>& cached = registries[modelFileName + "\n" + interfaceFileName];
+    if (cached) {
+        // the registry keeps its files mapped, a changed file is mapped again at a different address
+        bool unchanged = true;
+        for (const auto& file : cached->files) {
+            unchanged &= mapInputFile(file->path) == file;
+        }
+        if (unchanged) {
+            return cached;
+        }
+    }
+    auto registry = std::make_shared<interfaceRegistryStr>();
+    if (!loadInterfaceRegistry(modelFileName, interfaceFileName, *registry)) {
+        cached = nullptr;
+        return nullptr;
+    }
+    cached = registry;
+    return cached;
+}
+
+/**
+ * @brief Find the function of an event in the registry (key "componentName.functionName")
+ *
+ * @param registry registry of the specification
+ * @param componentName component of the event
+ * @param functionName function of the event
+ * @return const interfaceFunctionStr* function, nullptr if the component or its function is not in the specification
+ */
+const interfaceFunctionStr* findInterfaceFunction(const interfaceRegistryStr& registry, const std::string& componentName, const std::string& functionName)
+{
+    auto function = registry.functions.find(componentName + "." + functionName);
+    return function != registry.functions.end() ? &function->second : nullptr;
+}
+
+/**
+ * @brief Set the interface data of an event from the specification, used for the events without a ROS element in the High-Level SCXML
+ *
+ * @param registry registry of the specification
+ * @param eventData event data structure passed by reference where the interface data is stored
+ * @return true
+ * @return false if the function of the event is not in the specification or has no protocol
+ */
+bool getInterfaceFromRegistry(const interfaceRegistryStr& registry, eventDataStr& eventData)
+{
+    // findInterfaceType writes the dots of the names as slashes
+    std::string componentName = eventData.componentName;
+    std::string functionName = eventData.functionName;
+    std::replace(componentName.begin(), componentName.end(), '/', '.');
+    std::replace(functionName.begin(), functionName.end(), '/', '.');
+    const interfaceFunctionStr* function = findInterfaceFunction(registry, componentName, functionName);
+    if (!function || function->interfaceType.empty()) {
+        return false;
+    }
+    LOG_DEBUG("Interface of " << componentName << "." << functionName << " from the specification: " << function->interfaceName << " (" << function->interfaceType << ")");
+    eventData.interfaceType = function->interfaceType;
+    eventData.interfaceName = function->interfaceName;
+    eventData.interfaceData.insert(function->interfaceData.begin(), function->interfaceData.end());
+    if (function->interfaceType == "topic") {
+        // the skill subscribes to the topic of the component, the message type is the dataType of the returned value
+        std::string dataType = function->returnDataType;
+        std::string packageName = dataType.substr(0, dataType.find("::"));
+        std::string messageName = dataType.substr(dataType.find_last_of(":") + 1);
+        eventData.messageInterfaceType = packageName + "/" + messageName;
+        eventData.interfaceName = packageName;
+        eventData.rosInterfaceType = "topic-subscriber";
+        eventData.topicName = "/" + eventData.componentName + "/" + eventData.functionName;
+        eventData.interfaceTopicFields = function->returnFields;
+        return true;
+    }
+    eventData.messageInterfaceType = function->interfaceName + "/" + functionName;
+    if (function->interfaceType == "action") {
+        eventData.rosInterfaceType = "action-client";
+        eventData.clientName = "/" + eventData.componentName + "/" + eventData.functionName;
+        return true;
+    }
+    eventData.rosInterfaceType = "service-client";
+    eventData.serviceTypeName = functionName;
+    turnToSnakeCase(eventData.serviceTypeName, eventData.serviceTypeNameSnakeCase);
+    eventData.interfaceRequestFields = function->requestFields;
+    eventData.interfaceResponseFields = function->returnFields;
+    return true;
+}
+/** @} */ // end of InterfaceRegistry group
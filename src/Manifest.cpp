@@ -0,0 +1,239 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file Manifest.cpp
+ * @brief This file contains the functions to skip the generation of the skills whose inputs did not change.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+
+#include "Manifest.h"
+#include "InputFile.h"
+#include "InterfaceRegistry.h"
+#include <filesystem>
+#include <iomanip>
+
+/**
+ * \defgroup Manifest Manifest
+ * The output directory of each skill contains a manifest (manifestFileName) with the generation key of the skill and the
+ * hash of each generated file. If the key and the files are unchanged the generation is skipped.
+ * @{
+ */
+
+/**
+ * @brief Compute the hash of a content (64 bit FNV-1a, stable across platforms and runs)
+ *
+ * @param content content to be hashed
+ * @return std::string hexadecimal hash
+ */
+std::string hashContent(std::string_view content)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : content) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    std::ostringstream hashStream;
+    hashStream << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return hashStream.str();
+}
+
+/**
+ * @brief Read a whole file without printing errors, missing files are expected
+ *
+ * @param filePath path of the file
+ * @param fileContent content returned by reference
+ * @return true
+ * @return false if the file can not be read
+ */
+static bool readFileQuietly(const std::string& filePath, std::string& fileContent)
+{
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    fileContent = buffer.str();
+    return true;
+}
+
+/**
+ * @brief Get the path of the manifest of a skill
+ *
+ * @param fileData file data structure of the skill
+ * @return std::string
+ */
+static std::string getManifestPath(const fileDataStr& fileData)
+{
+    return fileData.outputPath + manifestFileName;
+}
+
+/**
+ * @brief Get the generated files of a skill, relative to the output directory
+ *
+ * @param fileData file data structure of the skill, with the names of the generated files
+ * @return std::vector<std::string>
+ */
+static std::vector<std::string> getGeneratedFiles(const fileDataStr& fileData)
+{
+    namespace fs = std::filesystem;
+    std::vector<std::string> files;
+    if (fileData.translate_mode) {
+        files.push_back(fileData.outputFileTranslatedSM);
+    }
+    if (fileData.generate_mode) {
+        files.push_back(fileData.outputPathInclude + fileData.outputFileNameH);
+        files.push_back(fileData.outputPathSrc + fileData.outputFileNameCPP);
+        files.push_back(fileData.outputPath + fileData.outputCMakeListsFileName);
+        files.push_back(fileData.outputPath + fileData.outputPackageXMLFileName);
+        files.push_back(fileData.outputPathSrc + fileData.outputMainFileName);
+        if (fileData.datamodel_mode) {
+            files.push_back(fileData.outputPathInclude + fileData.outputDatamodelFileNameH);
+            files.push_back(fileData.outputPathSrc + fileData.outputDatamodelFileNameCPP);
+        }
+    }
+    fs::path outputPath = fs::path(fileData.outputPath).lexically_normal();
+    for (auto& file : files) {
+        file = fs::path(file).lexically_normal().lexically_relative(outputPath).generic_string();
+    }
+    return files;
+}
+
+/**
+ * @brief Get the generation key of a skill: tool version, options, input SCXML and templates
+ *
+ * @param fileData file data structure of the skill
+ * @param templateFileData template file data structure with the templates already read
+ * @param manifest manifest passed by reference where the generation key is stored
+ * @return true
+ * @return false if the input file can not be read
+ */
+bool getGenerationKey(const fileDataStr& fileData, const templateFileDataStr& templateFileData, generationManifestStr& manifest)
+{
+    // same mapping as the translation when the caller keeps the input mapped
+    std::shared_ptr<const mappedFileStr> inputFile = mapInputFile(fileData.inputFileName);
+    if (!inputFile) {
+        return false;
+    }
+    std::string templatesContent;
+    for (const auto& [templateName, templateCode] : templateFileData.codeMap) {
+        templatesContent += templateName + "\n" + hashContent(templateCode) + "\n";
+    }
+    manifest.key.clear();
+    manifest.key["version"] = MODEL2CODE_VERSION;
+    manifest.key["options"] = std::string("datamodel=") + (fileData.datamodel_mode ? "1" : "0") +
+                              ",translate=" + (fileData.translate_mode ? "1" : "0") +
+                              ",generate=" + (fileData.generate_mode ? "1" : "0");
+    // a fixed datetime is part of the output, the current one would never match
+    manifest.key["datetime"] = isGenerationDatetimeFixed(fileData.reproducible_mode) ? hashContent(fileData.generationDatetime) : "current";
+    manifest.key["input"] = hashContent(inputFile->view());
+    manifest.key["templates"] = hashContent(templatesContent);
+    if (std::shared_ptr<const interfaceRegistryStr> registry = getInterfaceRegistry(fileData.modelFileName, fileData.interfaceFileName)) {
+        manifest.key["specification"] = registry->hash;
+    }
+    return true;
+}
+
+/**
+ * @brief Read the manifest of the output directory
+ *
+ * @param manifestPath path of the manifest
+ * @param manifest manifest returned by reference
+ * @return true
+ * @return false if there is no valid manifest
+ */
+static bool readManifest(const std::string& manifestPath, generationManifestStr& manifest)
+{
+    std::string manifestContent;
+    if (!readFileQuietly(manifestPath, manifestContent)) {
+        return false;
+    }
+    std::istringstream manifestStream(manifestContent);
+    std::string line;
+    while (std::getline(manifestStream, line)) {
+        std::istringstream lineStream(line);
+        std::string entry, name, hash;
+        if (!(lineStream >> entry) || entry[0] == '#') {
+            continue;
+        }
+        if (entry == "file" && lineStream >> name >> hash) {
+            manifest.files[name] = hash;
+        }
+        else if (entry != "file" && lineStream >> name) {
+            manifest.key[entry] = name;
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Check if the output directory already contains the code generated with the same generation key
+ *
+ * @param fileData file data structure of the skill
+ * @param manifest manifest with the generation key of the skill
+ * @return true if the manifest of the output directory has the same key and all the generated files are unchanged
+ * @return false
+ */
+bool isGenerationUpToDate(const fileDataStr& fileData, const generationManifestStr& manifest)
+{
+    generationManifestStr previousManifest;
+    if (!readManifest(getManifestPath(fileData), previousManifest)) {
+        LOG_DEBUG("No generation manifest in: " << fileData.outputPath);
+        return false;
+    }
+    if (previousManifest.key != manifest.key || previousManifest.files.empty()) {
+        LOG_DEBUG("Generation manifest outdated: " << getManifestPath(fileData));
+        return false;
+    }
+    // the generated files may have been edited or deleted
+    for (const auto& [file, hash] : previousManifest.files) {
+        std::string fileContent;
+        if (!readFileQuietly(fileData.outputPath + file, fileContent) || hashContent(fileContent) != hash) {
+            LOG_DEBUG("Generated file changed: " << file);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Write the manifest of the generated files in the output directory
+ *
+ * @param fileData file data structure of the skill, with the names of the generated files
+ * @param manifest manifest with the generation key of the skill, the hashes of the generated files are added
+ * @return true
+ * @return false
+ */
+bool writeManifest(const fileDataStr& fileData, generationManifestStr& manifest)
+{
+    manifest.files.clear();
+    for (const auto& file : getGeneratedFiles(fileData)) {
+        std::string fileContent;
+        if (!readFileQuietly(fileData.outputPath + file, fileContent)) {
+            error_stream() << "Failed to read generated file for the manifest: " << fileData.outputPath + file << std::endl;
+            return false;
+        }
+        manifest.files[file] = hashContent(fileContent);
+    }
+    std::ofstream manifestFile(getManifestPath(fileData));
+    if (!manifestFile.is_open()) {
+        error_stream() << "Failed to open file for writing: " << getManifestPath(fileData) << std::endl;
+        return false;
+    }
+    manifestFile << "# model2code generation manifest, the skill is generated again only if an entry changes\n";
+    for (const auto& [entry, value] : manifest.key) {
+        manifestFile << entry << " " << value << "\n";
+    }
+    for (const auto& [file, hash] : manifest.files) {
+        manifestFile << "file " << file << " " << hash << "\n";
+    }
+    LOG_DEBUG("Generation manifest written: " << getManifestPath(fileData));
+    return true;
+}
+/** @} */ // end of Manifest group
@@ -0,0 +1,221 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file Model2Code.cpp
+ * @brief This file contains the functions of the model2code library to translate and generate the skills, used by the command line tool.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+
+#include "Model2Code.h"
+
+/**
+ * \defgroup Model2Code Model2Code
+ * The translation and generation of a skill, shared by the command line tool (files written to disk, skipped when
+ * their manifest is up to date) and by the programs that embed the model2code_lib library (files kept in memory in
+ * their generation context).
+ * @{
+ */
+
+/**
+ * @brief Set the output paths of a skill, if no output path is provided it is taken from the input file name
+ * 
+ * @param fileData file data structure passed by reference where the output paths are stored
+ * @return true 
+ * @return false 
+ */
+bool setOutputPaths(fileDataStr& fileData)
+{
+    if(fileData.outputPath == "")
+    {
+        LOG_DEBUG("-----------");
+        LOG_DEBUG("Output path not provided");
+        // error_stream() << "Output path not provided" << std::endl;
+        getPath(fileData.inputFileName, fileData.outputPath);
+        if(fileData.outputPath == "")
+        {
+            error_stream() << "Not able to get output path from input file name" << std::endl;
+            error_stream() << "Run 'model2code --help' for instructions" << std::endl;
+            return RETURN_CODE_ERROR;
+        }
+        else
+        {
+            LOG_DEBUG("Got output path from input file name: " << fileData.outputPath);
+        }
+    }
+
+    fileData.outputPath = fileData.outputPath + "/";
+    fileData.outputPathInclude = fileData.outputPath + "/include/";
+    fileData.outputPathSrc = fileData.outputPath + "/src/";
+    return RETURN_CODE_OK;
+}
+
+/**
+ * @brief Translate and generate the code of a skill
+ * 
+ * The files are written in background: the result of their writes is returned by join_generation_tasks.
+ * 
+ * @param fileData file data structure of the skill
+ * @param templateFileData template file data structure, the templates are read by the first skill and reused by the next ones
+ * @param upToDate set to true if the skill is skipped because its inputs and its generated files did not change
+ * @return true if the skill is generated successfully or is up to date
+ * @return false 
+ */
+bool generateSkill(fileDataStr fileData, templateFileDataStr& templateFileData, bool& upToDate)
+{
+    TRACE_PHASE_DETAIL("generateSkill", fileData.inputFileName);
+    upToDate = false;
+    if(!fileData.translate_mode & fileData.generate_mode)
+    {
+        // Generation request without translation
+        fileData.inputFileNameGeneration = fileData.inputFileName;   
+    }
+    else if(!fileData.translate_mode & !fileData.generate_mode)
+    {
+        fileData.translate_mode= true;
+        fileData.generate_mode = true;
+    }
+
+    // Same datetime in all the files of the skill
+    fileData.generationDatetime = getGenerationDatetime(fileData.reproducible_mode);
+
+    // The input is mapped once for the generation key, the translation and the generation
+    std::shared_ptr<const mappedFileStr> inputFile = mapInputFile(fileData.inputFileName);
+
+    // The model errors are reported before the generation, instead of by the build of the generated package
+    if(fileData.validate_mode && !validateSkill(fileData))
+    {
+        return false;
+    }
+
+    // Skip the skill if its inputs and its generated files did not change since the last generation
+    generationManifestStr manifest;
+    if(fileData.generate_mode && !readTemplates(templateFileData, templateFileData.codeMap))
+    {
+        return false;
+    }
+    // the generations in memory have no output directory, and so no manifest
+    bool hasGenerationKey;
+    {
+        TRACE_PHASE("checkUpToDate");
+        hasGenerationKey = !get_generation_context().inMemory && getGenerationKey(fileData, templateFileData, manifest);
+        upToDate = hasGenerationKey && !fileData.force_mode && isGenerationUpToDate(fileData, manifest);
+    }
+    if(upToDate)
+    {
+        output_stream() << "-----------" << std::endl;
+        output_stream() << "Skill up to date, generation skipped: " << fileData.inputFileName << std::endl;
+        return true;
+    }
+
+    // Translated SCXML, handed over in memory from the Translator to the Replacer
+    tinyxml2::XMLDocument translatedDoc;
+    std::future<bool> translatedSMWritten;
+    std::future<bool> filesWritten;
+    bool generated = true;
+    if(fileData.translate_mode)
+    {   
+        LOG_DEBUG("Translation request");
+        if(!Translator(fileData, translatedDoc, translatedSMWritten))
+        {
+            LOG_DEBUG("-----------");
+            LOG_DEBUG("Error in translation");
+            return false;
+        }
+        fileData.inputFileNameGeneration = fileData.outputFileTranslatedSM;
+        
+    }
+    if(fileData.generate_mode)
+    {
+
+        if(!Replacer(fileData, templateFileData, translatedDoc, filesWritten))
+        {
+            LOG_DEBUG("-----------");
+            LOG_DEBUG("Error in code generation");
+            generated = false;
+        }
+    }
+    // the files are written while the next skill is generated, join_generation_tasks waits for them
+    std::shared_future<bool> translatedSMShared;
+    std::shared_future<bool> filesShared;
+    if(translatedSMWritten.valid())
+    {
+        translatedSMShared = translatedSMWritten.share();
+        get_generation_context().writes.push_back(translatedSMShared);
+    }
+    if(filesWritten.valid())
+    {
+        filesShared = filesWritten.share();
+        get_generation_context().writes.push_back(filesShared);
+    }
+    // the writer runs the jobs in order, so the manifest is written once the files of the skill are
+    if(generated && hasGenerationKey)
+    {
+        get_generation_context().writes.push_back(queueOutputTask("writeManifest", [fileData, manifest, translatedSMShared, filesShared]() mutable {
+            if((translatedSMShared.valid() && !translatedSMShared.get()) || (filesShared.valid() && !filesShared.get()))
+            {
+                return true;
+            }
+            // without the manifest the skill is only generated again by the next run
+            if(!writeManifest(fileData, manifest))
+            {
+                LOG_WARNING("Generation manifest not written, the skill will be generated again: " << fileData.inputFileName);
+            }
+            return true;
+        }).share());
+    }
+    return generated;
+}
+
+/**
+ * @brief Translate the High-Level SCXML of a skill in memory
+ * 
+ * The translated SCXML is kept in the files of the context instead of being written, and the messages are written in
+ * the context (buffered if context.buffered is true). Generations with different contexts can run concurrently.
+ * 
+ * @param context generation context of the translation, set as the context of the current thread while translating
+ * @param fileData file data structure of the skill with the input file name and the options
+ * @param translatedDoc document passed by reference where the translated SCXML is stored
+ * @return true if the skill is translated successfully
+ * @return false 
+ */
+bool translate(generationContextStr& context, fileDataStr fileData, tinyxml2::XMLDocument& translatedDoc)
+{
+    generationContextStr& previousContext = get_generation_context();
+    context.inMemory = true;
+    set_generation_context(&context);
+    std::future<bool> translatedSMWritten;
+    bool translated = !setOutputPaths(fileData) && Translator(fileData, translatedDoc, translatedSMWritten);
+    set_generation_context(&previousContext);
+    return translated;
+}
+
+/**
+ * @brief Translate and generate the code of a skill in memory
+ * 
+ * The generated files (translated SCXML, header, source, CMakeLists.txt, package.xml, ...) are kept in the files of the
+ * context instead of being written, and the messages are written in the context (buffered if context.buffered is
+ * true). Generations with different contexts can run concurrently and share templateFileData: its templates are read by
+ * the first one, the others wait for them. Its templates must not be cleared or changed (e.g. templatePath) while a
+ * generation sharing it runs.
+ * 
+ * @param context generation context of the skill, set as the context of the current thread while generating
+ * @param fileData file data structure of the skill with the input file name and the options, the output path is only used as path of the files
+ * @param templateFileData template file data structure, the templates are read by the first generation and reused by the next ones
+ * @return true if the skill is generated successfully
+ * @return false 
+ */
+bool generate(generationContextStr& context, fileDataStr fileData, templateFileDataStr& templateFileData)
+{
+    generationContextStr& previousContext = get_generation_context();
+    context.inMemory = true;
+    set_generation_context(&context);
+    bool upToDate;
+    bool generated = !setOutputPaths(fileData) && generateSkill(fileData, templateFileData, upToDate);
+    generated = join_generation_tasks() && generated;
+    set_generation_context(&previousContext);
+    return generated;
+}
+/** @} */ // end of Model2Code group
@@ -0,0 +1,409 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file OutputWriter.cpp
+ * @brief This file contains the functions to write the generated files in background, without leaving partially written files.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+
+#include "OutputWriter.h"
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <cstdio>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+ * \defgroup OutputWriter OutputWriter
+ * The generated files are queued to a writer thread, so that the generation of the next files overlaps with the disk
+ * writes. Each file is written to a temporary file next to it and renamed over the previous one once all the files of
+ * the queued group are written, so an interrupted run never leaves a partially written file. With the sync enabled
+ * (--fsync) the temporary files are synced before the rename and their directories once at the flush.
+ * @{
+ */
+
+struct outputJobStr{ // group of files queued together, e.g. the files of a skill
+    const char* phase;
+    std::vector<outputFileStr> files;
+    std::function<bool()> task; // run instead of writing files, after the files queued before it (e.g. the manifest)
+    std::shared_ptr<generationContextStr> context; // messages and phases of the write
+    std::promise<bool> written;
+};
+
+struct outputWriterStr{
+    std::mutex mutex;
+    std::condition_variable queued; // a job is queued or the writer is stopped
+    std::condition_variable idle; // the queue is empty and no job is being written
+    std::deque<outputJobStr> jobs;
+    bool writing = false;
+    bool stopped = false;
+    std::set<std::string> directories; // directories of the files written since the last flush, synced at the flush
+    std::thread thread;
+
+    ~outputWriterStr() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+        }
+        queued.notify_one();
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+};
+
+static outputWriterStr outputWriter;
+static std::atomic<bool> syncEnabled{false};
+
+/**
+ * @brief Enable or disable the sync of the generated files to disk
+ *
+ * @param enabled true to sync the files before they replace the previous ones and their directories at the flush
+ */
+void setOutputSync(bool enabled)
+{
+    syncEnabled = enabled;
+}
+
+/**
+ * @brief Sync a file or a directory to disk
+ *
+ * @param path path of the file or of the directory
+ * @return true
+ * @return false if the path can not be opened or synced
+ */
+static bool syncPath(const std::string& path)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool synced = fsync(fd) == 0;
+    close(fd);
+    return synced;
+#else
+    return true;
+#endif
+}
+
+/**
+ * @brief Check whether a file already has the given content
+ *
+ * @param path path of the file
+ * @param content content of the file
+ * @return true if the file exists with the same content
+ */
+static bool isFileUnchanged(const std::string& path, const std::string& content)
+{
+    std::error_code ec;
+    if (std::filesystem::file_size(path, ec) != content.size() || ec) {
+        return false;
+    }
+    std::ifstream existingFile(path, std::ios::binary);
+    std::ostringstream existingContent;
+    existingContent << existingFile.rdbuf();
+    return existingContent.str() == content;
+}
+
+/**
+ * @brief Write a group of files: each file is written to a temporary file, then all the temporary files are renamed if all of them are written
+ *
+ * @param files files to be written
+ * @param sync true to sync the temporary files before they are renamed
+ * @param directories directories of the written files, returned by reference
+ * @return true
+ * @return false if a file can not be written, none of the files of the group is replaced then
+ */
+static bool writeOutputFiles(const std::vector<outputFileStr>& files, bool sync, std::set<std::string>& directories)
+{
+    bool res = true;
+    std::vector<const outputFileStr*> writtenFiles;
+    for (const auto& file : files) {
+        TRACE_PHASE_DETAIL("writeFile", file.fileName);
+        std::string path = file.filePath + file.fileName;
+        // files with the same content are not written again, so that their modification time does not trigger a rebuild
+        if (isFileUnchanged(path, file.content)) {
+            output_stream() << file.fileName << " file unchanged\n";
+            continue;
+        }
+        std::string tempPath = path + ".model2code.tmp";
+        std::ofstream outputFile(tempPath, std::ios::binary);
+        if (!outputFile.is_open()) {
+            error_stream() << "Failed to open file for writing: " << path << std::endl;
+            res = false;
+            continue;
+        }
+        outputFile << file.content;
+        outputFile.close();
+        if (!outputFile || (sync && !syncPath(tempPath))) {
+            error_stream() << "Failed to write file: " << path << std::endl;
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            res = false;
+            continue;
+        }
+        TRACE_COUNTER("bytes written", file.content.size());
+        writtenFiles.push_back(&file);
+    }
+    if (!res) {
+        // the group is not replaced partially, the files already written are discarded
+        for (const auto* file : writtenFiles) {
+            std::error_code ec;
+            std::filesystem::remove(file->filePath + file->fileName + ".model2code.tmp", ec);
+        }
+        return false;
+    }
+    for (const auto* file : writtenFiles) {
+        std::string path = file->filePath + file->fileName;
+        std::error_code ec;
+        std::filesystem::rename(path + ".model2code.tmp", path, ec);
+        if (ec) {
+            error_stream() << "Failed to replace file: " << path << " (" << ec.message() << ")" << std::endl;
+            std::filesystem::remove(path + ".model2code.tmp", ec);
+            res = false;
+            continue;
+        }
+        directories.insert(file->filePath);
+        output_stream() << file->fileName << " file generated\n";
+    }
+    return res;
+}
+
+/**
+ * @brief Write the queued jobs until the writer is stopped
+ */
+static void runOutputWriter()
+{
+    std::unique_lock<std::mutex> lock(outputWriter.mutex);
+    while (true) {
+        outputWriter.queued.wait(lock, [] { return outputWriter.stopped || !outputWriter.jobs.empty(); });
+        if (outputWriter.jobs.empty()) {
+            return;
+        }
+        outputJobStr job = std::move(outputWriter.jobs.front());
+        outputWriter.jobs.pop_front();
+        outputWriter.writing = true;
+        lock.unlock();
+
+        std::set<std::string> directories;
+        bool written;
+        set_generation_context(job.context.get());
+        {
+            TRACE_PHASE(job.phase);
+            written = job.task ? job.task() : writeOutputFiles(job.files, syncEnabled, directories);
+        }
+        set_generation_context(nullptr);
+        job.written.set_value(written);
+
+        lock.lock();
+        outputWriter.directories.insert(directories.begin(), directories.end());
+        outputWriter.writing = false;
+        if (outputWriter.jobs.empty()) {
+            outputWriter.idle.notify_all();
+        }
+    }
+}
+
+/**
+ * @brief Queue a job to the background writer, its messages and phases are kept in a task of the generation context
+ *
+ * @param job job to be queued
+ * @return std::future<bool> result of the job
+ */
+static std::future<bool> queueOutputJob(outputJobStr job)
+{
+    generationContextStr& context = get_generation_context();
+    job.context = std::make_shared<generationContextStr>();
+    job.context->buffered = true;
+    job.context->trace = context.trace;
+    context.tasks.push_back(job.context);
+
+    std::future<bool> written = job.written.get_future();
+    {
+        std::lock_guard<std::mutex> lock(outputWriter.mutex);
+        if (!outputWriter.thread.joinable()) {
+            outputWriter.thread = std::thread(runOutputWriter);
+        }
+        outputWriter.jobs.push_back(std::move(job));
+    }
+    outputWriter.queued.notify_one();
+    return written;
+}
+
+/**
+ * @brief Queue files to the background writer, the files are written in order of queueing
+ *
+ * The messages and the phases of the writer are kept in a task of the generation context of the current thread and
+ * merged by join_generation_tasks once the returned future is ready. When the generation context is in memory the files
+ * are moved to its files instead and nothing is written.
+ *
+ * @param phase name of the traced phase of the write (e.g. "writeFiles")
+ * @param files files to be written, an existing file with the same content is left untouched
+ * @return std::future<bool> true when all the files are written
+ */
+std::future<bool> queueOutputFiles(const char* phase, std::vector<outputFileStr> files)
+{
+    generationContextStr& context = get_generation_context();
+    if (context.inMemory) {
+        std::move(files.begin(), files.end(), std::back_inserter(context.files));
+        std::promise<bool> kept;
+        kept.set_value(true);
+        return kept.get_future();
+    }
+    return queueOutputJob({phase, std::move(files), nullptr, nullptr, {}});
+}
+
+/**
+ * @brief Queue a task to the background writer, it is run once the files queued before it are written
+ *
+ * The messages and the phases of the task are kept as the ones of queueOutputFiles.
+ *
+ * @param phase name of the traced phase of the task (e.g. "writeManifest")
+ * @param task task to be run by the writer thread
+ * @return std::future<bool> result of the task
+ */
+std::future<bool> queueOutputTask(const char* phase, std::function<bool()> task)
+{
+    return queueOutputJob({phase, {}, std::move(task), nullptr, {}});
+}
+
+/**
+ * @brief Check whether two files have the same content, reading them in blocks
+ *
+ * @param path path of the first file
+ * @param otherPath path of the second file
+ * @return true if both files exist with the same content
+ */
+static bool areFilesEqual(const std::string& path, const std::string& otherPath)
+{
+    std::error_code ec, otherEc;
+    if (std::filesystem::file_size(path, ec) != std::filesystem::file_size(otherPath, otherEc) || ec || otherEc) {
+        return false;
+    }
+    std::ifstream file(path, std::ios::binary), otherFile(otherPath, std::ios::binary);
+    std::vector<char> block(64 * 1024), otherBlock(64 * 1024);
+    while (file && otherFile) {
+        file.read(block.data(), block.size());
+        otherFile.read(otherBlock.data(), otherBlock.size());
+        if (file.gcount() != otherFile.gcount() || !std::equal(block.begin(), block.begin() + file.gcount(), otherBlock.begin())) {
+            return false;
+        }
+    }
+    return file.eof() && otherFile.eof();
+}
+
+/**
+ * @brief Open the temporary file of a file written as a stream, it replaces the previous file with commitOutputStream
+ *
+ * @param filePath directory of the file
+ * @param fileName name of the file
+ * @return FILE* temporary file, nullptr if it can not be opened (the error is printed)
+ */
+FILE* openOutputStream(const std::string& filePath, const std::string& fileName)
+{
+    std::string tempPath = filePath + fileName + ".model2code.tmp";
+    FILE* stream = std::fopen(tempPath.c_str(), "wb");
+    if (!stream) {
+        error_stream() << "Failed to open file for writing: " << filePath + fileName << std::endl;
+    }
+    return stream;
+}
+
+/**
+ * @brief Close a file opened with openOutputStream and rename it over the previous file, unless they have the same content
+ *
+ * The messages and the phase of the write are kept in a task of the generation context of the current thread, in the
+ * same order as the files queued with queueOutputFiles.
+ *
+ * @param stream temporary file, closed
+ * @param phase name of the traced phase of the write (e.g. "writeTranslatedSM")
+ * @param filePath directory of the file
+ * @param fileName name of the file
+ * @return true
+ * @return false if the file can not be written
+ */
+bool commitOutputStream(FILE* stream, const char* phase, const std::string& filePath, const std::string& fileName)
+{
+    generationContextStr& context = get_generation_context();
+    auto writerContext = std::make_shared<generationContextStr>();
+    writerContext->buffered = true;
+    writerContext->trace = context.trace;
+    context.tasks.push_back(writerContext);
+    set_generation_context(writerContext.get());
+
+    bool written = true;
+    {
+        TRACE_PHASE_DETAIL(phase, fileName);
+        std::string path = filePath + fileName;
+        std::string tempPath = path + ".model2code.tmp";
+        bool closed = std::fflush(stream) == 0 && !std::ferror(stream);
+        closed = std::fclose(stream) == 0 && closed;
+        std::error_code ec;
+        if (!closed || (syncEnabled && !syncPath(tempPath))) {
+            error_stream() << "Failed to write file: " << path << std::endl;
+            std::filesystem::remove(tempPath, ec);
+            written = false;
+        }
+        else if (areFilesEqual(tempPath, path)) {
+            // as writeOutputFiles, a file with the same content is left untouched
+            std::filesystem::remove(tempPath, ec);
+            output_stream() << fileName << " file unchanged\n";
+        }
+        else {
+            TRACE_COUNTER("bytes written", std::filesystem::file_size(tempPath, ec));
+            std::filesystem::rename(tempPath, path, ec);
+            if (ec) {
+                error_stream() << "Failed to replace file: " << path << " (" << ec.message() << ")" << std::endl;
+                std::filesystem::remove(tempPath, ec);
+                written = false;
+            }
+            else {
+                std::lock_guard<std::mutex> lock(outputWriter.mutex);
+                outputWriter.directories.insert(filePath);
+                output_stream() << fileName << " file generated\n";
+            }
+        }
+    }
+    set_generation_context(&context);
+    return written;
+}
+
+/**
+ * @brief Wait for the queued files and sync the directories of the written files when the sync is enabled
+ *
+ * @return true
+ * @return false if a directory can not be synced
+ */
+bool flushOutputFiles()
+{
+    std::set<std::string> directories;
+    {
+        std::unique_lock<std::mutex> lock(outputWriter.mutex);
+        outputWriter.idle.wait(lock, [] { return outputWriter.jobs.empty() && !outputWriter.writing; });
+        directories.swap(outputWriter.directories);
+    }
+    if (!syncEnabled) {
+        return true;
+    }
+    bool res = true;
+    for (const auto& directory : directories) {
+        if (!syncPath(directory)) {
+            error_stream() << "Failed to sync directory: " << directory << std::endl;
+            res = false;
+        }
+    }
+    return res;
+}
+/** @} */ // end of OutputWriter group
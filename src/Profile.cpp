@@ -0,0 +1,171 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file Profile.cpp
+ * @brief This file contains the functions to write the phases traced during the generation as a profile.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+
+#include "Profile.h"
+#include <algorithm>
+#include <iomanip>
+
+/**
+ * \defgroup Profile Profile
+ * The phases are timed with TRACE_PHASE when the generation context traces them (--profile). They are written as
+ * Chrome trace-event JSON ("X" complete events, in microseconds) and summarized by self time.
+ * @{
+ */
+
+/**
+ * @brief Escape a string for a JSON string value
+ *
+ * @param str string to be escaped
+ * @return std::string escaped string, without quotes
+ */
+static std::string escapeJson(const std::string& str)
+{
+    std::ostringstream escaped;
+    for (char c : str) {
+        switch (c) {
+            case '"': escaped << "\\\""; break;
+            case '\\': escaped << "\\\\"; break;
+            case '\n': escaped << "\\n"; break;
+            case '\t': escaped << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+                } else {
+                    escaped << c;
+                }
+        }
+    }
+    return escaped.str();
+}
+
+/**
+ * @brief Write the traced phases as Chrome trace-event JSON, which can be opened in Perfetto or chrome://tracing
+ *
+ * @param fileName profile file
+ * @param events traced phases
+ * @param counters counters of the generation, written as counter events at the end of the profile
+ * @return true
+ * @return false if the file can not be written
+ */
+bool writeProfile(const std::string& fileName, const std::vector<traceEventStr>& events, const std::map<std::string, uint64_t>& counters)
+{
+    std::ofstream file(fileName);
+    if (!file.is_open()) {
+        error_stream() << "Failed to open file for writing: " << fileName << std::endl;
+        return false;
+    }
+    // the timestamps are relative to the first phase
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::time_point::max();
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::time_point::min();
+    for (const auto& event : events) {
+        origin = std::min(origin, event.start);
+        end = std::max(end, event.start + event.duration);
+    }
+    auto microseconds = [](std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration<double, std::micro>(duration).count();
+    };
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    file << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"model2code\"}}";
+    for (const auto& event : events) {
+        file << ",\n{\"name\": \"" << escapeJson(event.name) << "\", \"cat\": \"model2code\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.thread
+             << ", \"ts\": " << microseconds(event.start - origin) << ", \"dur\": " << microseconds(event.duration)
+             << ", \"args\": {";
+        // the allocations are counted only by the executables that replace operator new
+        if (event.allocations) {
+            file << "\"allocations\": " << event.allocations << (event.detail.empty() ? "" : ", ");
+        }
+        if (!event.detail.empty()) {
+            file << "\"detail\": \"" << escapeJson(event.detail) << "\"";
+        }
+        file << "}}";
+    }
+    for (const auto& [counter, value] : counters) {
+        file << ",\n{\"name\": \"" << escapeJson(counter) << "\", \"ph\": \"C\", \"pid\": 1, \"ts\": " << (events.empty() ? 0 : microseconds(end - origin))
+             << ", \"args\": {\"value\": " << value << "}}";
+    }
+    file << "\n]}\n";
+    file.close();
+    if (!file) {
+        error_stream() << "Failed to write profile: " << fileName << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Print the phases with the highest self time (time not spent in nested phases) and the counters
+ *
+ * @param events traced phases
+ * @param counters counters of the generation
+ * @param topCount number of phases printed
+ */
+void printProfileSummary(const std::vector<traceEventStr>& events, const std::map<std::string, uint64_t>& counters, size_t topCount)
+{
+    struct phaseSummaryStr{
+        size_t calls = 0;
+        std::chrono::steady_clock::duration total{};
+        std::chrono::steady_clock::duration self{};
+    };
+    // the phases of a thread are nested, the self time of a phase is its duration minus the duration of its children
+    std::vector<const traceEventStr*> sortedEvents;
+    for (const auto& event : events) {
+        sortedEvents.push_back(&event);
+    }
+    std::sort(sortedEvents.begin(), sortedEvents.end(), [](const traceEventStr* a, const traceEventStr* b) {
+        if (a->thread != b->thread) {
+            return a->thread < b->thread;
+        }
+        if (a->start != b->start) {
+            return a->start < b->start;
+        }
+        return a->duration > b->duration;
+    });
+    std::map<const traceEventStr*, std::chrono::steady_clock::duration> childrenTime;
+    std::vector<const traceEventStr*> openEvents;
+    for (const traceEventStr* event : sortedEvents) {
+        while (!openEvents.empty() && (openEvents.back()->thread != event->thread || openEvents.back()->start + openEvents.back()->duration <= event->start)) {
+            openEvents.pop_back();
+        }
+        if (!openEvents.empty()) {
+            childrenTime[openEvents.back()] += event->duration;
+        }
+        openEvents.push_back(event);
+    }
+    std::map<std::string, phaseSummaryStr> phases;
+    for (const auto& event : events) {
+        phaseSummaryStr& phase = phases[event.name];
+        phase.calls++;
+        phase.total += event.duration;
+        phase.self += event.duration - childrenTime[&event];
+    }
+    std::vector<std::pair<std::string, phaseSummaryStr>> sortedPhases(phases.begin(), phases.end());
+    std::sort(sortedPhases.begin(), sortedPhases.end(), [](const auto& a, const auto& b) { return a.second.self > b.second.self; });
+    sortedPhases.resize(std::min(sortedPhases.size(), topCount));
+
+    auto milliseconds = [](std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    };
+    std::ostream& out = output_stream();
+    out << "-----------" << std::endl;
+    out << "Profile: top " << sortedPhases.size() << " phases by self time" << std::endl;
+    out << std::left << std::setw(24) << "phase" << std::right << std::setw(10) << "calls" << std::setw(12) << "self ms" << std::setw(12) << "total ms" << std::endl;
+    out << std::fixed << std::setprecision(3);
+    for (const auto& [name, phase] : sortedPhases) {
+        out << std::left << std::setw(24) << name << std::right << std::setw(10) << phase.calls << std::setw(12) << milliseconds(phase.self)
+            << std::setw(12) << milliseconds(phase.total) << std::endl;
+    }
+    out << std::defaultfloat;
+    for (const auto& [counter, value] : counters) {
+        out << counter << ": " << value << std::endl;
+    }
+}
+/** @} */ // end of Profile group
@@ -10,25 +10,42 @@
  */
 #include "Replacer.h"
 #include "Data.h"
+#include "EmbeddedTemplates.h"
 #include <filesystem>
+#include <cctype>
+#include <mutex>
 
 
 /**
  * @brief Get the Event Data from the model and interface files 
  * 
  * @param fileData file data structure passed by reference from which the event data is extracted
- * @param eventData event data structure passed by reference where the event data is stored
+ * @param hlModel High-Level SCXML model shared by all the events, loaded by the first event missing from the cache
+ * @param eventCache cached events of the skill passed by reference, the resolved events are added to it
+ * @param eventData event data structure of the event, moved to eventsMap once resolved
+ * @param eventsMap events of the skill passed by reference where the event data is stored
  */
-bool getEventData(fileDataStr fileData, eventDataStr& eventData)
+bool getEventData(const fileDataStr& fileData, hlModelDataStr& hlModel, eventCacheStr& eventCache, eventDataStr& eventData, std::map<std::string, eventDataStr>& eventsMap)
 {
-    if(eventsMap.find(eventData.event) != eventsMap.end()){
-        add_to_log("Event already processed: " + eventData.event);
+    auto [itEvent, inserted] = eventsMap.try_emplace(eventData.event);
+    if(!inserted){
+        LOG_DEBUG("Event already processed: " << eventData.event);
         return true;
     } 
-    add_to_log("Processing event: " + eventData.event);
-    eventsMap[eventData.event];
+    LOG_DEBUG("Processing event: " << eventData.event);
+    TRACE_PHASE_DETAIL("getEventData", eventData.event);
+    TRACE_COUNTER("events processed", 1);
 
-    if(eventData.event != cmdTick && eventData.event != cmdHalt && eventData.event != rspTick && eventData.event != rspHalt)
+    auto cached = eventCache.entries.find(eventData.event);
+    if(cached != eventCache.entries.end())
+    {
+        // the messages of the resolution are written again, so that a cached run prints the same errors
+        LOG_DEBUG("Event data read from the cache: " << eventData.event);
+        TRACE_COUNTER("events cached", 1);
+        error_stream() << cached->second.errors;
+        eventData = cached->second.eventData;
+    }
+    else if(eventData.event != cmdTick && eventData.event != cmdHalt && eventData.event != rspTick && eventData.event != rspHalt)
     {
         getDataFromEvent(eventData);
         
@@ -38,10 +55,36 @@ bool getEventData(fileDataStr fileData, eventDataStr& eventData)
         eventData.serverName = "\"/"+ eventData.componentName +"/" + eventData.functionName + "\"";
 
 
+        if(!hlModel.root && !loadHLModel(fileData.inputFileName, hlModel))
+        {
+            return false;
+        }
         // need to extract the interface name and type from the model file
-        if(!extractInterfaceData(fileData, eventData))
+        bool extracted;
+        if(eventCache.filePath.empty())
         {
-            std::cerr << "Error extracting interface data for event: " << eventData.event << std::endl;
+            extracted = extractInterfaceData(fileData, hlModel, eventData);
+        }
+        else
+        {
+            // the messages of the resolution are kept with the cached event
+            generationContextStr& context = get_generation_context();
+            generationContextStr resolutionContext;
+            resolutionContext.buffered = true;
+            resolutionContext.trace = context.trace;
+            set_generation_context(&resolutionContext);
+            extracted = extractInterfaceData(fileData, hlModel, eventData);
+            set_generation_context(&context);
+            merge_generation_context(resolutionContext);
+            if(extracted)
+            {
+                eventCache.entries[eventData.event] = {eventData, resolutionContext.errors.str()};
+                eventCache.modified = true;
+            }
+        }
+        if(!extracted)
+        {
+            error_stream() << "Error extracting interface data for event: " << eventData.event << std::endl;
             return false;
         } 
 
@@ -60,7 +103,7 @@ bool getEventData(fileDataStr fileData, eventDataStr& eventData)
         //     return false;
         // }        
     }
-    eventsMap[eventData.event] = eventData;
+    itEvent->second = std::move(eventData);
     return true;
 }
 
@@ -68,10 +111,13 @@ bool getEventData(fileDataStr fileData, eventDataStr& eventData)
  * @brief Get the Event Data from the vector of event elements
  * 
  * @param fileData file data structure passed by reference where the file data is stored
+ * @param hlModel High-Level SCXML model shared by all the events, loaded by the first event missing from the cache
+ * @param eventCache cached events of the skill passed by reference, the resolved events are added to it
  * @param elementsTransition vector of transition event elements
  * @param elementsSend vector of send event elements
+ * @param eventsMap events of the skill passed by reference where the event data is stored
  */
-bool getEventsVecData(fileDataStr fileData, const std::vector<tinyxml2::XMLElement*> elementsTransition, const std::vector<tinyxml2::XMLElement*> elementsSend)
+bool getEventsVecData(const fileDataStr& fileData, hlModelDataStr& hlModel, eventCacheStr& eventCache, const std::vector<tinyxml2::XMLElement*>& elementsTransition, const std::vector<tinyxml2::XMLElement*>& elementsSend, std::map<std::string, eventDataStr>& eventsMap)
 {
     for (const auto& element : elementsTransition) {
         const char* event = element->Attribute("event");
@@ -80,19 +126,19 @@ bool getEventsVecData(fileDataStr fileData, const std::vector<tinyxml2::XMLEleme
         if (event && target) 
         {
 
-            add_to_log("Transition: event=" + std::string(event) + ", target=" + std::string(target));
+            LOG_DEBUG("Transition: event=" << event << ", target=" << target);
             eventDataStr eventData;
             eventData.target = target;
             eventData.event = event;
             eventData.eventType = "transition";
-            if(!getEventData(fileData, eventData))
+            if(!getEventData(fileData, hlModel, eventCache, eventData, eventsMap))
             {
                 return false;
             }
         } 
         else
         {
-            std::cerr << "\tMissing attribute in <transition> tag" << std::endl;
+            error_stream() << "\tMissing attribute in <transition> tag" << std::endl;
         }
     }
     for (const auto& element : elementsSend) {
@@ -100,7 +146,7 @@ bool getEventsVecData(fileDataStr fileData, const std::vector<tinyxml2::XMLEleme
 
         if (event) 
         {
-            add_to_log("Send: event=" + std::string(event));
+            LOG_DEBUG("Send: event=" << event);
             eventDataStr eventData;
             eventData.event = event;
             eventData.eventType = "send";
@@ -111,15 +157,15 @@ bool getEventsVecData(fileDataStr fileData, const std::vector<tinyxml2::XMLEleme
                 getElementAttValue(element, "name", paramName);
                 getElementAttValue(element, "expr", paramExpr);
                 eventData.paramMap[paramName] = paramExpr;
-                add_to_log("\tparamName=" + paramName + ", paramExpr=" + eventData.paramMap[paramName]);
+                LOG_DEBUG("\tparamName=" << paramName << ", paramExpr=" << eventData.paramMap[paramName]);
             }
-            if(!getEventData(fileData, eventData))
+            if(!getEventData(fileData, hlModel, eventCache, eventData, eventsMap))
             {
                 return false;
             }
         } 
         else{
-            std::cerr << "\tMissing attribute in <send> tag" << std::endl;
+            error_stream() << "\tMissing attribute in <send> tag" << std::endl;
         }
     }
     return true;
@@ -129,135 +175,230 @@ bool getEventsVecData(fileDataStr fileData, const std::vector<tinyxml2::XMLEleme
 /**
  * @brief function to keep or delete the sections of the code related to the Command Tick event
  * 
- * @param code string of code to be modified
+ * @param context template context where the sections to keep or delete are stored
  * @param keepFlag flag to keep or delete the sections
  */
-void handleCmdTickEvent(std::string& code,const bool keepFlag)
+void handleCmdTickEvent(templateContextStr& context, const bool keepFlag)
 {
-    if(keepFlag){
-        keepSection(code, "/*TICK_CMD*/", "/*END_TICK_CMD*/");
-        keepSection(code, "/*TICK*/", "/*END_TICK*/");
-        keepSection(code, "#TICK#", "#END_TICK#");
-        keepSection(code, "<!--TICK-->", "<!--END_TICK-->");
-    } else{
-        deleteSection(code, "/*TICK_CMD*/", "/*END_TICK_CMD*/");
-        deleteSection(code, "/*TICK*/", "/*END_TICK*/");
-        deleteSection(code, "#TICK#", "#END_TICK#");
-        deleteSection(code, "<!--TICK-->", "<!--END_TICK-->");
+    for (const auto& marker : {"/*TICK_CMD*/", "/*TICK*/", "#TICK#", "<!--TICK-->"}) {
+        context.sections[marker] = keepFlag;
     }
 }
 
 /**
  * @brief function to keep or delete the sections of the code related to the Command Halt event
  * 
- * @param code string of code to be modified
+ * @param context template context where the sections to keep or delete are stored
  * @param keepFlag flag to keep or delete the sections
  */
-void handleCmdHaltEvent(std::string& code,const bool keepFlag)
+void handleCmdHaltEvent(templateContextStr& context, const bool keepFlag)
 {
-    if(keepFlag){
-        keepSection(code, "/*HALT_CMD*/", "/*END_HALT_CMD*/");
-        keepSection(code, "/*HALT*/", "/*END_HALT*/");
-        keepSection(code, "#HALT#", "#END_HALT#");
-        keepSection(code, "<!--HALT-->", "<!--END_HALT-->");
-    } else{
-        deleteSection(code, "/*HALT_CMD*/", "/*END_HALT_CMD*/");
-        deleteSection(code, "/*HALT*/", "/*END_HALT*/");
-        deleteSection(code, "#HALT#", "#END_HALT#");
-        deleteSection(code, "<!--HALT-->", "<!--END_HALT-->");
+    for (const auto& marker : {"/*HALT_CMD*/", "/*HALT*/", "#HALT#", "<!--HALT-->"}) {
+        context.sections[marker] = keepFlag;
     }
 }
 
 /**
  * @brief function to keep or delete the sections of the code related to the Response Tick event
  * 
- * @param code string of code to be modified
+ * @param context template context where the sections to keep or delete are stored
  * @param keepFlag flag to keep or delete the sections
  */
-void handleRspTickEvent(std::string& code,const bool keepFlag)
+void handleRspTickEvent(templateContextStr& context, const bool keepFlag)
 {
-    if(keepFlag){
-        keepSection(code, "/*TICK_RESPONSE*/", "/*END_TICK_RESPONSE*/");
-        keepSection(code, "#TICK_RESPONSE#", "#END_TICK_RESPONSE#");
-        keepSection(code, "<!--TICK_RESPONSE-->", "<!--END_TICK_RESPONSE-->");
-    } else{
-        deleteSection(code, "/*TICK_RESPONSE*/", "/*END_TICK_RESPONSE*/");
-        deleteSection(code, "#TICK_RESPONSE#", "#END_TICK_RESPONSE#");
-        deleteSection(code, "<!--TICK_RESPONSE-->", "<!--END_TICK_RESPONSE-->");
-    } 
+    for (const auto& marker : {"/*TICK_RESPONSE*/", "#TICK_RESPONSE#", "<!--TICK_RESPONSE-->"}) {
+        context.sections[marker] = keepFlag;
+    }
 }
 
 /**
  * @brief function to keep or delete the sections of the code related to the Response Halt event
  * 
- * @param code string of code to be modified
+ * @param context template context where the sections to keep or delete are stored
  * @param keepFlag flag to keep or delete the sections
  */
-void handleRspHaltEvent(std::string& code,const bool keepFlag)
+void handleRspHaltEvent(templateContextStr& context, const bool keepFlag)
 {
-    if(keepFlag){
-        keepSection(code, "/*HALT_RESPONSE*/", "/*END_HALT_RESPONSE*/");
-        keepSection(code, "#HALT_RESPONSE#", "#END_HALT_RESPONSE#");
-        keepSection(code, "<!--HALT_RESPONSE-->", "<!--END_HALT_RESPONSE-->");
-    } else{
-        deleteSection(code, "/*HALT_RESPONSE*/", "/*END_HALT_RESPONSE*/");
-        deleteSection(code, "#HALT_RESPONSE#", "#END_HALT_RESPONSE#");
-        deleteSection(code, "<!--HALT_RESPONSE-->", "<!--END_HALT_RESPONSE-->");
-    } 
+    for (const auto& marker : {"/*HALT_RESPONSE*/", "#HALT_RESPONSE#", "<!--HALT_RESPONSE-->"}) {
+        context.sections[marker] = keepFlag;
+    }
 }
 
 /**
- * @brief function that event placeholders in the code
+ * @brief function that sets the common event placeholders of a fragment
  * 
- * @param code string of code to be modified
+ * @param fragment fragment where the placeholder values are stored
  * @param eventData event data structure containing event information
  */
-void replaceCommonEventPlaceholders(std::string& code, const eventDataStr& eventData) {
-    replaceAll(code, "$eventData.event$", eventData.event);
-    replaceAll(code, "$eventData.componentName$", eventData.componentName);
-    replaceAll(code, "$eventData.functionName$", eventData.functionName);
-    replaceAll(code, "$eventData.serviceTypeName$", eventData.serviceTypeName);
-    replaceAll(code, "$eventData.serviceTypeNameSnakeCase$", eventData.serviceTypeNameSnakeCase);
-    replaceAll(code, "$eventData.nodeName$", eventData.nodeName);
-    replaceAll(code, "$eventData.serverName$", eventData.serverName);
-    replaceAll(code, "$eventData.clientName$", eventData.clientName);
-    replaceAll(code, "$eventData.interfaceName$", eventData.interfaceName);
-    replaceAll(code, "$eventData.topicName$", eventData.topicName);
+void setCommonEventValues(templateFragmentStr& fragment, const eventDataStr& eventData) {
+    fragment.values["$eventData.event$"] = eventData.event;
+    fragment.values["$eventData.componentName$"] = eventData.componentName;
+    fragment.values["$eventData.functionName$"] = eventData.functionName;
+    fragment.values["$eventData.serviceTypeName$"] = eventData.serviceTypeName;
+    fragment.values["$eventData.serviceTypeNameSnakeCase$"] = eventData.serviceTypeNameSnakeCase;
+    fragment.values["$eventData.nodeName$"] = eventData.nodeName;
+    fragment.values["$eventData.serverName$"] = eventData.serverName;
+    fragment.values["$eventData.clientName$"] = eventData.clientName;
+    fragment.values["$eventData.interfaceName$"] = eventData.interfaceName;
+    fragment.values["$eventData.topicName$"] = eventData.topicName;
+}
+
+/**
+ * @brief function that adds an interface to the dependencies of the skill, if it is not already there
+ * 
+ * @param dependencies dependencies of the skill
+ * @param interfaceName interface package name
+ */
+void addInterfaceDependency(interfaceDependenciesStr& dependencies, const std::string& interfaceName)
+{
+    if(dependencies.index.insert(interfaceName).second){
+        dependencies.names.push_back(interfaceName);
+    }
+}
+
+/**
+ * @brief function that collects the interfaces already declared by a template in the form of a dependency snippet
+ * 
+ * The snippet is split around $interfaceName$: the interface package names (identifiers) found in the literal text of
+ * the template between the literal text before and after it, without its surrounding whitespace, are collected. The
+ * template is scanned once, whatever the number of dependencies.
+ * 
+ * @param literals literal text of the template, see getTemplateLiterals
+ * @param snippet dependency snippet section (e.g. find_package($interfaceName$ REQUIRED))
+ * @param declared interfaces declared by the template returned by reference
+ */
+static void getDeclaredInterfaces(const std::vector<std::string_view>& literals, const templateNodeStr& snippet, std::set<std::string, std::less<>>& declared)
+{
+    std::string prefix, suffix;
+    bool placeholderFound = false;
+    for (const auto& node : snippet.children) {
+        if (node.type == templateNodeType::placeholder && node.text == "$interfaceName$" && !placeholderFound) {
+            placeholderFound = true;
+        }
+        else if (node.type == templateNodeType::literal) {
+            (placeholderFound ? suffix : prefix) += node.text;
+        }
+        else {
+            // not a single interface name between literal text, nothing is considered as declared
+            return;
+        }
+    }
+    if (!placeholderFound) {
+        return;
+    }
+    // the whitespace around the snippet text depends on where it is written, e.g. at the start of a line
+    auto trim = [](std::string_view text) {
+        size_t first = text.find_first_not_of(" \t\r\n");
+        return first == std::string_view::npos ? std::string_view() : text.substr(first, text.find_last_not_of(" \t\r\n") - first + 1);
+    };
+    auto isNameChar = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+    std::string_view before = trim(prefix);
+    std::string_view after = trim(suffix);
+    auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; };
+    for (const auto& literal : literals) {
+        for (size_t pos = literal.find(before); pos != std::string_view::npos; pos = literal.find(before, pos + 1)) {
+            size_t start = pos + before.size();
+            while (start < literal.size() && isSpace(literal[start])) {
+                start++;
+            }
+            // without text around the name, the name is a whole word
+            if (before.empty() && start > 0 && !isSpace(literal[start - 1])) {
+                continue;
+            }
+            size_t end = start;
+            while (end < literal.size() && isNameChar(literal[end])) {
+                end++;
+            }
+            size_t next = end;
+            while (next < literal.size() && isSpace(literal[next])) {
+                next++;
+            }
+            if (end == start || (after.empty() && next == end && end < literal.size())) {
+                continue;
+            }
+            if (literal.compare(next, after.size(), after) == 0) {
+                declared.emplace(literal.substr(start, end - start));
+            }
+        }
+    }
 }
 
+/**
+ * @brief function that writes the dependency code of the interfaces in the CMakeLists.txt and package.xml slots
+ * 
+ * The interfaces already declared by the template (e.g. std_msgs) are not written again.
+ * 
+ * @param dependencies dependencies of the skill
+ * @param savedCode saved code structure containing the saved code to be written
+ * @param document document fragment to be modified
+ * @param context template context
+ */
+void writeInterfaceDependencies(const interfaceDependenciesStr& dependencies, const savedCodeStr& savedCode, templateFragmentStr& document, const templateContextStr& context)
+{
+    static const std::vector<std::pair<std::string, const templateNodeStr* savedCodeStr::*>> dependencySlots = {
+        //CMakeLists.txt
+        {"#INTERFACE_LIST#", &savedCodeStr::interfaceCMake},
+        {"#PACKAGE_LIST#", &savedCodeStr::packageCMake},
+        //package.xml
+        {"<!--INTERFACE_LIST-->", &savedCodeStr::interfaceXML},
+    };
+    if(dependencies.names.empty()){
+        return;
+    }
+    // the literal text of the template is collected once for all the slots
+    std::vector<std::string_view> literals;
+    bool collected = false;
+    for (const auto& [slotMarker, field] : dependencySlots) {
+        if(!(savedCode.*field) || !hasSlot(document, slotMarker, context)){
+            continue;
+        }
+        if(!collected){
+            getTemplateLiterals(document, context, literals);
+            collected = true;
+        }
+        std::set<std::string, std::less<>> declared;
+        getDeclaredInterfaces(literals, *(savedCode.*field), declared);
+        for (const auto& interfaceName : dependencies.names) {
+            if(declared.count(interfaceName)){
+                continue;
+            }
+            templateFragmentStr dependencyCode = makeTemplateFragment(savedCode.*field);
+            dependencyCode.values["$interfaceName$"] = interfaceName;
+            writeToSlot(document, slotMarker, dependencyCode, context);
+        }
+    }
+}
 
 /**
- * @brief function to write the generic event code in the output string
+ * @brief function to write the generic event code in the document
  * 
  * @param eventData event data structure containing event information
  * @param savedCode saved code structure containing the saved code to be written
- * @param str output string to be modified
+ * @param document document fragment to be modified
+ * @param context template context
+ * @param dependencies dependencies of the skill where the interface of the event is added, written by writeInterfaceDependencies
  */
-void handleGenericEvent(const eventDataStr eventData, const savedCodeStr savedCode, std::string& str)
+void handleGenericEvent(const eventDataStr& eventData, const savedCodeStr& savedCode, templateFragmentStr& document, const templateContextStr& context, interfaceDependenciesStr& dependencies)
 {
     printEventData(eventData);
     if(eventData.eventType == "send"){
-        std::string interfaceCodeH = savedCode.interfaceH;
-        std::string actionInterfaceH = savedCode.actionInterfaceH;
-        std::string interfaceCodeCMake = savedCode.interfaceCMake;
-        std::string packageCodeCMake = savedCode.packageCMake;
-        std::string interfaceCodeXML = savedCode.interfaceXML;
         if(eventData.interfaceType == "async-service" || eventData.interfaceType == "sync-service")
         {
-            std::string eventCodeC = savedCode.eventC;
+            templateFragmentStr eventCodeC = makeTemplateFragment(savedCode.eventC);
             //CPP
-            replaceCommonEventPlaceholders(eventCodeC, eventData);
+            setCommonEventValues(eventCodeC, eventData);
             for (auto itParam =  eventData.paramMap.begin(); itParam != eventData.paramMap.end(); ++itParam) 
             {
-                std::string paramCode = savedCode.sendParam;
-                replaceAll(paramCode, "$IT->FIRST$", itParam->first);
-                writeAfterCommand(eventCodeC, "/*PARAM_LIST*/", paramCode);
+                templateFragmentStr paramCode = makeTemplateFragment(savedCode.sendParam);
+                paramCode.values["$IT->FIRST$"] = itParam->first;
+                writeToSlot(eventCodeC, "/*PARAM_LIST*/", paramCode, context);
             }
 
             // Process response fields using the mapping to datamodel variables
             for (auto responseField : eventData.interfaceResponseFields) 
             {
-                std::string paramCode = savedCode.returnParam;
+                // the field access replaces a whole expression of the snippet, so the snippet is rendered to text first
+                std::string paramCode = renderTemplate(makeTemplateFragment(savedCode.returnParam), context, true);
                 
                 // Use the response field name directly
                 std::string fieldName = responseField;
@@ -270,7 +411,7 @@ void handleGenericEvent(const eventDataStr eventData, const savedCodeStr savedCo
                 } else {
                     // Fallback to the old logic if mapping is not found
                     datamodelVar = "m_" + fieldName;
-                    std::cerr << "Warning: No mapping found for response field '" << responseField << "', using fallback '" << datamodelVar << "'" << std::endl;
+                    LOG_WARNING("No mapping found for response field '" << responseField << "', using fallback '" << datamodelVar << "'");
                 }
 
                 // Get the type from interfaceData using the datamodel variable name
@@ -278,7 +419,7 @@ void handleGenericEvent(const eventDataStr eventData, const savedCodeStr savedCo
                 auto pos = eventData.interfaceData.find(datamodelVar);
 
                 if (pos == eventData.interfaceData.end()) {
-                    std::cerr << "Warning: Datamodel variable '" << datamodelVar << "' not found in interface data fields. No type info is available. Using default string" << std::endl;
+                    LOG_WARNING("Datamodel variable '" << datamodelVar << "' not found in interface data fields. No type info is available. Using default string");
                 }
                 else {
                     fieldType = pos->second;
@@ -292,12 +433,10 @@ void handleGenericEvent(const eventDataStr eventData, const savedCodeStr savedCo
                     fieldAccess = "response->" + fieldName;
                 }
 
-                // Replace both placeholders - first the field access, then the field name
-                // We need to replace in a specific order to avoid conflicts
-                replaceAll(paramCode, "response->$eventData.interfaceDataField$", fieldAccess);
-                replaceAll(paramCode, "$eventData.interfaceDataField$", fieldName);
+                // Replace both placeholders in one pass, the field access is the longest match where both apply
+                replaceMany(paramCode, {{"response->$eventData.interfaceDataField$", fieldAccess}, {"$eventData.interfaceDataField$", fieldName}});
                 
-                writeAfterCommand(eventCodeC, "/*RETURN_PARAM_LIST*/", paramCode);
+                writeToSlot(eventCodeC, "/*RETURN_PARAM_LIST*/", makeTemplateFragment(paramCode), context);
             }
             // if(eventData.rosInterfaceType == "service-server")
             // {
@@ -307,40 +446,28 @@ void handleGenericEvent(const eventDataStr eventData, const savedCodeStr savedCo
             
             for (auto itParam = eventData.interfaceRequestFields.begin(); itParam != eventData.interfaceRequestFields.end(); ++itParam) 
             {
-                std::string paramCode = savedCode.returnParam;
-                replaceAll(paramCode, "$eventData.interfaceDataField$", *itParam);
-                writeAfterCommand(eventCodeC, "/*SEND_PARAM_LIST*/", paramCode);
+                templateFragmentStr paramCode = makeTemplateFragment(savedCode.returnParam);
+                paramCode.values["$eventData.interfaceDataField$"] = *itParam;
+                writeToSlot(eventCodeC, "/*SEND_PARAM_LIST*/", paramCode, context);
             }
             // }
 
 
-            writeAfterCommand(str, "/*SEND_EVENT_LIST*/", eventCodeC);
+            writeToSlot(document, "/*SEND_EVENT_LIST*/", eventCodeC, context);
             
             // Service client header code
-            std::string serviceClientH = savedCode.serviceClientH;
-            replaceCommonEventPlaceholders(serviceClientH, eventData);
-            writeAfterCommand(str, "/*SERVICE_CLIENTS_LIST*/", serviceClientH);
+            templateFragmentStr serviceClientH = makeTemplateFragment(savedCode.serviceClientH);
+            setCommonEventValues(serviceClientH, eventData);
+            writeToSlot(document, "/*SERVICE_CLIENTS_LIST*/", serviceClientH, context);
             
             //H
-            replaceAll(interfaceCodeH, "$eventData.interfaceName$", eventData.interfaceName);
-            replaceAll(interfaceCodeH, "$eventData.functionNameSnakeCase$", eventData.functionNameSnakeCase);
-            writeAfterCommand(str, "/*INTERFACES_LIST*/", interfaceCodeH);
+            templateFragmentStr interfaceCodeH = makeTemplateFragment(savedCode.interfaceH);
+            interfaceCodeH.values["$eventData.interfaceName$"] = eventData.interfaceName;
+            interfaceCodeH.values["$eventData.functionNameSnakeCase$"] = eventData.functionNameSnakeCase;
+            writeToSlot(document, "/*INTERFACES_LIST*/", interfaceCodeH, context);
             
-            //CMakeLists.txt
-            replaceAll(interfaceCodeCMake, "$interfaceName$", eventData.interfaceName);
-            if(!checkIfStrPresent(str, interfaceCodeCMake)){
-                writeAfterCommand(str, "#INTERFACE_LIST#", interfaceCodeCMake);
-            }
-            replaceAll(packageCodeCMake, "$interfaceName$", eventData.interfaceName);
-            if(!checkIfStrPresent(str, packageCodeCMake)){
-                writeAfterCommand(str, "#PACKAGE_LIST#", packageCodeCMake);
-            }
-
-            //package.xml
-            replaceAll(interfaceCodeXML, "$interfaceName$", eventData.interfaceName);
-            if(!checkIfStrPresent(str, interfaceCodeXML)){
-                writeAfterCommand(str, "<!--INTERFACE_LIST-->", interfaceCodeXML);
-            }
+            //CMakeLists.txt and package.xml
+            addInterfaceDependency(dependencies, eventData.interfaceName);
 
         }
         else if(eventData.interfaceType == "action")
@@ -349,47 +476,36 @@ void handleGenericEvent(const eventDataStr eventData, const savedCodeStr savedCo
             //If event is Send Cancel replace tags in savedCode.actionSendCancelLambda
             std::string eventSendGoal = "SendGoal";
             if (std::string(eventData.eventName).find(eventSendGoal) != std::string::npos) {
-                std::string actionSendGoalLambda = savedCode.actionSendGoalLambda;
-                replaceCommonEventPlaceholders(actionSendGoalLambda, eventData);
-                writeAfterCommand(str, "/*ACTION_LAMBDA_LIST*/", actionSendGoalLambda);
+                templateFragmentStr actionSendGoalLambda = makeTemplateFragment(savedCode.actionSendGoalLambda);
+                setCommonEventValues(actionSendGoalLambda, eventData);
+                writeToSlot(document, "/*ACTION_LAMBDA_LIST*/", actionSendGoalLambda, context);
 
-                std::string actionSendGoalFnc = savedCode.actionSendGoalFnc;
-                replaceCommonEventPlaceholders(actionSendGoalFnc, eventData);
-                writeAfterCommand(str, "/*ACTION_FNC_LIST*/", actionSendGoalFnc);
+                templateFragmentStr actionSendGoalFnc = makeTemplateFragment(savedCode.actionSendGoalFnc);
+                setCommonEventValues(actionSendGoalFnc, eventData);
+                writeToSlot(document, "/*ACTION_FNC_LIST*/", actionSendGoalFnc, context);
 
-                std::string actionCodeH = savedCode.actionH;
-                replaceCommonEventPlaceholders(actionCodeH, eventData);
-                writeAfterCommand(str, "/*ACTION_LIST_H*/", actionCodeH);
+                templateFragmentStr actionCodeH = makeTemplateFragment(savedCode.actionH);
+                setCommonEventValues(actionCodeH, eventData);
+                writeToSlot(document, "/*ACTION_LIST_H*/", actionCodeH, context);
 
-                std::string actionCodeC = savedCode.actionC;
-                replaceCommonEventPlaceholders(actionCodeC, eventData);
-                writeAfterCommand(str, "/*ACTION_LIST_C*/", actionCodeC);
+                templateFragmentStr actionCodeC = makeTemplateFragment(savedCode.actionC);
+                setCommonEventValues(actionCodeC, eventData);
+                writeToSlot(document, "/*ACTION_LIST_C*/", actionCodeC, context);
 
                 //H
-                replaceAll(actionInterfaceH, "$eventData.interfaceName$", eventData.interfaceName);
-                replaceAll(actionInterfaceH, "$eventData.functionNameSnakeCase$", eventData.functionNameSnakeCase);
-                writeAfterCommand(str, "/*INTERFACES_LIST*/", actionInterfaceH);
-                //CMakeLists.txt
-                replaceAll(interfaceCodeCMake, "$interfaceName$", eventData.interfaceName);
-                if(!checkIfStrPresent(str, interfaceCodeCMake)){
-                    writeAfterCommand(str, "#INTERFACE_LIST#", interfaceCodeCMake);
-                }
-                replaceAll(packageCodeCMake, "$interfaceName$", eventData.interfaceName);
-                if(!checkIfStrPresent(str, packageCodeCMake)){
-                    writeAfterCommand(str, "#PACKAGE_LIST#", packageCodeCMake);
-                }
+                templateFragmentStr actionInterfaceH = makeTemplateFragment(savedCode.actionInterfaceH);
+                actionInterfaceH.values["$eventData.interfaceName$"] = eventData.interfaceName;
+                actionInterfaceH.values["$eventData.functionNameSnakeCase$"] = eventData.functionNameSnakeCase;
+                writeToSlot(document, "/*INTERFACES_LIST*/", actionInterfaceH, context);
 
-                //package.xml
-                replaceAll(interfaceCodeXML, "$interfaceName$", eventData.interfaceName);
-                if(!checkIfStrPresent(str, interfaceCodeXML)){
-                    writeAfterCommand(str, "<!--INTERFACE_LIST-->", interfaceCodeXML);
-                }
+                //CMakeLists.txt and package.xml
+                addInterfaceDependency(dependencies, eventData.interfaceName);
 
                 for (auto itParam =  eventData.paramMap.begin(); itParam != eventData.paramMap.end(); ++itParam) 
                 {
-                    std::string paramCode = savedCode.actionSendParam;
-                    replaceAll(paramCode, "$IT->FIRST$", itParam->first);
-                    writeAfterCommand(str, "/*SEND_PARAM_LIST*/", paramCode);
+                    templateFragmentStr paramCode = makeTemplateFragment(savedCode.actionSendParam);
+                    paramCode.values["$IT->FIRST$"] = itParam->first;
+                    writeToSlot(document, "/*SEND_PARAM_LIST*/", paramCode, context);
                 }
                 
             }
@@ -403,101 +519,49 @@ void handleGenericEvent(const eventDataStr eventData, const savedCodeStr savedCo
         }
         if(eventData.interfaceType == "topic")
         {
-            std::string topicCallbackC = savedCode.topicCallbackC;
-            std::string topicCallbackH = savedCode.topicCallbackH;
-            std::string topicSubscriptionC = savedCode.topicSubscriptionC;
-            std::string topicSubscriptionH = savedCode.topicSubscriptionH;
-            std::string topicInterfaceH = savedCode.topicInterfaceH;
-            std::string interfaceCodeH = savedCode.interfaceH;
-            std::string interfaceCodeCMake = savedCode.interfaceCMake;
-            std::string packageCodeCMake = savedCode.packageCMake;
-            std::string interfaceCodeXML = savedCode.interfaceXML;
+            std::string messageName = eventData.messageInterfaceType.substr(eventData.messageInterfaceType.find_last_of("/") + 1);
             //CPP
+            templateFragmentStr topicSubscriptionC = makeTemplateFragment(savedCode.topicSubscriptionC);
+            topicSubscriptionC.values["$eventData.interfaceName$"] = eventData.interfaceName;
+            topicSubscriptionC.values["$eventData.messageNameSnakeCase$"] = messageName;
+            topicSubscriptionC.values["$eventData.functionName$"] = eventData.functionName;
+            topicSubscriptionC.values["$eventData.topicName$"] = eventData.topicName;
+            templateFragmentStr topicCallbackC = makeTemplateFragment(savedCode.topicCallbackC);
+            topicCallbackC.values["$eventData.interfaceName$"] = eventData.interfaceName;
+            topicCallbackC.values["$eventData.messageNameSnakeCase$"] = messageName;
+            topicCallbackC.values["$eventData.functionName$"] = eventData.functionName;
+            topicCallbackC.values["$eventData.componentName$"] = eventData.componentName;
             // replaceAll(topicCallbackC, "$eventData.interfaceData[interfaceDataField]$", eventData.interfaceData.begin()->first);
             for(auto it = eventData.interfaceTopicFields.begin(); it != eventData.interfaceTopicFields.end(); ++it)
             {
-                std::string topicFieldCode = savedCode.topicParamList;
-                replaceAll(topicFieldCode, "$eventData.interfaceDataField$", *it);
-                writeAfterCommand(topicCallbackC, "/*TOPIC_PARAM_LIST*/", topicFieldCode);
+                // the topic fields are written before the callback placeholders are replaced, so they share the callback values
+                templateFragmentStr topicFieldCode = makeTemplateFragment(savedCode.topicParamList);
+                topicFieldCode.values = topicCallbackC.values;
+                topicFieldCode.values["$eventData.interfaceDataField$"] = *it;
+                writeToSlot(topicCallbackC, "/*TOPIC_PARAM_LIST*/", topicFieldCode, context);
             }
-            replaceAll(topicSubscriptionC, "$eventData.interfaceName$", eventData.interfaceName);
-            replaceAll(topicSubscriptionC, "$eventData.messageNameSnakeCase$", eventData.messageInterfaceType.substr(eventData.messageInterfaceType.find_last_of("/") + 1));
-            replaceAll(topicCallbackC, "$eventData.interfaceName$", eventData.interfaceName);
-            replaceAll(topicCallbackC, "$eventData.messageNameSnakeCase$", eventData.messageInterfaceType.substr(eventData.messageInterfaceType.find_last_of("/") + 1));
-            replaceAll(topicCallbackC, "$eventData.functionName$", eventData.functionName);
-            replaceAll(topicSubscriptionC, "$eventData.functionName$", eventData.functionName);
-            replaceAll(topicSubscriptionC, "$eventData.topicName$", eventData.topicName);
-            replaceAll(topicCallbackC, "$eventData.componentName$", eventData.componentName);
-            writeAfterCommand(str, "/*TOPIC_SUBSCRIPTIONS_LIST*/", topicSubscriptionC);
-            writeAfterCommand(str, "/*TOPIC_CALLBACK_LIST*/", topicCallbackC);
+            writeToSlot(document, "/*TOPIC_SUBSCRIPTIONS_LIST*/", topicSubscriptionC, context);
+            writeToSlot(document, "/*TOPIC_CALLBACK_LIST*/", topicCallbackC, context);
             //H
             std::string interface;
             getDataTypePath(eventData.interfaceName, interface);
-            replaceAll(topicInterfaceH, "$eventData.interfaceName$", eventData.interfaceName);
-            replaceAll(topicInterfaceH, "$eventData.messageNameSnakeCase$", turnToSnakeCase(eventData.messageInterfaceType.substr(eventData.messageInterfaceType.find_last_of("/") + 1)));
-            replaceAll(topicCallbackH, "$eventData.interfaceName$", eventData.interfaceName);
-            replaceAll(topicCallbackH, "$eventData.messageNameSnakeCase$", eventData.messageInterfaceType.substr(eventData.messageInterfaceType.find_last_of("/") + 1));
-            replaceAll(topicSubscriptionH, "$eventData.interfaceName$", eventData.interfaceName);
-            replaceAll(topicSubscriptionH, "$eventData.messageNameSnakeCase$", eventData.messageInterfaceType.substr(eventData.messageInterfaceType.find_last_of("/") + 1));
-            replaceAll(topicCallbackH, "$eventData.functionName$", eventData.functionName);
-            replaceAll(topicSubscriptionH, "$eventData.functionName$", eventData.functionName);
-            writeAfterCommand(str, "/*INTERFACES_LIST*/", topicInterfaceH);
-            writeAfterCommand(str, "/*TOPIC_SUBSCRIPTIONS_LIST_H*/", topicSubscriptionH);
-            writeAfterCommand(str, "/*TOPIC_CALLBACK_LIST_H*/", topicCallbackH);
-
-            //CMakeLists.txt
-            // printEventData(eventData);
-            // if (eventData.virtualInterface)
-            // {
-
-                // for(auto it =  eventData.interfaceData.begin(); it != eventData.interfaceData.end(); ++it)
-                // {
-                //     if (it->second.find("msg") != std::string::npos) 
-                //     {
-                //         std::string ros_package = it->second.substr(0, it->second.find("::msg::"));
-                //         add_to_log("ROS package: " + ros_package);
-                //         replaceAll(interfaceCodeCMake, "$interfaceName$", ros_package);
-                //         if(!checkIfStrPresent(str, interfaceCodeCMake)){
-                //             writeAfterCommand(str, "#INTERFACE_LIST#", interfaceCodeCMake);
-                //         }
-                //         replaceAll(packageCodeCMake, "$interfaceName$", ros_package);
-                //         if(!checkIfStrPresent(str, packageCodeCMake)){
-                //             writeAfterCommand(str, "#PACKAGE_LIST#", packageCodeCMake);
-                //         }
-                //     }
-                // }
-            // }
-            
-            //CMakeLists.txt
-            replaceAll(interfaceCodeCMake, "$interfaceName$", eventData.interfaceName);
-            if(!checkIfStrPresent(str, interfaceCodeCMake)){
-                writeAfterCommand(str, "#INTERFACE_LIST#", interfaceCodeCMake);
-            }
-
-            replaceAll(packageCodeCMake, "$interfaceName$", eventData.interfaceName);
-            if(!checkIfStrPresent(str, packageCodeCMake)){
-                writeAfterCommand(str, "#PACKAGE_LIST#", packageCodeCMake);
-            }
-
-            //package.xml
-            replaceAll(interfaceCodeXML, "$interfaceName$", eventData.interfaceName);
-            if(!checkIfStrPresent(str, interfaceCodeXML)){
-                writeAfterCommand(str, "<!--INTERFACE_LIST-->", interfaceCodeXML);
-            }
-            // replaceAll(interfaceCodeCMake, "$interfaceName$", eventData.interfaceName);
-            // if(!checkIfStrPresent(str, interfaceCodeCMake)){
-            //     writeAfterCommand(str, "#INTERFACE_LIST#", interfaceCodeCMake);
-            // }
-            // replaceAll(packageCodeCMake, "$interfaceName$", eventData.interfaceName);
-            // if(!checkIfStrPresent(str, packageCodeCMake)){
-            //     writeAfterCommand(str, "#PACKAGE_LIST#", packageCodeCMake);
-            // }
-
-            //package.xml
-            // replaceAll(interfaceCodeXML, "$interfaceName$", eventData.interfaceName);
-            // if(!checkIfStrPresent(str, interfaceCodeXML)){
-            //     writeAfterCommand(str, "<!--INTERFACE_LIST-->", interfaceCodeXML);
-            // }
+            templateFragmentStr topicInterfaceH = makeTemplateFragment(savedCode.topicInterfaceH);
+            topicInterfaceH.values["$eventData.interfaceName$"] = eventData.interfaceName;
+            topicInterfaceH.values["$eventData.messageNameSnakeCase$"] = turnToSnakeCase(messageName);
+            templateFragmentStr topicCallbackH = makeTemplateFragment(savedCode.topicCallbackH);
+            topicCallbackH.values["$eventData.interfaceName$"] = eventData.interfaceName;
+            topicCallbackH.values["$eventData.messageNameSnakeCase$"] = messageName;
+            topicCallbackH.values["$eventData.functionName$"] = eventData.functionName;
+            templateFragmentStr topicSubscriptionH = makeTemplateFragment(savedCode.topicSubscriptionH);
+            topicSubscriptionH.values["$eventData.interfaceName$"] = eventData.interfaceName;
+            topicSubscriptionH.values["$eventData.messageNameSnakeCase$"] = messageName;
+            topicSubscriptionH.values["$eventData.functionName$"] = eventData.functionName;
+            writeToSlot(document, "/*INTERFACES_LIST*/", topicInterfaceH, context);
+            writeToSlot(document, "/*TOPIC_SUBSCRIPTIONS_LIST_H*/", topicSubscriptionH, context);
+            writeToSlot(document, "/*TOPIC_CALLBACK_LIST_H*/", topicCallbackH, context);
+
+            //CMakeLists.txt and package.xml
+            addInterfaceDependency(dependencies, eventData.interfaceName);
         }
         else if(eventData.interfaceType == "action")
         {
@@ -509,49 +573,49 @@ void handleGenericEvent(const eventDataStr eventData, const savedCodeStr savedCo
             std::string eventResultResponse = "ResultResponse";
             if (std::string(eventData.eventName).find(eventFeedbackReturn) != std::string::npos)
             {
-                std::string actionFeedbackCallback = savedCode.actionFeedbackCallback;
-                replaceCommonEventPlaceholders(actionFeedbackCallback, eventData);
-                writeAfterCommand(str, "/*ACTION_FNC_LIST*/", actionFeedbackCallback);
+                templateFragmentStr actionFeedbackCallback = makeTemplateFragment(savedCode.actionFeedbackCallback);
+                setCommonEventValues(actionFeedbackCallback, eventData);
+                writeToSlot(document, "/*ACTION_FNC_LIST*/", actionFeedbackCallback, context);
 
-                std::string actionFeedbackLambda = savedCode.actionFeedbackLambda;
-                replaceCommonEventPlaceholders(actionFeedbackLambda, eventData);
-                writeAfterCommand(str, "/*ACTION_LAMBDA_LIST*/", actionFeedbackLambda);
+                templateFragmentStr actionFeedbackLambda = makeTemplateFragment(savedCode.actionFeedbackLambda);
+                setCommonEventValues(actionFeedbackLambda, eventData);
+                writeToSlot(document, "/*ACTION_LAMBDA_LIST*/", actionFeedbackLambda, context);
                 for (auto itParam =  eventData.interfaceData.begin(); itParam != eventData.interfaceData.end(); ++itParam) 
                 {
-                    std::string feedbackParamCode = savedCode.actionFeedbackParam;
-                    replaceAll(feedbackParamCode, "$eventData.interfaceDataField$", itParam->first);
-                    writeAfterCommand(str, "/*FEEDBACK_PARAM_LIST*/", feedbackParamCode);
+                    templateFragmentStr feedbackParamCode = makeTemplateFragment(savedCode.actionFeedbackParam);
+                    feedbackParamCode.values["$eventData.interfaceDataField$"] = itParam->first;
+                    writeToSlot(document, "/*FEEDBACK_PARAM_LIST*/", feedbackParamCode, context);
                 }
                 for (auto itParam =  eventData.interfaceData.begin(); itParam != eventData.interfaceData.end(); ++itParam) 
                 {
-                    std::string feedbackParamCodeFnc = savedCode.actionFeedbackParamFnc;
-                    replaceAll(feedbackParamCodeFnc, "$eventData.interfaceDataField$", itParam->first);
-                    writeAfterCommand(str, "/*FEEDBACK_PARAM_LIST_FNC*/", feedbackParamCodeFnc);
+                    templateFragmentStr feedbackParamCodeFnc = makeTemplateFragment(savedCode.actionFeedbackParamFnc);
+                    feedbackParamCodeFnc.values["$eventData.interfaceDataField$"] = itParam->first;
+                    writeToSlot(document, "/*FEEDBACK_PARAM_LIST_FNC*/", feedbackParamCodeFnc, context);
                 }
                 for (auto itParam =  eventData.interfaceData.begin(); itParam != eventData.interfaceData.end(); ++itParam) 
                 {
-                    std::string feedbackData = savedCode.actionFeedbackData;
-                    replaceAll(feedbackData, "$eventData.interfaceDataField$", itParam->first);
-                    replaceAll(feedbackData, "$eventData.interfaceDataType$", itParam->second);
-                    writeAfterCommand(str, "/*FEEDBACK_DATA_LIST*/", feedbackData);
+                    templateFragmentStr feedbackData = makeTemplateFragment(savedCode.actionFeedbackData);
+                    feedbackData.values["$eventData.interfaceDataField$"] = itParam->first;
+                    feedbackData.values["$eventData.interfaceDataType$"] = itParam->second;
+                    writeToSlot(document, "/*FEEDBACK_DATA_LIST*/", feedbackData, context);
                 }
 
             }
             else if(std::string(eventData.eventName).find(eventGoalResponse) != std::string::npos)
             {
-                std::string actionGoalResponseFnc = savedCode.actionGoalResponseFnc;
-                replaceCommonEventPlaceholders(actionGoalResponseFnc, eventData);
-                writeAfterCommand(str, "/*ACTION_FNC_LIST*/", actionGoalResponseFnc);
+                templateFragmentStr actionGoalResponseFnc = makeTemplateFragment(savedCode.actionGoalResponseFnc);
+                setCommonEventValues(actionGoalResponseFnc, eventData);
+                writeToSlot(document, "/*ACTION_FNC_LIST*/", actionGoalResponseFnc, context);
             }
             else if(std::string(eventData.eventName).find(eventResultResponse) != std::string::npos)
             {
-                std::string actionResultCallbackFnc = savedCode.actionResultCallbackFnc;
-                replaceCommonEventPlaceholders(actionResultCallbackFnc, eventData);
-                writeAfterCommand(str, "/*ACTION_FNC_LIST*/", actionResultCallbackFnc);
+                templateFragmentStr actionResultCallbackFnc = makeTemplateFragment(savedCode.actionResultCallbackFnc);
+                setCommonEventValues(actionResultCallbackFnc, eventData);
+                writeToSlot(document, "/*ACTION_FNC_LIST*/", actionResultCallbackFnc, context);
 
-                std::string actionResultRequestLambda = savedCode.actionResultRequestLambda;
-                replaceCommonEventPlaceholders(actionResultRequestLambda, eventData);
-                writeAfterCommand(str, "/*ACTION_LAMBDA_LIST*/", actionResultRequestLambda);
+                templateFragmentStr actionResultRequestLambda = makeTemplateFragment(savedCode.actionResultRequestLambda);
+                setCommonEventValues(actionResultRequestLambda, eventData);
+                writeToSlot(document, "/*ACTION_LAMBDA_LIST*/", actionResultRequestLambda, context);
 
             }
         }
@@ -563,152 +627,226 @@ void handleGenericEvent(const eventDataStr eventData, const savedCodeStr savedCo
  * @brief function to save specific sections of the code in the saved code structure
  * 
  * @param savedCode saved code structure passed by reference where the saved code is stored
- * @param code code string where the code is extracted and then deleted
+ * @param nodes compiled template where the sections are searched
+ * @param context template context where the saved sections are marked as snippets, so that they are not written in place
  */
-void saveCode(savedCodeStr& savedCode, std::string& code)
+void saveCode(savedCodeStr& savedCode, const std::vector<templateNodeStr>& nodes, templateContextStr& context)
 {
-    //CPP
-    saveSection(code, "/*PARAM*/", "/*END_PARAM*/", savedCode.sendParam);
-    deleteSection(code, "/*PARAM*/", "/*END_PARAM*/");
-    saveSection(code, "/*RETURN_PARAM*/", "/*END_RETURN_PARAM*/", savedCode.returnParam);
-    deleteSection(code, "/*RETURN_PARAM*/", "/*END_RETURN_PARAM*/");
-    saveSection(code, "/*TOPIC_PARAM*/", "/*END_TOPIC_PARAM*/", savedCode.topicParamList);
-    deleteSection(code, "/*TOPIC_PARAM*/", "/*END_TOPIC_PARAM*/");
-    saveSection(code, "/*SEND_EVENT_SRV*/", "/*END_SEND_EVENT_SRV*/", savedCode.eventC);
-    deleteSection(code, "/*SEND_EVENT_SRV*/", "/*END_SEND_EVENT_SRV*/");
-    saveSection(code, "/*TOPIC_CALLBACK*/", "/*END_TOPIC_CALLBACK*/", savedCode.topicCallbackC);
-    deleteSection(code, "/*TOPIC_CALLBACK*/", "/*END_TOPIC_CALLBACK*/");
-    saveSection(code, "/*TOPIC_SUBSCRIPTION*/", "/*END_TOPIC_SUBSCRIPTION*/", savedCode.topicSubscriptionC);
-    deleteSection(code, "/*TOPIC_SUBSCRIPTION*/", "/*END_TOPIC_SUBSCRIPTION*/");
-    saveSection(code, "/*ACTION_C*/", "/*END_ACTION_C*/", savedCode.actionC);
-    deleteSection(code, "/*ACTION_C*/", "/*END_ACTION_C*/");
-    saveSection(code, "/*SEND_PARAM*/", "/*END_SEND_PARAM*/", savedCode.actionSendParam);
-    deleteSection(code, "/*SEND_PARAM*/", "/*END_SEND_PARAM*/");
-    saveSection(code, "/*FEEDBACK_PARAM*/", "/*END_FEEDBACK_PARAM*/", savedCode.actionFeedbackParam);
-    deleteSection(code, "/*FEEDBACK_PARAM*/", "/*END_FEEDBACK_PARAM*/");
-    saveSection(code, "/*FEEDBACK_PARAM_FNC*/", "/*END_FEEDBACK_PARAM_FNC*/", savedCode.actionFeedbackParamFnc);
-    deleteSection(code, "/*FEEDBACK_PARAM_FNC*/", "/*END_FEEDBACK_PARAM_FNC*/");
-    saveSection(code, "/*FEEDBACK_DATA*/", "/*END_FEEDBACK_DATA*/", savedCode.actionFeedbackData);
-    deleteSection(code, "/*FEEDBACK_DATA*/", "/*END_FEEDBACK_DATA*/");
-    saveSection(code, "/*ACTION_SEND_GOAL*/", "/*END_ACTION_SEND_GOAL*/", savedCode.actionSendGoalLambda);
-    deleteSection(code, "/*ACTION_SEND_GOAL*/", "/*END_ACTION_SEND_GOAL*/");
-    saveSection(code, "/*ACTION_RESULT_REQUEST*/", "/*END_ACTION_RESULT_REQUEST*/", savedCode.actionResultRequestLambda);
-    deleteSection(code, "/*ACTION_RESULT_REQUEST*/", "/*END_ACTION_RESULT_REQUEST*/");
-    saveSection(code, "/*ACTION_FEEDBACK*/", "/*END_ACTION_FEEDBACK*/", savedCode.actionFeedbackLambda);
-    deleteSection(code, "/*ACTION_FEEDBACK*/", "/*END_ACTION_FEEDBACK*/");
-    saveSection(code, "/*ACTION_SEND_GOAL_FNC*/", "/*END_ACTION_SEND_GOAL_FNC*/", savedCode.actionSendGoalFnc);
-    deleteSection(code, "/*ACTION_SEND_GOAL_FNC*/", "/*END_ACTION_SEND_GOAL_FNC*/");
-    saveSection(code, "/*ACTION_RESULT_CALLBACK_FNC*/", "/*END_ACTION_RESULT_CALLBACK_FNC*/", savedCode.actionResultCallbackFnc);
-    deleteSection(code, "/*ACTION_RESULT_CALLBACK_FNC*/", "/*END_ACTION_RESULT_CALLBACK_FNC*/");
-    saveSection(code, "/*ACTION_FEEDBACK_FNC*/", "/*END_ACTION_FEEDBACK_FNC*/", savedCode.actionFeedbackCallback);
-    deleteSection(code, "/*ACTION_FEEDBACK_FNC*/", "/*END_ACTION_FEEDBACK_FNC*/");
-    saveSection(code, "/*ACTION_RESPONSE_CALLBACK_FNC*/", "/*END_ACTION_RESPONSE_CALLBACK_FNC*/", savedCode.actionGoalResponseFnc);
-    deleteSection(code, "/*ACTION_RESPONSE_CALLBACK_FNC*/", "/*END_ACTION_SEND_GOAL_FNC*/");
-
-    //H
-    saveSection(code, "/*INTERFACE*/", "/*END_INTERFACE*/", savedCode.interfaceH);
-    deleteSection(code, "/*INTERFACE*/", "/*END_INTERFACE*/");
-    saveSection(code, "/*TOPIC_INTERFACE*/", "/*END_TOPIC_INTERFACE*/", savedCode.topicInterfaceH);
-    deleteSection(code, "/*TOPIC_INTERFACE*/", "/*END_TOPIC_INTERFACE*/");
-    saveSection(code, "/*TOPIC_CALLBACK_H*/", "/*END_TOPIC_CALLBACK_H*/", savedCode.topicCallbackH);
-    deleteSection(code, "/*TOPIC_CALLBACK_H*/", "/*END_TOPIC_CALLBACK_H*/");
-    saveSection(code, "/*TOPIC_SUBSCRIPTION_H*/", "/*END_TOPIC_SUBSCRIPTION_H*/", savedCode.topicSubscriptionH);
-    deleteSection(code, "/*TOPIC_SUBSCRIPTION_H*/", "/*END_TOPIC_SUBSCRIPTION_H*/");
-    saveSection(code, "/*SERVICE_CLIENT*/", "/*END_SERVICE_CLIENT*/", savedCode.serviceClientH);
-    deleteSection(code, "/*SERVICE_CLIENT*/", "/*END_SERVICE_CLIENT*/");
-    saveSection(code, "/*ACTION_H*/", "/*END_ACTION_H*/", savedCode.actionH);
-    deleteSection(code, "/*ACTION_H*/", "/*END_ACTION_H*/");
-    saveSection(code, "/*ACTION_INTERFACE*/", "/*END_ACTION_INTERFACE*/", savedCode.actionInterfaceH);
-    deleteSection(code, "/*ACTION_INTERFACE*/", "/*END_ACTION_INTERFACE*/");
-    //CMakeLists.txt
-    saveSection(code, "#INTERFACE#", "#END_INTERFACE#", savedCode.interfaceCMake);
-    deleteSection(code, "#INTERFACE#", "#END_INTERFACE#");
-    saveSection(code, "#PACKAGE#", "#END_PACKAGE#", savedCode.packageCMake);
-    deleteSection(code, "#PACKAGE#", "#END_PACKAGE#");
-    //package.xml
-    saveSection(code, "<!--INTERFACE-->", "<!--END_INTERFACE-->", savedCode.interfaceXML);
-    deleteSection(code, "<!--INTERFACE-->", "<!--END_INTERFACE-->");
+    static const std::vector<std::pair<std::string, const templateNodeStr* savedCodeStr::*>> snippetTable = {
+        //CPP
+        {"/*PARAM*/", &savedCodeStr::sendParam},
+        {"/*RETURN_PARAM*/", &savedCodeStr::returnParam},
+        {"/*TOPIC_PARAM*/", &savedCodeStr::topicParamList},
+        {"/*SEND_EVENT_SRV*/", &savedCodeStr::eventC},
+        {"/*TOPIC_CALLBACK*/", &savedCodeStr::topicCallbackC},
+        {"/*TOPIC_SUBSCRIPTION*/", &savedCodeStr::topicSubscriptionC},
+        {"/*ACTION_C*/", &savedCodeStr::actionC},
+        {"/*SEND_PARAM*/", &savedCodeStr::actionSendParam},
+        {"/*FEEDBACK_PARAM*/", &savedCodeStr::actionFeedbackParam},
+        {"/*FEEDBACK_PARAM_FNC*/", &savedCodeStr::actionFeedbackParamFnc},
+        {"/*FEEDBACK_DATA*/", &savedCodeStr::actionFeedbackData},
+        {"/*ACTION_SEND_GOAL*/", &savedCodeStr::actionSendGoalLambda},
+        {"/*ACTION_RESULT_REQUEST*/", &savedCodeStr::actionResultRequestLambda},
+        {"/*ACTION_FEEDBACK*/", &savedCodeStr::actionFeedbackLambda},
+        {"/*ACTION_SEND_GOAL_FNC*/", &savedCodeStr::actionSendGoalFnc},
+        {"/*ACTION_RESULT_CALLBACK_FNC*/", &savedCodeStr::actionResultCallbackFnc},
+        {"/*ACTION_FEEDBACK_FNC*/", &savedCodeStr::actionFeedbackCallback},
+        {"/*ACTION_RESPONSE_CALLBACK_FNC*/", &savedCodeStr::actionGoalResponseFnc},
+        //H
+        {"/*INTERFACE*/", &savedCodeStr::interfaceH},
+        {"/*TOPIC_INTERFACE*/", &savedCodeStr::topicInterfaceH},
+        {"/*TOPIC_CALLBACK_H*/", &savedCodeStr::topicCallbackH},
+        {"/*TOPIC_SUBSCRIPTION_H*/", &savedCodeStr::topicSubscriptionH},
+        {"/*SERVICE_CLIENT*/", &savedCodeStr::serviceClientH},
+        {"/*ACTION_H*/", &savedCodeStr::actionH},
+        {"/*ACTION_INTERFACE*/", &savedCodeStr::actionInterfaceH},
+        //CMakeLists.txt
+        {"#INTERFACE#", &savedCodeStr::interfaceCMake},
+        {"#PACKAGE#", &savedCodeStr::packageCMake},
+        //package.xml
+        {"<!--INTERFACE-->", &savedCodeStr::interfaceXML},
+    };
+    for (const auto& [marker, field] : snippetTable) {
+        context.snippets.insert(marker);
+        const templateNodeStr* section = findTemplateSection(nodes, marker, context);
+        if (section) {
+            savedCode.*field = section;
+        }
+    }
+    // the goal response section is deleted up to the send goal end marker, which is already gone: the rest of the template is dropped
+    context.truncateMarker = "/*ACTION_RESPONSE_CALLBACK_FNC*/";
 }
 
 /**
- * @brief function to replace the event code in the code map
+ * @brief function to render the templates with the event code
  * 
- * @param codeMap code map where the code is stored
+ * @param compiledMap compiled templates, not modified
+ * @param codeMap code map where the rendered code is stored
+ * @param context template context with the skill placeholders and the sections to keep or delete
+ * @param eventsMap events of the skill
  */
-void replaceEventCode(std::map <std::string, std::string>& codeMap, fileDataStr fileData){
+void replaceEventCode(const std::map <std::string, std::vector<templateNodeStr>>& compiledMap, std::map <std::string, std::string>& codeMap, templateContextStr& context, const std::map<std::string, eventDataStr>& eventsMap){
+    handleCmdTickEvent(context, eventsMap.find(cmdTick) != eventsMap.end());
+    handleCmdHaltEvent(context, eventsMap.find(cmdHalt) != eventsMap.end());
+    handleRspTickEvent(context, eventsMap.find(rspTick) != eventsMap.end());
+    handleRspHaltEvent(context, eventsMap.find(rspHalt) != eventsMap.end());
+
+    // the events are rendered in every template, only the blackboard events are copied once to rename their functions
+    std::vector<eventDataStr> blackboardEvents;
+    std::vector<const eventDataStr*> events;
+    blackboardEvents.reserve(eventsMap.size());
+    for (const auto& [event, eventData] : eventsMap)
+    {
+        if(event == cmdTick || event == cmdHalt || event == rspTick || event == rspHalt){
+            continue;
+        }
+        if(eventData.interfaceName == "blackboard_interfaces")
+        {
+            blackboardEvents.push_back(eventData);
+            blackboardEvents.back().functionNameSnakeCase += "_blackboard";
+            events.push_back(&blackboardEvents.back());
+        }
+        else
+        {
+            events.push_back(&eventData);
+        }
+    }
+
+    // the saved code points into the compiled templates, which are shared by all the skills
     savedCodeStr savedCode;
-    for (auto it = codeMap.begin(); it != codeMap.end(); it++) {
-        handleCmdTickEvent(it->second, eventsMap.find(cmdTick) != eventsMap.end());
-        handleCmdHaltEvent(it->second, eventsMap.find(cmdHalt) != eventsMap.end());
-        handleRspTickEvent(it->second, eventsMap.find(rspTick) != eventsMap.end());
-        handleRspHaltEvent(it->second, eventsMap.find(rspHalt) != eventsMap.end());
-        saveCode(savedCode, it->second);
-        for (auto itEv = eventsMap.begin(); itEv != eventsMap.end(); itEv++)
-        { 
-            if(itEv->first != cmdTick && itEv->first != cmdHalt && itEv->first != rspTick && itEv->first != rspHalt){
-                eventDataStr eventData = itEv->second;
-                if(eventData.interfaceName == "blackboard_interfaces")
-                {
-                    eventData.functionNameSnakeCase += "_blackboard";
-                }
-                handleGenericEvent(eventData, savedCode, it->second);
-            } 
+    // interfaces used by the events, written once in the dependency slots after the events of each template
+    interfaceDependenciesStr dependencies;
+    for (auto it = compiledMap.begin(); it != compiledMap.end(); it++) {
+        saveCode(savedCode, it->second, context);
+        templateFragmentStr document = makeTemplateFragment(it->second);
+        {
+            TRACE_PHASE_DETAIL("writeEventCode", it->first);
+            for (const eventDataStr* eventData : events)
+            { 
+                handleGenericEvent(*eventData, savedCode, document, context, dependencies);
+            }
+            writeInterfaceDependencies(dependencies, savedCode, document, context);
         }
+        TRACE_PHASE_DETAIL("renderTemplate", it->first);
+        codeMap[it->first] = renderTemplate(document, context);
+    }
+
+}
+
+/**
+ * @brief function to map a template file and store its code in the code map
+ * 
+ * @param templateFiles mapped template files where the mapped file is kept
+ * @param filePath path of the template file
+ * @param code code of the template returned by reference, valid while the mapped file is kept
+ * @return true 
+ * @return false 
+ */
+static bool readTemplate(std::vector<std::shared_ptr<const mappedFileStr>>& templateFiles, const std::string& filePath, std::string_view& code)
+{
+    std::shared_ptr<const mappedFileStr> file = mapInputFile(filePath);
+    if(!file){
+        error_stream() << "Failed to open template file for reading: " << filePath << std::endl;
+        return false;
+    }
+    code = file->view();
+    templateFiles.push_back(std::move(file));
+    return true;
+}
+
+/**
+ * @brief function to compile the templates once, the compiled templates are shared by all the skills
+ * 
+ * @param codeMap template code
+ * @param compiledMap compiled templates returned by reference
+ */
+static void compileTemplates(const std::map <std::string, std::string_view>& codeMap, std::map <std::string, std::vector<templateNodeStr>>& compiledMap)
+{
+    static const std::set<std::string> slotMarkers = {
         //CPP
-        deleteCommand(it->second, "/*SEND_EVENT_LIST*/");
-        deleteCommand(it->second, "/*PARAM_LIST*/");
-        deleteCommand(it->second, "/*RETURN_PARAM_LIST*/");
-        deleteCommand(it->second, "/*TOPIC_SUBSCRIPTIONS_LIST*/");
-        deleteCommand(it->second, "/*TOPIC_CALLBACK_LIST*/"); 
-        deleteCommand(it->second, "/*TOPIC_PARAM_LIST*/");
-        deleteCommand(it->second, "/*ACTION_LIST_C*/"); 
-        deleteCommand(it->second, "/*SEND_PARAM_LIST*/");
-        deleteCommand(it->second, "/*FEEDBACK_PARAM_LIST*/");
-        deleteCommand(it->second, "/*FEEDBACK_PARAM_LIST_FNC*/");
-        deleteCommand(it->second, "/*FEEDBACK_DATA_LIST*/");
-        deleteCommand(it->second, "/*ACTION_LAMBDA_LIST*/"); 
-        deleteCommand(it->second, "/*ACTION_FNC_LIST*/"); 
+        "/*SEND_EVENT_LIST*/", "/*PARAM_LIST*/", "/*RETURN_PARAM_LIST*/", "/*TOPIC_SUBSCRIPTIONS_LIST*/", "/*TOPIC_CALLBACK_LIST*/",
+        "/*TOPIC_PARAM_LIST*/", "/*ACTION_LIST_C*/", "/*SEND_PARAM_LIST*/", "/*FEEDBACK_PARAM_LIST*/", "/*FEEDBACK_PARAM_LIST_FNC*/",
+        "/*FEEDBACK_DATA_LIST*/", "/*ACTION_LAMBDA_LIST*/", "/*ACTION_FNC_LIST*/",
         //H
-        deleteCommand(it->second, "/*INTERFACES_LIST*/");
-        deleteCommand(it->second, "/*SERVICE_CLIENTS_LIST*/");
-        deleteCommand(it->second, "/*TOPIC_SUBSCRIPTIONS_LIST_H*/");
-        deleteCommand(it->second, "/*TOPIC_CALLBACK_LIST_H*/");
-        deleteCommand(it->second, "/*ACTION_LIST_H*/");
+        "/*INTERFACES_LIST*/", "/*SERVICE_CLIENTS_LIST*/", "/*TOPIC_SUBSCRIPTIONS_LIST_H*/", "/*TOPIC_CALLBACK_LIST_H*/", "/*ACTION_LIST_H*/",
         //CMakeLists.txt
-        deleteCommand(it->second, "#INTERFACE_LIST#");
-        deleteCommand(it->second, "#PACKAGE_LIST#");
+        "#INTERFACE_LIST#", "#PACKAGE_LIST#",
         //package.xml
-        deleteCommand(it->second, "<!--INTERFACE_LIST-->");
+        "<!--INTERFACE_LIST-->",
+    };
+    compiledMap.clear();
+    for (const auto& [templateName, code] : codeMap) {
+        TRACE_PHASE_DETAIL("compileTemplate", templateName);
+        compileTemplate(code, slotMarkers, compiledMap[templateName]);
     }
-
 }
 
 /**
  * @brief function to read the template files and store the code in the code map
  * 
- * @param templateFileData template file data structure passed by reference where the template file data is stored
- * @param codeMap code map where the code is stored
+ * The templates are read by the first call, concurrent calls wait for it. The code map and the compiled templates are
+ * only filled if all the templates are read, so a failed call leaves them empty and the next call reads them again.
+ * 
+ * @param templateFileData template file data structure passed by reference where the template file data and the compiled templates are stored
+ * @param codeMap code map where the code is stored, the templates are not read again if it is already filled
  * @return true 
  * @return false 
  */
-bool readTemplates(templateFileDataStr& templateFileData, std::map <std::string, std::string>& codeMap)
+bool readTemplates(templateFileDataStr& templateFileData, std::map <std::string, std::string_view>& codeMap)
 {
-    templateFileData.hFile              = templateFileData.templatePath + hTemplateFileRelativePath;
-    templateFileData.cppFile            = templateFileData.templatePath + cppTemplateFileRelativePath;
-    templateFileData.hDatamodelFile     = templateFileData.templatePath + hDataModelTemplateFileRelativePath;
-    templateFileData.cppDatamodelFile   = templateFileData.templatePath + cppDataModelTemplateFileRelativePath;
-    templateFileData.CMakeListsFile     = templateFileData.templatePath + cMakeTemplateFileRelativePath;
-    templateFileData.packageFile        = templateFileData.templatePath + pkgTemplateFileRelativePath;
-    templateFileData.mainFile           = templateFileData.templatePath + mainTemplateFileRelativePath;
+    // the skills generated concurrently share templateFileData
+    static std::mutex templatesMutex;
+    std::lock_guard<std::mutex> lock(templatesMutex);
+    if(!codeMap.empty()){
+        LOG_DEBUG("Templates already loaded from: " << getTemplateSource(templateFileData));
+        return true;
+    }
+    TRACE_PHASE_DETAIL("readTemplates", getTemplateSource(templateFileData));
     bool res = true;
-    res &= readTemplateFile(templateFileData.hFile, codeMap["hCode"]);
-    res &= readTemplateFile(templateFileData.cppFile, codeMap["cppCode"]);
-    res &= readTemplateFile(templateFileData.hDatamodelFile, codeMap["hDataModelCode"]);
-    res &= readTemplateFile(templateFileData.cppDatamodelFile, codeMap["cppDataModelCode"]);
-    res &= readTemplateFile(templateFileData.CMakeListsFile, codeMap["cmakeCode"]);
-    res &= readTemplateFile(templateFileData.packageFile, codeMap["packageCode"]);
-    res &= readTemplateFile(templateFileData.mainFile, codeMap["mainCode"]);
-    return res;
+    std::map <std::string, std::string_view> readCodeMap;
+    std::vector<std::shared_ptr<const mappedFileStr>> templateFiles;
+    if(templateFileData.templatePath.empty()){
+        // template_skill compiled in the executable (cmake/EmbedTemplates.cmake), no file is read
+        for (const auto& [templateName, code] : embeddedTemplates) {
+            readCodeMap[templateName] = code;
+        }
+    }
+    else{
+        templateFileData.hFile              = templateFileData.templatePath + hTemplateFileRelativePath;
+        templateFileData.cppFile            = templateFileData.templatePath + cppTemplateFileRelativePath;
+        templateFileData.hDatamodelFile     = templateFileData.templatePath + hDataModelTemplateFileRelativePath;
+        templateFileData.cppDatamodelFile   = templateFileData.templatePath + cppDataModelTemplateFileRelativePath;
+        templateFileData.CMakeListsFile     = templateFileData.templatePath + cMakeTemplateFileRelativePath;
+        templateFileData.packageFile        = templateFileData.templatePath + pkgTemplateFileRelativePath;
+        templateFileData.mainFile           = templateFileData.templatePath + mainTemplateFileRelativePath;
+        res &= readTemplate(templateFiles, templateFileData.hFile, readCodeMap["hCode"]);
+        res &= readTemplate(templateFiles, templateFileData.cppFile, readCodeMap["cppCode"]);
+        res &= readTemplate(templateFiles, templateFileData.hDatamodelFile, readCodeMap["hDataModelCode"]);
+        res &= readTemplate(templateFiles, templateFileData.cppDatamodelFile, readCodeMap["cppDataModelCode"]);
+        res &= readTemplate(templateFiles, templateFileData.CMakeListsFile, readCodeMap["cmakeCode"]);
+        res &= readTemplate(templateFiles, templateFileData.packageFile, readCodeMap["packageCode"]);
+        res &= readTemplate(templateFiles, templateFileData.mainFile, readCodeMap["mainCode"]);
+    }
+    if(!res){
+        return false;
+    }
+    std::map <std::string, std::vector<templateNodeStr>> compiledMap;
+    compileTemplates(readCodeMap, compiledMap);
+    templateFileData.templateFiles.swap(templateFiles);
+    templateFileData.compiledMap.swap(compiledMap);
+    codeMap.swap(readCodeMap);
+    return true;
+}
+
+/**
+ * @brief function to get a description of where the templates are read from, for the messages
+ * 
+ * @param templateFileData template file data structure
+ * @return std::string template path or "embedded template_skill"
+ */
+std::string getTemplateSource(const templateFileDataStr& templateFileData)
+{
+    return templateFileData.templatePath.empty() ? "embedded template_skill" : templateFileData.templatePath;
 }
 
 /**
@@ -722,14 +860,14 @@ bool createDirectory(const std::string& path) {
     try {
         // Create the directory (and any intermediate directories, if necessary)
         if (fs::create_directories(path)) {
-            add_to_log("Directory created successfully: " + path);
+            LOG_DEBUG("Directory created successfully: " << path);
             return true;
         } else {
-            add_to_log("Directory already exists or failed to create: " + path);
+            LOG_DEBUG("Directory already exists or failed to create: " << path);
             return false;
         }
     } catch (const fs::filesystem_error& err) {
-        std::cerr << "Filesystem error: " << err.what() << std::endl;
+        error_stream() << "Filesystem error: " << err.what() << std::endl;
         return false;
     }
 }
@@ -742,18 +880,31 @@ bool createDirectory(const std::string& path) {
  * 
  * @param fileData file data structure passed by reference where the file data is stored
  * @param templateFileData template file data structure passed by reference where the template file data is stored
+ * @param doc SCXML document translated in memory, if empty the SCXML is loaded from fileData.inputFileNameGeneration
+ * @param filesWritten result of the background write of the generated files
  * @return true if the generation is successful
  */
-bool Replacer(fileDataStr& fileData, templateFileDataStr& templateFileData)
+bool Replacer(fileDataStr& fileData, templateFileDataStr& templateFileData, tinyxml2::XMLDocument& doc, std::future<bool>& filesWritten)
 { 
     std::string rootName;
     skillDataStr skillData;
     std::map <std::string, std::string> codeMap;
     std::vector<tinyxml2::XMLElement *> elementsTransition, elementsSend;
-    tinyxml2::XMLDocument doc;
-    add_to_log("-----------");
-    if(!extractFromSCXML(doc, fileData.inputFileNameGeneration, rootName, elementsTransition, elementsSend)){
-        return 0;
+    // events of the skill, owned by the generation of this skill only
+    std::map<std::string, eventDataStr> eventsMap;
+    LOG_DEBUG("-----------");
+    {
+        TRACE_PHASE("extractFromSCXML");
+        if(doc.RootElement()){
+            // Translated SCXML handed over by the Translator, no need to read it back from disk
+            LOG_DEBUG("Using the translated SCXML in memory");
+            if(!extractFromSCXMLDocument(doc, rootName, elementsTransition, elementsSend)){
+                return 0;
+            }
+        }
+        else if(!extractFromSCXML(doc, fileData.inputFileNameGeneration, rootName, elementsTransition, elementsSend)){
+            return 0;
+        }
     }
     
     if(!getDataFromRootName(rootName, skillData)){
@@ -761,61 +912,69 @@ bool Replacer(fileDataStr& fileData, templateFileDataStr& templateFileData)
     }
     printSkillData(skillData);
     setFileData(fileData, skillData);
-    if(!readTemplates(templateFileData, codeMap))
+    if(!readTemplates(templateFileData, templateFileData.codeMap))
     {
         return false;
     }
 
-    // Get current datetime for autogenerated file headers
-    std::string currentDatetime = getCurrentDatetime();
+    // Datetime for autogenerated file headers, fixed in reproducible mode
+    std::string currentDatetime = fileData.generationDatetime.empty() ? getGenerationDatetime(fileData.reproducible_mode) : fileData.generationDatetime;
     
-    for (auto it = codeMap.begin(); it != codeMap.end(); it++) {
-        replaceAll(it->second, "$className$", skillData.className);
-        replaceAll(it->second, "$projectName$", skillData.classNameSnakeCase);
-        replaceAll(it->second, "$SMName$", skillData.SMName);
-        replaceAll(it->second, "$skillName$", skillData.skillName);
-        std::cout << "=================================skillType: " << skillData.skillType << std::endl;
-        replaceAll(it->second, "$skillTypeLC$", skillData.skillTypeLC);
-        replaceAll(it->second, "$skillType$", skillData.skillType);
-        replaceAll(it->second, "$datetime$", currentDatetime);
-
-        if(fileData.is_action_skill){
-            keepSection(it->second, "/*ACTION*/", "/*END_ACTION*/");
-        }else{
-            deleteSection(it->second, "/*ACTION*/", "/*END_ACTION*/");
-        }
-        if(fileData.datamodel_mode){
-            keepSection(it->second, "/*DATAMODEL*/", "/*END_DATAMODEL*/");
-            keepSection(it->second, "#DATAMODEL#", "#END_DATAMODEL#");
-            std::string dataModelClassName = skillData.className + "DataModel";
-            replaceAll(it->second, "$dataModelClassName$", dataModelClassName);
-        }else{
-            deleteSection(it->second, "/*DATAMODEL*/", "/*END_DATAMODEL*/");
-            deleteSection(it->second, "#DATAMODEL#", "#END_DATAMODEL#");
+    // The skill placeholders and sections are resolved while rendering the compiled templates
+    templateContextStr context;
+    context.values["$className$"] = skillData.className;
+    context.values["$projectName$"] = skillData.classNameSnakeCase;
+    context.values["$SMName$"] = skillData.SMName;
+    context.values["$skillName$"] = skillData.skillName;
+    LOG_DEBUG("=================================skillType: " << skillData.skillType);
+    context.values["$skillTypeLC$"] = skillData.skillTypeLC;
+    context.values["$skillType$"] = skillData.skillType;
+    context.values["$datetime$"] = currentDatetime;
+
+    context.sections["/*ACTION*/"] = fileData.is_action_skill;
+    context.sections["/*DATAMODEL*/"] = fileData.datamodel_mode;
+    context.sections["#DATAMODEL#"] = fileData.datamodel_mode;
+    if(fileData.datamodel_mode){
+        context.values["$dataModelClassName$"] = skillData.className + "DataModel";
+    }
+    // The High-Level SCXML is parsed once and shared by all the events, only if an event is not in the cache
+    hlModelDataStr hlModel;
+    eventCacheStr eventCache;
+    {
+        TRACE_PHASE("getEventsVecData");
+        readEventCache(fileData, eventCache);
+        if (!getEventsVecData(fileData, hlModel, eventCache, elementsTransition, elementsSend, eventsMap))
+        {
+            return false;
         }
+        writeEventCache(eventCache);
     }
-    if (!getEventsVecData(fileData, elementsTransition, elementsSend))
     {
-        return false;
+        TRACE_PHASE("replaceEventCode");
+        replaceEventCode(templateFileData.compiledMap, codeMap, context, eventsMap);
     }
-    replaceEventCode(codeMap, fileData);
 
-    add_to_log("-----------");
+    LOG_DEBUG("-----------");
+    if(!get_generation_context().inMemory)
+    {
+        createDirectory(fileData.outputPath);
+        createDirectory(fileData.outputPathInclude);
+        createDirectory(fileData.outputPathSrc);
+    }
+    LOG_DEBUG("-----------");
+    // The rendered code is moved to the background writer, the files are written while the next skill is generated
+    std::vector<outputFileStr> files;
     if(fileData.datamodel_mode)
     {
-        writeFile(fileData.outputPathInclude, fileData.outputDatamodelFileNameH, codeMap["hDataModelCode"]);
-        writeFile(fileData.outputPathSrc, fileData.outputDatamodelFileNameCPP, codeMap["cppDataModelCode"]);
-    }
-    add_to_log("-----------");
-    createDirectory(fileData.outputPath);
-    createDirectory(fileData.outputPathInclude);
-    createDirectory(fileData.outputPathSrc);
-    add_to_log("-----------");
-    writeFile(fileData.outputPathInclude, fileData.outputFileNameH, codeMap["hCode"]);
-    writeFile(fileData.outputPathSrc, fileData.outputFileNameCPP, codeMap["cppCode"]);
-    writeFile(fileData.outputPath, fileData.outputCMakeListsFileName, codeMap["cmakeCode"]);
-    writeFile(fileData.outputPath, fileData.outputPackageXMLFileName, codeMap["packageCode"]);
-    writeFile(fileData.outputPathSrc, fileData.outputMainFileName, codeMap["mainCode"]);
+        files.push_back({fileData.outputPathInclude, fileData.outputDatamodelFileNameH, std::move(codeMap["hDataModelCode"])});
+        files.push_back({fileData.outputPathSrc, fileData.outputDatamodelFileNameCPP, std::move(codeMap["cppDataModelCode"])});
+    }
+    files.push_back({fileData.outputPathInclude, fileData.outputFileNameH, std::move(codeMap["hCode"])});
+    files.push_back({fileData.outputPathSrc, fileData.outputFileNameCPP, std::move(codeMap["cppCode"])});
+    files.push_back({fileData.outputPath, fileData.outputCMakeListsFileName, std::move(codeMap["cmakeCode"])});
+    files.push_back({fileData.outputPath, fileData.outputPackageXMLFileName, std::move(codeMap["packageCode"])});
+    files.push_back({fileData.outputPathSrc, fileData.outputMainFileName, std::move(codeMap["mainCode"])});
+    filesWritten = queueOutputFiles("writeFiles", std::move(files));
 
     return true;
 }
\ No newline at end of file
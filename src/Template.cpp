@@ -0,0 +1,624 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file Template.cpp
+ * @brief This file contains the functions to compile the template files and render them with the event code.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+
+#include "Template.h"
+#include <algorithm>
+
+/**
+ * \defgroup Template Template
+ * Templates are compiled once into a tree of literals, placeholders ($name$), sections (/\*X*\/ ... /\*END_X*\/,
+ * #X# ... #END_X#, <!--X--> ... <!--END_X-->) and repeat slots (e.g. /\*PARAM_LIST*\/). The event code is written
+ * in the slots as fragments and the result is rendered in a single pass.
+ * @{
+ */
+
+/**
+ * @brief Append a literal to a node vector, merging it with the previous literal
+ *
+ * @param nodes node vector
+ * @param text literal text
+ */
+static void appendLiteral(std::vector<templateNodeStr>& nodes, std::string_view text)
+{
+    if (text.empty()) {
+        return;
+    }
+    if (!nodes.empty() && nodes.back().type == templateNodeType::literal) {
+        nodes.back().text += text;
+        return;
+    }
+    nodes.push_back({templateNodeType::literal, std::string(text), "", {}});
+}
+
+/**
+ * @brief Append a node to a node vector, merging consecutive literals
+ *
+ * @param nodes node vector
+ * @param node node to be appended
+ */
+static void appendNode(std::vector<templateNodeStr>& nodes, templateNodeStr&& node)
+{
+    if (node.type == templateNodeType::literal) {
+        appendLiteral(nodes, node.text);
+        return;
+    }
+    nodes.push_back(std::move(node));
+}
+
+/**
+ * @brief Replace a section without end marker with its marker and its content
+ *
+ * @param nodes node vector where the section content is appended
+ * @param section section without end marker
+ */
+static void appendUnclosedSection(std::vector<templateNodeStr>& nodes, templateNodeStr&& section)
+{
+    appendLiteral(nodes, section.text);
+    for (auto& child : section.children) {
+        appendNode(nodes, std::move(child));
+    }
+}
+
+/**
+ * @brief Get the length of the marker starting at a given position
+ *
+ * @param code template code
+ * @param pos position of the marker
+ * @param name marker name returned by reference (e.g. "END_TICK")
+ * @param endMarker end marker of the section the marker would open, returned by reference
+ * @return size_t marker length, 0 if there is no marker at pos
+ */
+static size_t matchMarker(std::string_view code, const size_t pos, std::string& name, std::string& endMarker)
+{
+    static const std::vector<std::pair<std::string, std::string>> styles = {{"/*", "*/"}, {"#", "#"}, {"<!--", "-->"}};
+    for (const auto& [open, close] : styles) {
+        if (code.compare(pos, open.size(), open) != 0) {
+            continue;
+        }
+        size_t end = pos + open.size();
+        while (end < code.size() && (isupper(code[end]) || isdigit(code[end]) || code[end] == '_')) {
+            end++;
+        }
+        if (end == pos + open.size() || code.compare(end, close.size(), close) != 0) {
+            continue;
+        }
+        name = code.substr(pos + open.size(), end - pos - open.size());
+        endMarker = open + "END_" + name + close;
+        return end + close.size() - pos;
+    }
+    return 0;
+}
+
+/**
+ * @brief Get the length of the placeholder starting at a given position
+ *
+ * @param code template code
+ * @param pos position of the placeholder
+ * @return size_t placeholder length, 0 if there is no placeholder at pos
+ */
+static size_t matchPlaceholder(std::string_view code, const size_t pos)
+{
+    if (code[pos] != '$') {
+        return 0;
+    }
+    size_t end = pos + 1;
+    while (end < code.size() && (isalnum(code[end]) || code[end] == '_' || code[end] == '.' || code[end] == '-' || code[end] == '>')) {
+        end++;
+    }
+    if (end == pos + 1 || end == code.size() || code[end] != '$') {
+        return 0;
+    }
+    return end + 1 - pos;
+}
+
+/**
+ * @brief Compile a template into a tree of literals, placeholders, sections and slots
+ *
+ * @param code template code
+ * @param slotMarkers markers of the repeat slots (e.g. PARAM_LIST in its comment delimiters)
+ * @param nodes compiled template returned by reference
+ */
+void compileTemplate(std::string_view code, const std::set<std::string>& slotMarkers, std::vector<templateNodeStr>& nodes)
+{
+    // stack of the open sections, the first element collects the top level nodes
+    std::vector<templateNodeStr> stack(1);
+    size_t literalStart = 0;
+    size_t pos = 0;
+    while ((pos = code.find_first_of("$/#<", pos)) != std::string_view::npos) {
+        std::string name, endMarker;
+        size_t length = matchPlaceholder(code, pos);
+        bool isPlaceholder = length > 0;
+        if (!isPlaceholder) {
+            length = matchMarker(code, pos, name, endMarker);
+        }
+        if (length == 0) {
+            pos++;
+            continue;
+        }
+        std::string token(code.substr(pos, length));
+        appendLiteral(stack.back().children, code.substr(literalStart, pos - literalStart));
+        pos += length;
+        literalStart = pos;
+
+        if (isPlaceholder) {
+            stack.back().children.push_back({templateNodeType::placeholder, token, "", {}});
+        }
+        else if (slotMarkers.count(token)) {
+            stack.back().children.push_back({templateNodeType::slot, token, "", {}});
+        }
+        else if (name.rfind("END_", 0) != 0) {
+            stack.push_back({templateNodeType::section, token, endMarker, {}});
+        }
+        else {
+            // close the matching section, the sections opened after it have no end marker
+            size_t open = stack.size() - 1;
+            while (open > 0 && stack[open].endMarker != token) {
+                open--;
+            }
+            if (open == 0) {
+                appendLiteral(stack.back().children, token);
+                continue;
+            }
+            while (stack.size() - 1 > open) {
+                templateNodeStr unclosed = std::move(stack.back());
+                stack.pop_back();
+                appendUnclosedSection(stack.back().children, std::move(unclosed));
+            }
+            templateNodeStr section = std::move(stack.back());
+            stack.pop_back();
+            stack.back().children.push_back(std::move(section));
+        }
+    }
+    appendLiteral(stack.back().children, code.substr(literalStart));
+    while (stack.size() > 1) {
+        templateNodeStr unclosed = std::move(stack.back());
+        stack.pop_back();
+        appendUnclosedSection(stack.back().children, std::move(unclosed));
+    }
+    nodes = std::move(stack.front().children);
+}
+
+/**
+ * @brief Check how a section is written
+ *
+ * @param section section node
+ * @param context template context
+ * @param keepMarkers true if the section is not handled by the context and is written with its markers
+ * @return true if the section content is written
+ * @return false if the section is deleted or is a snippet
+ */
+static bool isSectionWritten(const templateNodeStr& section, const templateContextStr& context, bool& keepMarkers)
+{
+    keepMarkers = false;
+    if (context.snippets.count(section.text)) {
+        return false;
+    }
+    auto it = context.sections.find(section.text);
+    if (it == context.sections.end()) {
+        keepMarkers = true;
+        return true;
+    }
+    return it->second;
+}
+
+/**
+ * @brief Find the first section with a given marker, the sections deleted by the context are skipped
+ *
+ * @param nodes compiled template
+ * @param marker section marker (e.g. PARAM in its comment delimiters)
+ * @param context template context with the sections to keep or delete
+ * @return const templateNodeStr* section found, nullptr otherwise
+ */
+const templateNodeStr* findTemplateSection(const std::vector<templateNodeStr>& nodes, const std::string& marker, const templateContextStr& context)
+{
+    for (const auto& node : nodes) {
+        if (node.type != templateNodeType::section) {
+            continue;
+        }
+        if (node.text == marker) {
+            return &node;
+        }
+        auto it = context.sections.find(node.text);
+        if (it != context.sections.end() && !it->second) {
+            continue;
+        }
+        const templateNodeStr* section = findTemplateSection(node.children, marker, context);
+        if (section) {
+            return section;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Create a fragment from a compiled template
+ *
+ * @param nodes compiled template
+ * @return templateFragmentStr fragment
+ */
+templateFragmentStr makeTemplateFragment(const std::vector<templateNodeStr>& nodes)
+{
+    templateFragmentStr fragment;
+    fragment.nodes = &nodes;
+    return fragment;
+}
+
+/**
+ * @brief Create a fragment from a snippet section
+ *
+ * @param section snippet section, nullptr for an empty fragment
+ * @return templateFragmentStr fragment
+ */
+templateFragmentStr makeTemplateFragment(const templateNodeStr* section)
+{
+    templateFragmentStr fragment;
+    if (section) {
+        fragment.nodes = &section->children;
+    }
+    return fragment;
+}
+
+/**
+ * @brief Create a fragment from plain text
+ *
+ * @param text text of the fragment
+ * @return templateFragmentStr fragment
+ */
+templateFragmentStr makeTemplateFragment(const std::string& text)
+{
+    templateFragmentStr fragment;
+    fragment.text = text;
+    return fragment;
+}
+
+/**
+ * @brief Add the slots of a node vector to a slot index, with the slots of the fragments already written in them
+ *
+ * @param nodes node vector of the fragment
+ * @param fragment fragment owning the slot content
+ * @param sections sections enclosing the node vector, from the indexed fragment
+ * @param truncations sections enclosing the truncate markers already visited, from the indexed fragment
+ * @param context template context with the truncate marker
+ * @param index slot index passed by reference where the slots are added
+ */
+static void indexSlotNodes(const std::vector<templateNodeStr>& nodes, templateFragmentStr& fragment, std::vector<const templateNodeStr*>& sections, std::vector<std::vector<const templateNodeStr*>>& truncations, const templateContextStr& context, templateSlotIndexStr& index);
+
+/**
+ * @brief Add the slots of a fragment to a slot index, see indexSlotNodes
+ *
+ * @param fragment fragment whose slots are added
+ * @param sections sections enclosing the fragment, from the indexed fragment
+ * @param truncations sections enclosing the truncate markers before the fragment, from the indexed fragment
+ * @param context template context with the truncate marker
+ * @param index slot index passed by reference where the slots are added
+ */
+static void indexSlotFragment(templateFragmentStr& fragment, std::vector<const templateNodeStr*> sections, std::vector<std::vector<const templateNodeStr*>> truncations, const templateContextStr& context, templateSlotIndexStr& index)
+{
+    if (fragment.nodes) {
+        indexSlotNodes(*fragment.nodes, fragment, sections, truncations, context, index);
+    }
+}
+
+static void indexSlotNodes(const std::vector<templateNodeStr>& nodes, templateFragmentStr& fragment, std::vector<const templateNodeStr*>& sections, std::vector<std::vector<const templateNodeStr*>>& truncations, const templateContextStr& context, templateSlotIndexStr& index)
+{
+    for (const auto& node : nodes) {
+        if (node.type == templateNodeType::slot) {
+            index.slots[node.text].push_back({&fragment, &node, sections, truncations});
+            auto it = fragment.slotContent.find(&node);
+            if (it != fragment.slotContent.end()) {
+                for (auto& slotFragment : it->second) {
+                    indexSlotFragment(slotFragment, sections, truncations, context, index);
+                }
+            }
+        }
+        else if (node.type == templateNodeType::section) {
+            if (node.text == context.truncateMarker) {
+                // the rest of the fragment is dropped when the marker is reached, i.e. when its enclosing sections are written
+                truncations.push_back(sections);
+                continue;
+            }
+            sections.push_back(&node);
+            indexSlotNodes(node.children, fragment, sections, truncations, context, index);
+            sections.pop_back();
+        }
+    }
+}
+
+/**
+ * @brief Check if all the sections of a list are written
+ *
+ * @param sections sections to be checked
+ * @param context template context
+ * @return true if all the sections are written
+ * @return false otherwise
+ */
+static bool areSectionsWritten(const std::vector<const templateNodeStr*>& sections, const templateContextStr& context)
+{
+    bool keepMarkers;
+    return std::all_of(sections.begin(), sections.end(), [&](const templateNodeStr* section) { return isSectionWritten(*section, context, keepMarkers); });
+}
+
+/**
+ * @brief Write a fragment in all the slots with a given marker, including the slots of the fragments already written
+ *
+ * The slots of the fragment are indexed by marker at its first write and the fragments written in them are added to
+ * the index, so a write only visits the slots with its marker. The sections and the truncate marker are checked at
+ * each write, as the context may change between the writes.
+ *
+ * @param fragment fragment where the slots are searched
+ * @param slotMarker slot marker (e.g. SEND_EVENT_LIST in its comment delimiters)
+ * @param content fragment to be written
+ * @param context template context
+ * @return true if at least one slot was found
+ * @return false otherwise
+ */
+bool writeToSlot(templateFragmentStr& fragment, const std::string& slotMarker, const templateFragmentStr& content, const templateContextStr& context)
+{
+    if (!fragment.nodes) {
+        return false;
+    }
+    templateSlotIndexStr& index = fragment.slotIndex;
+    if (!index.built) {
+        index.built = true;
+        indexSlotFragment(fragment, {}, {}, context, index);
+    }
+    auto it = index.slots.find(slotMarker);
+    if (it == index.slots.end()) {
+        return false;
+    }
+    // the written fragments are indexed after the write, so the content is not written in itself; the slots are copied
+    // as the index grows
+    std::vector<std::pair<templateFragmentStr*, templateSlotStr>> writtenFragments;
+    for (const auto& slot : it->second) {
+        if (!areSectionsWritten(slot.sections, context) ||
+            std::any_of(slot.truncations.begin(), slot.truncations.end(), [&](const auto& truncation) { return areSectionsWritten(truncation, context); })) {
+            continue;
+        }
+        std::deque<templateFragmentStr>& slotFragments = slot.fragment->slotContent[slot.slot];
+        slotFragments.push_back(content);
+        writtenFragments.push_back({&slotFragments.back(), slot});
+    }
+    for (const auto& [writtenFragment, slot] : writtenFragments) {
+        indexSlotFragment(*writtenFragment, slot.sections, slot.truncations, context, index);
+    }
+    return !writtenFragments.empty();
+}
+
+/**
+ * @brief Check if a node vector contains a slot with a given marker, see hasSlot
+ *
+ * @param nodes node vector of the fragment
+ * @param fragment fragment owning the slot content
+ * @param slotMarker slot marker
+ * @param context template context
+ * @param stop set to true when the truncate marker is reached
+ * @return true
+ * @return false
+ */
+static bool hasSlotNodes(const std::vector<templateNodeStr>& nodes, const templateFragmentStr& fragment, const std::string& slotMarker, const templateContextStr& context, bool& stop)
+{
+    for (const auto& node : nodes) {
+        if (stop) {
+            break;
+        }
+        if (node.type == templateNodeType::slot) {
+            if (node.text == slotMarker) {
+                return true;
+            }
+            auto it = fragment.slotContent.find(&node);
+            if (it != fragment.slotContent.end()) {
+                for (const auto& slotFragment : it->second) {
+                    if (hasSlot(slotFragment, slotMarker, context)) {
+                        return true;
+                    }
+                }
+            }
+        }
+        else if (node.type == templateNodeType::section) {
+            if (node.text == context.truncateMarker) {
+                stop = true;
+                break;
+            }
+            bool keepMarkers;
+            if (isSectionWritten(node, context, keepMarkers) && hasSlotNodes(node.children, fragment, slotMarker, context, stop)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Check if a fragment contains a slot with a given marker
+ *
+ * @param fragment fragment where the slot is searched
+ * @param slotMarker slot marker (e.g. "#PACKAGE_LIST#")
+ * @param context template context
+ * @return true
+ * @return false
+ */
+bool hasSlot(const templateFragmentStr& fragment, const std::string& slotMarker, const templateContextStr& context)
+{
+    if (!fragment.nodes) {
+        return false;
+    }
+    bool stop = false;
+    return hasSlotNodes(*fragment.nodes, fragment, slotMarker, context, stop);
+}
+
+/**
+ * @brief Collect the literal text of a node vector, see getTemplateLiterals
+ *
+ * @param nodes node vector of the fragment
+ * @param fragment fragment owning the slot content
+ * @param context template context
+ * @param stop set to true when the truncate marker is reached
+ * @param literals literal text returned by reference
+ */
+static void getLiteralNodes(const std::vector<templateNodeStr>& nodes, const templateFragmentStr& fragment, const templateContextStr& context, bool& stop, std::vector<std::string_view>& literals)
+{
+    for (const auto& node : nodes) {
+        if (stop) {
+            return;
+        }
+        if (node.type == templateNodeType::literal) {
+            literals.push_back(node.text);
+        }
+        else if (node.type == templateNodeType::slot) {
+            auto it = fragment.slotContent.find(&node);
+            if (it != fragment.slotContent.end()) {
+                for (const auto& slotFragment : it->second) {
+                    getTemplateLiterals(slotFragment, context, literals);
+                }
+            }
+        }
+        else if (node.type == templateNodeType::section) {
+            if (node.text == context.truncateMarker) {
+                stop = true;
+                return;
+            }
+            bool keepMarkers;
+            if (isSectionWritten(node, context, keepMarkers)) {
+                getLiteralNodes(node.children, fragment, context, stop, literals);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Collect the literal text written by a fragment, without rendering it
+ *
+ * The literal nodes of the sections written by the context and of the fragments written in the slots are collected up
+ * to the truncate marker, the placeholders and the markers are skipped.
+ *
+ * @param fragment fragment whose literal text is collected
+ * @param context template context
+ * @param literals literal text returned by reference, views of the compiled templates and of the fragments
+ */
+void getTemplateLiterals(const templateFragmentStr& fragment, const templateContextStr& context, std::vector<std::string_view>& literals)
+{
+    if (!fragment.nodes) {
+        literals.push_back(fragment.text);
+        return;
+    }
+    bool stop = false;
+    getLiteralNodes(*fragment.nodes, fragment, context, stop, literals);
+}
+
+/**
+ * @brief Write the nodes of a fragment to a sink, used both to measure and to write the output
+ *
+ * @param nodes node vector of the fragment
+ * @param fragment fragment owning the placeholder values and the slot content
+ * @param context template context
+ * @param withSlotMarkers write the slot markers before their content
+ * @param stop set to true when the truncate marker is reached
+ * @param sink function called with each piece of output
+ */
+template <typename Sink>
+static void emitNodes(const std::vector<templateNodeStr>& nodes, const templateFragmentStr& fragment, const templateContextStr& context, const bool withSlotMarkers, bool& stop, Sink& sink);
+
+/**
+ * @brief Write a fragment to a sink
+ *
+ * @param fragment fragment to be written
+ * @param context template context
+ * @param withSlotMarkers write the slot markers before their content
+ * @param sink function called with each piece of output
+ */
+template <typename Sink>
+static void emitFragment(const templateFragmentStr& fragment, const templateContextStr& context, const bool withSlotMarkers, Sink& sink)
+{
+    if (!fragment.nodes) {
+        sink(fragment.text);
+        return;
+    }
+    bool stop = false;
+    emitNodes(*fragment.nodes, fragment, context, withSlotMarkers, stop, sink);
+}
+
+template <typename Sink>
+static void emitNodes(const std::vector<templateNodeStr>& nodes, const templateFragmentStr& fragment, const templateContextStr& context, const bool withSlotMarkers, bool& stop, Sink& sink)
+{
+    for (const auto& node : nodes) {
+        if (stop) {
+            return;
+        }
+        switch (node.type) {
+        case templateNodeType::literal:
+            sink(node.text);
+            break;
+        case templateNodeType::placeholder: {
+            auto it = fragment.values.find(node.text);
+            if (it != fragment.values.end()) {
+                sink(it->second);
+                break;
+            }
+            it = context.values.find(node.text);
+            sink(it != context.values.end() ? it->second : node.text);
+            break;
+        }
+        case templateNodeType::slot: {
+            if (withSlotMarkers) {
+                sink(node.text);
+            }
+            // each fragment is written right after the slot marker, so the last one written comes first
+            auto it = fragment.slotContent.find(&node);
+            if (it != fragment.slotContent.end()) {
+                for (auto rit = it->second.rbegin(); rit != it->second.rend(); ++rit) {
+                    emitFragment(*rit, context, withSlotMarkers, sink);
+                }
+            }
+            break;
+        }
+        case templateNodeType::section: {
+            if (node.text == context.truncateMarker) {
+                stop = true;
+                return;
+            }
+            bool keepMarkers;
+            if (!isSectionWritten(node, context, keepMarkers)) {
+                break;
+            }
+            if (keepMarkers) {
+                sink(node.text);
+            }
+            emitNodes(node.children, fragment, context, withSlotMarkers, stop, sink);
+            if (keepMarkers && !stop) {
+                sink(node.endMarker);
+            }
+            break;
+        }
+        }
+    }
+}
+
+/**
+ * @brief Render a fragment in a single pass
+ *
+ * @param fragment fragment to be rendered
+ * @param context template context
+ * @param withSlotMarkers write the slot markers before their content, as in the template
+ * @return std::string rendered code
+ */
+std::string renderTemplate(const templateFragmentStr& fragment, const templateContextStr& context, const bool withSlotMarkers)
+{
+    size_t size = 0;
+    auto measure = [&size](const std::string& text) { size += text.size(); };
+    emitFragment(fragment, context, withSlotMarkers, measure);
+
+    std::string output;
+    output.reserve(size);
+    auto write = [&output](const std::string& text) { output += text; };
+    emitFragment(fragment, context, withSlotMarkers, write);
+    return output;
+}
+/** @} */ // end of Template group
@@ -24,7 +24,7 @@ bool deleteElementAttribute(tinyxml2::XMLElement* element, const std::string& at
         element->DeleteAttribute(attribute.c_str());
         return true;
     } else {
-        std::cerr << "Attribute '" << attribute << "' of element '" << element->Value() << "' not found." << std::endl;
+        LOG_ERROR("Attribute '" << attribute << "' of element '" << element->Value() << "' not found.");
         return false;
     }
 }
@@ -56,13 +56,13 @@ bool deleteElementAttributeFromVector(std::vector<tinyxml2::XMLElement*>& elemen
 bool deleteElement(tinyxml2::XMLElement* element)
 {
     if (!element) {
-        std::cerr << "Invalid element." << std::endl;
+        LOG_ERROR("Invalid element.");
         return false;
     }
 
     tinyxml2::XMLNode* parent = element->Parent();
     if (!parent) {
-        std::cerr << "Element has no parent." << std::endl;
+        LOG_ERROR("Element has no parent.");
         return false;
     }
 
@@ -73,74 +73,20 @@ bool deleteElement(tinyxml2::XMLElement* element)
 }
 
 /**
- * @brief Deletes all elements in a vector
+ * @brief Replaces the tag name of a given XML element in place, attributes, text, comments and children are kept
  * 
- * @param elements vector of elements to delete 
- * @return bool Returns true if at least one element was successfully deleted, false otherwise
- */
-bool deleteElementFromVector(std::vector<tinyxml2::XMLElement*>& elements)
-{
-    // Check if the vector itself is empty
-    if (elements.empty()) {
-        std::cerr << "The vector is empty In function deleteElementFromVector." << std::endl;
-        return false;
-    }
-
-    bool deletedAny = false;
-
-    for (auto& element : elements) {
-        if (element) {  // Check if the element pointer is valid
-            if (deleteElement(element)) {
-                deletedAny = true;
-            }
-        } else {
-            std::cerr << "Encountered a null element pointer in the vector." << std::endl;
-        }
-    }
-
-    return deletedAny;
-}
-
-
-
-/**
- * @brief Replaces the tag name of a given XML element
- * 
- * @param doc XMLDocument to which the element belongs
  * @param element the element whose tag name needs to be changed
  * @param newTagName the new tag name
  * @return bool Returns true if the tag name was successfully changed
  */
-bool replaceTagName(tinyxml2::XMLDocument* doc, tinyxml2::XMLElement* element, const std::string& newTagName)
+bool replaceTagName(tinyxml2::XMLElement* element, const std::string& newTagName)
 {
-    if (!element || !doc) {
-        std::cerr << "Invalid document or element." << std::endl;
+    if (!element) {
+        LOG_ERROR("Invalid element.");
         return false;
     }
 
-    // Create a new element with the new tag name
-    tinyxml2::XMLElement* newElement = doc->NewElement(newTagName.c_str());
-
-    // Copy attributes from the old element to the new element
-    for (const tinyxml2::XMLAttribute* attr = element->FirstAttribute(); attr; attr = attr->Next()) {
-        newElement->SetAttribute(attr->Name(), attr->Value());
-    }
-
-    // Copy the text content of the old element to the new element
-    if (element->GetText()) {
-        newElement->SetText(element->GetText());
-    }
-
-    // Move child elements from the old element to the new element
-    for (tinyxml2::XMLElement* child = element->FirstChildElement(); child; ) {
-        tinyxml2::XMLElement* next = child->NextSiblingElement();
-        newElement->InsertEndChild(child);
-        child = next;
-    }
-
-    // Replace the old element with the new element in the document
-    element->Parent()->InsertAfterChild(element, newElement);
-    element->Parent()->DeleteChild(element);
+    element->SetName(newTagName.c_str());
 
     return true;
 }
@@ -157,14 +103,14 @@ bool replaceTagName(tinyxml2::XMLDocument* doc, tinyxml2::XMLElement* element, c
 bool replaceAttributeName(tinyxml2::XMLElement* element, const std::string& oldAttributeName, const std::string& newAttributeName)
 {
     if (!element) {
-        std::cerr << "Invalid element." << std::endl;
+        LOG_ERROR("Invalid element.");
         return false;
     }
 
     // Get the value of the old attribute
     const char* attributeValue = element->Attribute(oldAttributeName.c_str());
     if (!attributeValue) {
-        std::cerr << "Attribute '" << oldAttributeName << "' not found in element '" << element->Value() << "'" << std::endl;
+        LOG_ERROR("Attribute '" << oldAttributeName << "' not found in element '" << element->Value() << "'");
         return false;
     }
 
@@ -189,14 +135,14 @@ bool replaceAttributeName(tinyxml2::XMLElement* element, const std::string& oldA
 bool replaceAttributeValue(tinyxml2::XMLElement* element, const std::string& attributeName, const std::string& newValue)
 {
     if (!element) {
-        std::cerr << "Invalid element." << std::endl;
+        LOG_ERROR("Invalid element.");
         return false;
     }
 
     // Check if the attribute exists
     const char* attributeValue = element->Attribute(attributeName.c_str());
     if (!attributeValue) {
-        std::cerr << "Attribute '" << attributeName << "' not found in element '" << element->Value() << "'" << std::endl;
+        LOG_ERROR("Attribute '" << attributeName << "' not found in element '" << element->Value() << "'");
         return false;
     }
 
@@ -208,186 +154,74 @@ bool replaceAttributeValue(tinyxml2::XMLElement* element, const std::string& att
 
 
 /**
- * @brief Replaces the tag name of all elements in a vector
+ * @brief Replaces the value of a given attribute if the current value contains a specific substring
  * 
- * @param doc XMLDocument to which the elements belong
- * @param elements vector of elements whose tag names need to be replaced
- * @param newTagName the new tag name to set
- * @return bool Returns true if at least one tag name was successfully changed, false otherwise
- */
-bool replaceTagNameFromVector(tinyxml2::XMLDocument* doc, std::vector<tinyxml2::XMLElement*>& elements, const std::string& newTagName)
-{
-    bool replacedAny = false;
-
-    for (auto& element : elements) {
-        if (element) {
-            if (replaceTagName(doc, element, newTagName)) {
-                replacedAny = true;
-            }
-        } else {
-            std::cerr << "Encountered a null element pointer in the vector." << std::endl;
-        }
-    }
-
-    return replacedAny;
-}
-
-/**
- * @brief Replaces an attribute name in all elements in a vector
- * 
- * @param elements vector of elements in which to replace the attribute name
- * @param oldAttributeName the current attribute name to be replaced
- * @param newAttributeName the new attribute name
- * @return bool Returns true if at least one attribute name was successfully replaced, false otherwise
- */
-bool replaceAttributeNameFromVector(std::vector<tinyxml2::XMLElement*>& elements, const std::string& oldAttributeName, const std::string& newAttributeName)
-{
-    bool replacedAny = false;
-
-    for (auto& element : elements) {
-        if (element) {
-            if (replaceAttributeName(element, oldAttributeName, newAttributeName)) {
-                replacedAny = true;
-            }
-        } else {
-            std::cerr << "Encountered a null element pointer in the vector." << std::endl;
-        }
-    }
-
-    return replacedAny;
-}
-
-/**
- * @brief Replaces the value of a given attribute in all elements in a vector
- * 
- * @param elements vector of elements in which to replace the attribute value
- * @param attributeName the name of the attribute to be updated
- * @param newValue the new value to set for the attribute
- * @return bool Returns true if at least one attribute value was successfully replaced, false otherwise
- */
-bool replaceAttributeValueFromVector(std::vector<tinyxml2::XMLElement*>& elements, const std::string& attributeName, const std::string& newValue)
-{
-    bool replacedAny = false;
-
-    for (auto& element : elements) {
-        if (element) {
-            if (replaceAttributeValue(element, attributeName, newValue)) {
-                replacedAny = true;
-            }
-        } else {
-            std::cerr << "Encountered a null element pointer in the vector." << std::endl;
-        }
-    }
-
-    return replacedAny;
-}
-
-
-/**
- * @brief Replaces the value of a given attribute in all elements in a vector if the current value contains a specific substring
- * 
- * @param elements vector of elements in which to replace the attribute value
+ * @param element the element whose attribute value needs to be changed
  * @param attributeName the name of the attribute to be updated
  * @param oldSubstring the substring to look for within the attribute value
  * @param newValue the new value to set for the attribute if the substring is found
- * @return bool Returns true if at least one attribute value was successfully replaced, false otherwise
+ * @return bool Returns true if the attribute value was replaced, false otherwise
  */
-bool replaceAttributeValueContaingFromVector(std::vector<tinyxml2::XMLElement*>& elements, const std::string& attributeName, const std::string& oldSubstring, const std::string& newValue)
+bool replaceAttributeValueContaining(tinyxml2::XMLElement* element, const std::string& attributeName, const std::string& oldSubstring, const std::string& newValue)
 {
-    bool replacedAny = false;
-    for (auto& element : elements) {
-        if (element) {
-            const char* attributeValue = element->Attribute(attributeName.c_str());
-            if (attributeValue) {
-                std::string attributeStr(attributeValue);
-                if (attributeStr.find(oldSubstring) != std::string::npos) {
-                    if (replaceAttributeValue(element, attributeName, newValue)) {
-                        replacedAny = true;
-                    }
-                }
-            } else {
-                std::cerr << "Attribute '" << attributeName << "' not found in element." << std::endl;
-            }
-        } else {
-            std::cerr << "Encountered a null element pointer in the vector." << std::endl;
-        }
+    const char* attributeValue = element->Attribute(attributeName.c_str());
+    if (!attributeValue) {
+        LOG_ERROR("Attribute '" << attributeName << "' not found in element.");
+        return false;
     }
-
-    return replacedAny;
+    if (std::string(attributeValue).find(oldSubstring) == std::string::npos) {
+        return false;
+    }
+    return replaceAttributeValue(element, attributeName, newValue);
 }
 
 /**
- * @brief Replaces a substring within the value of a given attribute in all elements in a vector if the current value contains a specific substring
+ * @brief Replaces the first occurrence of a substring within the value of a given attribute
  * 
- * @param elements vector of elements in which to replace the attribute value
+ * @param element the element whose attribute value needs to be changed
  * @param attributeName the name of the attribute to be updated
  * @param oldSubstring the substring to look for within the attribute value
  * @param newSubstring the new substring to replace the old substring with
- * @return bool Returns true if at least one attribute value was successfully updated, false otherwise
+ * @return bool Returns true if the attribute value was updated, false otherwise
  */
-bool replaceAttributeValueSubstringFromVector(std::vector<tinyxml2::XMLElement*>& elements, const std::string& attributeName, const std::string& oldSubstring, const std::string& newSubstring)
+bool replaceAttributeValueSubstring(tinyxml2::XMLElement* element, const std::string& attributeName, const std::string& oldSubstring, const std::string& newSubstring)
 {
-    bool replacedAny = false;
-
-    for (auto& element : elements) {
-        if (element) {
-            const char* attributeValue = element->Attribute(attributeName.c_str());
-            if (attributeValue) {
-                std::string attributeStr(attributeValue);
-                // Check if the attribute value contains the substring
-                size_t pos = attributeStr.find(oldSubstring);
-                if (pos != std::string::npos) {
-                    // Replace the old substring with the new substring
-                    attributeStr.replace(pos, oldSubstring.length(), newSubstring);
-                    // Set the updated value for the attribute
-                    element->SetAttribute(attributeName.c_str(), attributeStr.c_str());
-                    replacedAny = true;
-                }
-            } else {
-                std::cerr << "Attribute '" << attributeName << "' not found in element." << std::endl;
-            }
-        } else {
-            std::cerr << "Encountered a null element pointer in the vector." << std::endl;
-        }
+    const char* attributeValue = element->Attribute(attributeName.c_str());
+    if (!attributeValue) {
+        LOG_ERROR("Attribute '" << attributeName << "' not found in element.");
+        return false;
     }
-
-    return replacedAny;
+    std::string attributeStr(attributeValue);
+    // Check if the attribute value contains the substring
+    size_t pos = attributeStr.find(oldSubstring);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    // Replace the old substring with the new substring
+    attributeStr.replace(pos, oldSubstring.length(), newSubstring);
+    element->SetAttribute(attributeName.c_str(), attributeStr.c_str());
+    return true;
 }
 
-
-
 /**
- * @brief Appends a substring to the end of the value of a given attribute in all elements in a vector
+ * @brief Appends a substring to the end of the value of a given attribute
  * 
- * @param elements vector of elements in which to append the attribute value
+ * @param element the element whose attribute value needs to be changed
  * @param attributeName the name of the attribute to be updated
  * @param valueToAppend the substring to append to the attribute value
- * @return bool Returns true if at least one attribute value was successfully updated, false otherwise
+ * @return bool Returns true if the attribute value was updated, false otherwise
  */
-bool appendAttributeValueFromVector(std::vector<tinyxml2::XMLElement*>& elements, const std::string& attributeName, const std::string& valueToAppend)
+bool appendAttributeValue(tinyxml2::XMLElement* element, const std::string& attributeName, const std::string& valueToAppend)
 {
-    bool updatedAny = false;
-
-    for (auto& element : elements) {
-        if (element) {
-            // Get the current attribute value
-            const char* attributeValue = element->Attribute(attributeName.c_str());
-            if (attributeValue) {
-                std::string attributeStr(attributeValue);
-                // Append the new value to the end of the current value
-                attributeStr.append(valueToAppend);
-                // Set the updated value for the attribute
-                element->SetAttribute(attributeName.c_str(), attributeStr.c_str());
-                updatedAny = true;
-            } else {
-                std::cerr << "Attribute '" << attributeName << "' not found in element." << std::endl;
-            }
-        } else {
-            std::cerr << "Encountered a null element pointer in the vector." << std::endl;
-        }
+    const char* attributeValue = element->Attribute(attributeName.c_str());
+    if (!attributeValue) {
+        LOG_ERROR("Attribute '" << attributeName << "' not found in element.");
+        return false;
     }
-
-    return updatedAny;
+    std::string attributeStr(attributeValue);
+    attributeStr.append(valueToAppend);
+    element->SetAttribute(attributeName.c_str(), attributeStr.c_str());
+    return true;
 }
 
 /**
@@ -418,14 +252,14 @@ bool appendAttributeValueLocationFromVector(std::vector<tinyxml2::XMLElement*>&
                 updatedAny = true;
             } else {
                 if (!attributeValue) {
-                    std::cerr << "Attribute '" << attributeName << "' not found in element." << std::endl;
+                    LOG_ERROR("Attribute '" << attributeName << "' not found in element.");
                 }
                 if (!locationValue) {
-                    std::cerr << "Location attribute not found in element." << std::endl;
+                    LOG_ERROR("Location attribute not found in element.");
                 }
             }
         } else {
-            std::cerr << "Encountered a null element pointer in the vector." << std::endl;
+            LOG_ERROR("Encountered a null element pointer in the vector.");
         }
     }
 
@@ -463,10 +297,10 @@ bool appendIfContainsSubstringVector(std::vector<tinyxml2::XMLElement*>& element
                     updatedAny = true;
                 }
             } else {
-                std::cerr << "Attribute or location value'" << attributeName << "' not found in element." << std::endl;
+                LOG_ERROR("Attribute or location value'" << attributeName << "' not found in element.");
             }
         } else {
-            std::cerr << "Encountered a null element pointer in the vector." << std::endl;
+            LOG_ERROR("Encountered a null element pointer in the vector.");
         }
     }
 
@@ -475,80 +309,49 @@ bool appendIfContainsSubstringVector(std::vector<tinyxml2::XMLElement*>& element
 
 
 /**
- * @brief Find a XML element by tag and attribute name where the attribute's value contains a specific substring
+ * @brief replaces the value of the event attribute of an element from / to .
  * 
- * @param root root element from which to start the search
- * @param tag tag name to look for
- * @param attributeName attribute name to look for inside the tag
- * @param substring substring to check for in the attribute value
- * @param element element found returned by reference
- * @return true if an element with the tag and attribute containing the substring is found
- * @return false otherwise
+ * @param element element in which to replace the event value
  */
-bool findElementByTagAndAttValueContaining(tinyxml2::XMLElement* root, const std::string& tag, const std::string& attributeName, const std::string& substring, tinyxml2::XMLElement*& element)
-{
-    for (tinyxml2::XMLElement* child = root->FirstChildElement(); child; child = child->NextSiblingElement()) {
-        if (strcmp(child->Value(), tag.c_str()) == 0) {
-            const char* attributeValue = child->Attribute(attributeName.c_str());
-            if (attributeValue && std::string(attributeValue).find(substring) != std::string::npos) {
-                element = child;
-                return true;
-            }
-        }
-        if (findElementByTagAndAttValueContaining(child, tag, attributeName, substring, element)) {
-            return true;
-        }
-    }
-    return false;
-}
-
-/**
- * @brief replaces the value of the event attribute in all elements in a vector from / to .
- * 
- * @param elements vector of elements in which to replace the event value
- */
-void replaceEventValueFromVectorFromSlashToPoint(std::vector<tinyxml2::XMLElement*>& elements)
+void replaceEventValueFromSlashToPoint(tinyxml2::XMLElement* element)
 {
     std::string eventName;
-    for (auto& element : elements) 
-    {
-        getElementAttValue(element, "event", eventName);
-        std::string temp = eventName;
-        std::cout << "Event before replacement: " << temp << std::endl;
-        size_t pos = 0;
-        if (temp == ""){
-            std::cerr << "Input DataType has no value" << std::endl;
-        }
-        else if(temp.find("/") == std::string::npos){
-            std::cerr << "Input DataType has no / to replace" << std::endl;
-        }
-        if(temp.find("/") == 0){
-            std::cerr << "Input DataType starts with /, removing it" << std::endl;
-            temp.replace(0, 1, "");
-            pos = 0;
-        }
+    getElementAttValue(element, "event", eventName);
+    std::string temp = eventName;
+    LOG_DEBUG("Event before replacement: " << temp);
+    size_t pos = 0;
+    if (temp == ""){
+        LOG_ERROR("Input DataType has no value");
+    }
+    else if(temp.find("/") == std::string::npos){
+        LOG_DEBUG("Input DataType has no / to replace");
+    }
+    if(temp.find("/") == 0){
+        LOG_DEBUG("Input DataType starts with /, removing it");
+        temp.replace(0, 1, "");
+        pos = 0;
+    }
 
-        // Replace all occurrences of '/' with '.'
-        while ((pos = temp.find("/")) != std::string::npos) {
-            temp.replace(pos, 1, ".");
-            pos += 1; // Move past the replaced character
-        }
-        
-        // else{
-        //     if((pos = temp.find("/", pos)) != std::string::npos)
-        //     {
-        //         temp.replace(pos, 1, "");
-        //         pos += 1;
-        //     }
-        //     if((pos = temp.find("/", pos)) != std::string::npos)
-        //     {
-        //         temp.replace(pos, 1, ".");
-        //         pos += 1;
-        //     }
-        // }
-        std::cout << "Event after replacement: " << temp << std::endl;
-        replaceAttributeValue(element, "event", temp);
+    // Replace all occurrences of '/' with '.'
+    while ((pos = temp.find("/")) != std::string::npos) {
+        temp.replace(pos, 1, ".");
+        pos += 1; // Move past the replaced character
     }
+    
+    // else{
+    //     if((pos = temp.find("/", pos)) != std::string::npos)
+    //     {
+    //         temp.replace(pos, 1, "");
+    //         pos += 1;
+    //     }
+    //     if((pos = temp.find("/", pos)) != std::string::npos)
+    //     {
+    //         temp.replace(pos, 1, ".");
+    //         pos += 1;
+    //     }
+    // }
+    LOG_DEBUG("Event after replacement: " << temp);
+    replaceAttributeValue(element, "event", temp);
 }
 
 
@@ -559,11 +362,11 @@ void replaceEventValueFromVectorFromSlashToPoint(std::vector<tinyxml2::XMLElemen
  * @param skillData skill data structure passed by reference where the skill data is stored
  * @return bool 
  */
-bool getDataFromRootNameHighLevel(const std::string attributeName, skillDataStr& skillData)
+bool getDataFromRootNameHighLevel(const std::string& attributeName, skillDataStr& skillData)
 {
     // e.g. attributeName = "FirstTemplateSkill"
     if (attributeName != ""){
-        add_to_log("Root attribute name: " + attributeName);
+        LOG_DEBUG("Root attribute name: " << attributeName);
         size_t dotPos = attributeName.find("Skill");
         if (dotPos != std::string::npos){
             skillData.SMName = attributeName; // e.g. SMName = "FirstTemplateSkill" +"Action" added later
@@ -572,12 +375,12 @@ bool getDataFromRootNameHighLevel(const std::string attributeName, skillDataStr&
             turnToSnakeCase(skillData.className, skillData.classNameSnakeCase);
         }
         else{
-            std::cerr << "Skill name not found" << std::endl;
+            LOG_ERROR("Skill name not found");
             return false;
         }
     } 
     else{
-        std::cerr << "Attribute 'name' not found or has no value" << std::endl;
+        LOG_ERROR("Attribute 'name' not found or has no value");
         return false;
     }
     return true;
@@ -587,44 +390,168 @@ bool getDataFromRootNameHighLevel(const std::string attributeName, skillDataStr&
  * @brief read the high level xml file
  * 
  * @param doc XMLDocument to load the file
- * @param fileContent string to store the file content
  * @param fileName file name to read
  * @return true if the file is read successfully
  */
-bool readHLXMLFile(tinyxml2::XMLDocument& doc, std::string& fileContent, const std::string fileName){
-    add_to_log("readFile");
-    add_to_log("opening file: " + fileName + " at line " + std::to_string(__LINE__));
-    if (doc.LoadFile(fileName.c_str()) != tinyxml2::XML_SUCCESS) {
-        std::cerr << "Failed to load '" << fileName << "' file" << std::endl;
-        return false;
-    }
-    if(!readTemplateFile(fileName, fileContent)){
-        std::cerr << "Failed to read '" << fileName << "' file" << std::endl;
-        return false;
-    }
-    return true;
+bool readHLXMLFile(tinyxml2::XMLDocument& doc, const std::string fileName){
+    TRACE_PHASE_DETAIL("readHLXMLFile", fileName);
+    LOG_DEBUG("readFile");
+    LOG_DEBUG("opening file: " << fileName << " at line " << __LINE__);
+    return parseInputFile(doc, fileName);
 }
 
 void insertElementAfter(tinyxml2::XMLElement* parent, tinyxml2::XMLElement* referenceElement, tinyxml2::XMLElement* newElement) {
     if (parent && referenceElement && newElement) {
         parent->InsertAfterChild(referenceElement, newElement);
     } else {
-        std::cerr << "Errore: parent, referenceElement o newElement è nullo.\n";
+        LOG_ERROR("Parent, reference element or new element is null.");
     }
 }
 
-bool translateRosActionHandleGoalResponseTag(tinyxml2::XMLElement* root, std::map<std::string, std::string> nameToActionNameMap)
+/**
+ * @brief Replaces an element with two transitions to its "accept" and "reject" states, the event value is used for both
+ * 
+ * @param element element to be replaced (e.g. ros_action_handle_goal_response)
+ * @return bool Returns true if the element was replaced
+ */
+bool splitAcceptRejectElement(tinyxml2::XMLElement* element)
 {
-    std::vector<tinyxml2::XMLElement*> actionHandleGoalRspVector;
-    findElementVectorByTag(root, std::string("ros_action_handle_goal_response"), actionHandleGoalRspVector);
-
-    if (actionHandleGoalRspVector.empty()) {
-        std::cerr << "The vector is empty in function translateRosActionHandleGoalResponseTag." << std::endl;
-        return false; 
+    const char* newEventValue = element->Attribute("event");
+    const char* acceptState = element->Attribute("accept");
+    const char* rejectState = element->Attribute("reject");
+    if (!newEventValue || !acceptState || !rejectState) {
+        LOG_DEBUG("Attributi mancanti: event, accept o reject.");
+        return false;
     }
+    std::string eventStr(newEventValue);
+
+    // Crea il nodo <transition> per "accept"
+    tinyxml2::XMLElement* acceptTransition = element->GetDocument()->NewElement("transition");
+    acceptTransition->SetAttribute("event", (eventStr ).c_str());
+    acceptTransition->SetAttribute("cond", "_event.data.is_ok");
+    acceptTransition->SetAttribute("target", acceptState);
+
+    // Crea il nodo <transition> per "reject"
+    tinyxml2::XMLElement* rejectTransition = element->GetDocument()->NewElement("transition");
+    rejectTransition->SetAttribute("event", (eventStr).c_str());
+    rejectTransition->SetAttribute("cond", "_event.data.is_ok == false");
+    rejectTransition->SetAttribute("target", rejectState);
+
+    // Ottieni il genitore dell'elemento corrente
+    tinyxml2::XMLElement* parent = element->Parent()->ToElement();
+
+    // Inserisci i nuovi elementi dopo l'elemento corrente
+    insertElementAfter(parent, element, acceptTransition);
+    insertElementAfter(parent, acceptTransition, rejectTransition);
 
-    replaceAttributeNameFromVector(actionHandleGoalRspVector, "name", "event");
-    for(auto& element : actionHandleGoalRspVector){
+    // Rimuovi l'elemento originale
+    parent->DeleteChild(element);
+    return true;
+}
+
+/**
+ * @brief Get the table of the rules translating the High-Level tags to SCXML, indexed by tag name
+ * 
+ * @return const std::map<std::string, translationRuleStr>& translation rules
+ */
+const std::map<std::string, translationRuleStr>& getTranslationRules()
+{
+    static const std::map<std::string, translationRuleStr> rules = [] {
+        const std::pair<std::string, std::string> nameToEvent{"name", "event"};
+        std::map<std::string, translationRuleStr> table;
+
+        // Declarations, not part of the state machine
+        table["ros_service_server"].deleteElement = true;
+        table["ros_topic_subscriber"].deleteElement = true;
+        table["ros_service_client"].deleteElement = true;
+        table["ros_topic_publisher"].deleteElement = true;
+        table["ros_action_client"].deleteElement = true;
+
+        table["data"].deletedAttributes = {"type"};
+        table["assign"].substitutions = {
+            {"expr", "_msg.", "_event.data."},
+            {"expr", "_res.", "_event.data."},
+            {"expr", "_feedback.", "_event.data."},
+            {"expr", "_wrapped_result.result.", "_event.data."}};
+
+        translationRuleStr& srvHndlReq = table["ros_service_handle_request"];
+        srvHndlReq.newTagName = "transition";
+        srvHndlReq.attributeRenames = {nameToEvent};
+        srvHndlReq.eventValueContaining = {{"tick", cmdTick}, {"halt", cmdHalt}};
+
+        translationRuleStr& srvSendReq = table["ros_service_send_request"];
+        srvSendReq.newTagName = "send";
+        srvSendReq.attributeRenames = {nameToEvent};
+        srvSendReq.eventSlashToPoint = true;
+        srvSendReq.eventSuffix = ".Call";
+        srvSendReq.fieldsToParam = true;
+
+        translationRuleStr& srvHndlRsp = table["ros_service_handle_response"];
+        srvHndlRsp.newTagName = "transition";
+        srvHndlRsp.attributeRenames = {nameToEvent};
+        srvHndlRsp.substitutions = {{"cond", "_res.", "_event.data."}};
+        srvHndlRsp.eventSlashToPoint = true;
+        srvHndlRsp.eventSuffix = ".Return";
+
+        translationRuleStr& srvSendRsp = table["ros_service_send_response"];
+        srvSendRsp.newTagName = "send";
+        srvSendRsp.attributeRenames = {nameToEvent};
+        srvSendRsp.eventValueContaining = {{"tick", rspTick}, {"halt", rspHalt}};
+        srvSendRsp.fieldsToParam = true;
+
+        translationRuleStr& topicCallback = table["ros_topic_callback"];
+        topicCallback.newTagName = "transition";
+        topicCallback.attributeRenames = {nameToEvent};
+        topicCallback.eventSlashToPoint = true;
+        topicCallback.eventSuffix = ".Sub";
+
+        // Action events are named after the action client, mapped to the action name
+        const std::vector<std::tuple<std::string, std::string, std::string>> actionRules = {
+            {"ros_action_send_goal", "send", ".SendGoal"},
+            {"ros_action_handle_goal_response", "", ".GoalResponse"},
+            {"ros_action_handle_feedback", "transition", ".FeedbackReturn"},
+            {"ros_action_handle_success_result", "transition", ".ResultResponse"},
+            {"ros_action_handle_cancel_result", "transition", ".CancelResult"},
+            {"ros_action_send_cancel", "send", ".SendCancel"}};
+        for (const auto& [tag, newTagName, eventSuffix] : actionRules) {
+            translationRuleStr& actionRule = table[tag];
+            actionRule.newTagName = newTagName;
+            actionRule.attributeRenames = {nameToEvent};
+            actionRule.mapActionName = true;
+            actionRule.eventSlashToPoint = true;
+            actionRule.eventSuffix = eventSuffix;
+        }
+        table["ros_action_send_goal"].fieldsToParam = true;
+        table["ros_action_handle_goal_response"].splitAcceptReject = true;
+        return table;
+    }();
+    return rules;
+}
+
+/**
+ * @brief Apply a translation rule to an element
+ * 
+ * @param element element to be translated, it is deleted if the rule deletes or splits it
+ * @param rule translation rule of the element tag
+ * @param nameToActionNameMap map from the action client name to the action name
+ */
+void applyTranslationRule(tinyxml2::XMLElement* element, const translationRuleStr& rule, const std::map<std::string, std::string>& nameToActionNameMap)
+{
+    TRACE_PHASE_DETAIL("applyTranslationRule", element->Value());
+    if (rule.deleteElement) {
+        deleteElement(element);
+        return;
+    }
+    for (const auto& attribute : rule.deletedAttributes) {
+        deleteElementAttribute(element, attribute);
+    }
+    for (const auto& [oldAttributeName, newAttributeName] : rule.attributeRenames) {
+        replaceAttributeName(element, oldAttributeName, newAttributeName);
+    }
+    for (const auto& [substring, newValue] : rule.eventValueContaining) {
+        replaceAttributeValueContaining(element, "event", substring, newValue);
+    }
+    if (rule.mapActionName) {
         const char* eventValue = element->Attribute("event");
         if (eventValue) {
             std::string eventStr(eventValue);
@@ -632,82 +559,262 @@ bool translateRosActionHandleGoalResponseTag(tinyxml2::XMLElement* root, std::ma
             if (it != nameToActionNameMap.end()) {
                 // Replacing the event value with the action name
                 element->SetAttribute("event", it->second.c_str());
-                add_to_log("Updating: " + eventStr + " -> " + it->second);
+                LOG_DEBUG("Updating: " << eventStr << " -> " << it->second);
             } else {
-                add_to_log("No update for: " + eventStr);
+                LOG_DEBUG("No update for: " << eventStr);
             }
         } else {
-            add_to_log("No 'event' attribute found");
+            LOG_DEBUG("No 'event' attribute found");
         }
-        replaceEventValueFromVectorFromSlashToPoint(actionHandleGoalRspVector);
-            appendAttributeValueFromVector(actionHandleGoalRspVector, "event", ".GoalResponse");
-        const char* newEventValue = element->Attribute("event");
-        const char* acceptState = element->Attribute("accept");
-        const char* rejectState = element->Attribute("reject");
-        if (newEventValue && acceptState && rejectState) {
-            std::string eventStr(newEventValue);
-
-            // Crea il nodo <transition> per "accept"
-            tinyxml2::XMLElement* acceptTransition = element->GetDocument()->NewElement("transition");
-            acceptTransition->SetAttribute("event", (eventStr ).c_str());
-            acceptTransition->SetAttribute("cond", "_event.data.is_ok");
-            acceptTransition->SetAttribute("target", acceptState);
-
-            // Crea il nodo <transition> per "reject"
-            tinyxml2::XMLElement* rejectTransition = element->GetDocument()->NewElement("transition");
-            rejectTransition->SetAttribute("event", (eventStr).c_str());
-            rejectTransition->SetAttribute("cond", "_event.data.is_ok == false");
-            rejectTransition->SetAttribute("target", rejectState);
-
-            // Ottieni il genitore dell'elemento corrente
-            tinyxml2::XMLElement* parent = element->Parent()->ToElement();
-
-            // Inserisci i nuovi elementi dopo l'elemento corrente
-            insertElementAfter(parent, element, acceptTransition);
-            insertElementAfter(parent, acceptTransition, rejectTransition);
-
-            // Rimuovi l'elemento originale
-            parent->DeleteChild(element);
-        } else {
-            add_to_log("Attributi mancanti: event, accept o reject.");
+    }
+    for (const auto& substitution : rule.substitutions) {
+        replaceAttributeValueSubstring(element, substitution.attributeName, substitution.oldSubstring, substitution.newSubstring);
+    }
+    if (rule.eventSlashToPoint) {
+        replaceEventValueFromSlashToPoint(element);
+    }
+    if (!rule.eventSuffix.empty()) {
+        appendAttributeValue(element, "event", rule.eventSuffix);
+    }
+    if (rule.fieldsToParam) {
+        for (tinyxml2::XMLElement* child = element->FirstChildElement(); child; child = nextElementInTree(element, child)) {
+            if (strcmp(child->Value(), "field") == 0) {
+                replaceTagName(child, "param");
+            }
         }
     }
-    return true;
+    if (rule.splitAcceptReject) {
+        splitAcceptRejectElement(element);
+        return;
+    }
+    if (!rule.newTagName.empty()) {
+        replaceTagName(element, rule.newTagName);
+    }
 }
 
+/**
+ * @brief Translate all the elements below root visiting the tree once, each element is translated with the rule of its tag
+ * 
+ * @param root root element of the High-Level SCXML
+ * @param nameToActionNameMap map from the action client name to the action name
+ */
+void translateElements(tinyxml2::XMLElement* root, const std::map<std::string, std::string>& nameToActionNameMap)
+{
+    TRACE_PHASE("translateElements");
+    const std::map<std::string, translationRuleStr>& rules = getTranslationRules();
+    tinyxml2::XMLElement* element = root->FirstChildElement();
+    size_t visitedElements = 0;
+    while (element) {
+        visitedElements++;
+        auto it = rules.find(element->Value());
+        if (it == rules.end()) {
+            element = nextElementInTree(root, element);
+            continue;
+        }
+        const translationRuleStr& rule = it->second;
+        // the element is removed from the tree, its subtree is skipped
+        if (rule.deleteElement || rule.splitAcceptReject) {
+            tinyxml2::XMLElement* next = nextElementAfterSubtree(root, element);
+            applyTranslationRule(element, rule, nameToActionNameMap);
+            element = next;
+            continue;
+        }
+        applyTranslationRule(element, rule, nameToActionNameMap);
+        element = nextElementInTree(root, element);
+    }
+    TRACE_COUNTER("elements visited", visitedElements);
+}
+
+/**
+ * @brief Print the banner of the generation of a skill
+ * 
+ * @param skillData skill data structure with the class name of the skill
+ * @param fileData file data structure with the output path
+ */
+static void printGenerationBanner(const skillDataStr& skillData, const fileDataStr& fileData)
+{
+    output_stream() << "-----------" << std::endl;
+    output_stream() << "Model2Code" << std::endl;
+    output_stream() << "Generating Skill-level code for: "<< skillData.className << std::endl; 
+    output_stream() << "Output directory: " << fileData.outputPath << std::endl;
+    output_stream() << "-----------" << std::endl;
+}
+
+/**
+ * @brief Get the comments written after the XML declaration of the translated SCXML
+ * 
+ * @param fileData file data structure with the generation datetime and the reproducible mode
+ * @return std::vector<std::string> text of the comments
+ */
+static std::vector<std::string> getTranslatedSMHeader(const fileDataStr& fileData)
+{
+    std::string currentDatetime = fileData.generationDatetime.empty() ? getGenerationDatetime(fileData.reproducible_mode) : fileData.generationDatetime;
+    return {" Autogenerated by model2code (https://github.com/convince-project/model2code) ",
+            " File autogenerated at " + currentDatetime + " ",
+            " This is an automatically generated file. "};
+}
+
+/**
+ * @brief Printer translating the High-Level elements while the document is printed, used by the --stream mode
+ * 
+ * Each element with a translation rule is copied (name and attributes only) to a scratch document and translated there
+ * with applyTranslationRule, so that the translated SCXML and the messages are the same as with translateElements,
+ * then printed in place of the element. The document is not modified.
+ */
+struct translationPrinterStr : public tinyxml2::XMLPrinter
+{
+    const std::map<std::string, translationRuleStr>& rules = getTranslationRules();
+    const std::map<std::string, std::string>& nameToActionNameMap;
+    std::vector<std::string> header; // comments printed after the XML declaration
+    tinyxml2::XMLDocument scratchDoc;
+    tinyxml2::XMLElement* scratchRoot = nullptr;
+    const tinyxml2::XMLElement* skippedElement = nullptr; // deleted or split element, its subtree is not printed
+    const tinyxml2::XMLElement* untranslatedElement = nullptr; // element whose subtree is printed as it is, as the failed splits of translateElements
+    std::vector<const tinyxml2::XMLElement*> fieldsToParamElements; // open elements whose field descendants are printed as param
+    bool headerPrinted = false;
+    size_t visitedElements = 0;
+
+    translationPrinterStr(FILE* file, const std::map<std::string, std::string>& nameToActionNameMap, std::vector<std::string> header)
+        : tinyxml2::XMLPrinter(file), nameToActionNameMap(nameToActionNameMap), header(std::move(header))
+    {
+        scratchRoot = scratchDoc.NewElement("scratch");
+        scratchDoc.InsertEndChild(scratchRoot);
+    }
+
+    /**
+     * @brief Open an element with the attributes of a translated element
+     * 
+     * @param name tag name, it must be valid until the element is closed
+     * @param translated translated element with the attributes to be printed
+     */
+    void openTranslatedElement(const char* name, const tinyxml2::XMLElement* translated)
+    {
+        OpenElement(name, CompactMode(*translated));
+        for (const tinyxml2::XMLAttribute* attribute = translated->FirstAttribute(); attribute; attribute = attribute->Next()) {
+            PushAttribute(attribute->Name(), attribute->Value());
+        }
+    }
+
+    bool Visit(const tinyxml2::XMLDeclaration& declaration) override
+    {
+        tinyxml2::XMLPrinter::Visit(declaration);
+        if (!headerPrinted) {
+            headerPrinted = true;
+            for (const auto& comment : header) {
+                PushComment(comment.c_str());
+            }
+        }
+        return true;
+    }
+
+    bool VisitEnter(const tinyxml2::XMLElement& element, const tinyxml2::XMLAttribute* attribute) override
+    {
+        // the root element is translated before printing
+        if (element.Parent() == element.GetDocument()) {
+            return tinyxml2::XMLPrinter::VisitEnter(element, attribute);
+        }
+        if (!fieldsToParamElements.empty() && strcmp(element.Name(), "field") == 0) {
+            openTranslatedElement("param", &element);
+            return true;
+        }
+        if (untranslatedElement) {
+            return tinyxml2::XMLPrinter::VisitEnter(element, attribute);
+        }
+        visitedElements++;
+        auto it = rules.find(element.Name());
+        if (it == rules.end()) {
+            return tinyxml2::XMLPrinter::VisitEnter(element, attribute);
+        }
+        const translationRuleStr& rule = it->second;
+        tinyxml2::XMLElement* translated = scratchDoc.NewElement(element.Name());
+        for (; attribute; attribute = attribute->Next()) {
+            translated->SetAttribute(attribute->Name(), attribute->Value());
+        }
+        scratchRoot->InsertEndChild(translated);
+        applyTranslationRule(translated, rule, nameToActionNameMap);
+
+        bool enter = true;
+        if (rule.deleteElement) {
+            skippedElement = &element;
+            enter = false;
+        }
+        else if (rule.splitAcceptReject && scratchRoot->FirstChildElement() != translated) {
+            // the element is replaced by its accept and reject transitions
+            for (tinyxml2::XMLElement* transition = scratchRoot->FirstChildElement(); transition; transition = transition->NextSiblingElement()) {
+                openTranslatedElement("transition", transition);
+                CloseElement(CompactMode(*transition));
+            }
+            skippedElement = &element;
+            enter = false;
+        }
+        else if (rule.splitAcceptReject) {
+            openTranslatedElement(element.Name(), translated);
+            untranslatedElement = &element;
+        }
+        else {
+            openTranslatedElement(rule.newTagName.empty() ? element.Name() : rule.newTagName.c_str(), translated);
+            if (rule.fieldsToParam) {
+                fieldsToParamElements.push_back(&element);
+            }
+        }
+        scratchRoot->DeleteChildren();
+        return enter;
+    }
+
+    bool VisitExit(const tinyxml2::XMLElement& element) override
+    {
+        if (&element == skippedElement) {
+            skippedElement = nullptr;
+            return true;
+        }
+        CloseElement(CompactMode(element));
+        if (&element == untranslatedElement) {
+            untranslatedElement = nullptr;
+        }
+        if (!fieldsToParamElements.empty() && fieldsToParamElements.back() == &element) {
+            fieldsToParamElements.pop_back();
+        }
+        return true;
+    }
+};
+
 /**
  * @brief translator function to translate the high level xml to scxml
  * 
  * @param fileData fileDataStr structure containing the input and output file names
+ * @param doc XMLDocument passed by reference where the translated SCXML is kept for the code generation, cleared with fileData.stream_mode
+ * @param translatedSMWritten result of the background write of the translated SCXML file
  * @return true if the translation is successful
  */
-bool Translator(fileDataStr& fileData){
-    add_to_log("-----------");
-    add_to_log("Translator");
+bool Translator(fileDataStr& fileData, tinyxml2::XMLDocument& doc, std::future<bool>& translatedSMWritten){
+    TRACE_PHASE("Translator");
+    LOG_DEBUG("-----------");
+    LOG_DEBUG("Translator");
     skillDataStr skillData;
-    tinyxml2::XMLDocument doc;
-    std::string fileContent;
-    if( !readHLXMLFile(doc, fileContent, fileData.inputFileName)){
+    if( !readHLXMLFile(doc, fileData.inputFileName)){
         return false;
     }
 
     // Get Root and SkillData
     tinyxml2::XMLElement* root = doc.RootElement();
     if (!root) {
-        std::cerr << "No root element found" << std::endl;
+        LOG_ERROR("No root element found");
         return false;
     }
     getDataFromRootNameHighLevel(root->Attribute("name"), skillData);
+    // Index the elements once for the queries done before the translation
+    elementIndexStr index;
+    buildElementIndex(root, index);
     // Get Skill Type
-    tinyxml2::XMLElement* haltServerElement;
-    if(findElementByTagAndAttValueContaining(root, std::string("ros_service_server"), std::string("type"), std::string("bt_interfaces_dummy/HaltAction"), haltServerElement) ||
-       findElementByTagAndAttValueContaining(root, std::string("ros_service_server"), std::string("type"), std::string("bt_interfaces/HaltAction"), haltServerElement))
+    tinyxml2::XMLElement* haltServerElement = nullptr;
+    if(findElementByTagAndTypeSuffix(index, "ros_service_server", "bt_interfaces_dummy/HaltAction", haltServerElement) ||
+       findElementByTagAndTypeSuffix(index, "ros_service_server", "bt_interfaces/HaltAction", haltServerElement))
     {
-        add_to_log("Halt found => Action Skill");
+        LOG_DEBUG("Halt found => Action Skill");
         skillData.skillType = "Action";
         fileData.is_action_skill = true;
     } else {
-        add_to_log("Halt not found => Condition Skill");
+        LOG_DEBUG("Halt not found => Condition Skill");
         skillData.skillType = "Condition"; 
         fileData.is_action_skill = false;
     }
@@ -719,242 +826,67 @@ bool Translator(fileDataStr& fileData){
     } 
     if(!replaceAttributeValue(root, "name", skillData.SMName))
     {
-        add_to_log("Could not replace name attribute for root element");
+        LOG_DEBUG("Could not replace name attribute for root element");
         return false;
     }
 
-    // Delete server and topic declarations
-    std::vector<tinyxml2::XMLElement*> serverVector;
-    
-    findElementVectorByTag(root, std::string("ros_service_server"), serverVector); 
-    findElementVectorByTag(root, std::string("ros_topic_subscriber"), serverVector);
-    findElementVectorByTag(root, std::string("ros_service_client"), serverVector); 
-    findElementVectorByTag(root, std::string("ros_topic_publisher"), serverVector); 
+    // Action client names, used to name the action events
     std::vector<tinyxml2::XMLElement*> actionVector;
-    findElementVectorByTag(root, std::string("ros_action_client"), actionVector);
+    findElementVectorByTag(index, "ros_action_client", actionVector);
     std::map<std::string, std::string> nameToActionNameMap;
-     for (tinyxml2::XMLElement* element : actionVector) {
+    for (tinyxml2::XMLElement* element : actionVector) {
         const char* name = element->Attribute("name");
         const char* actionName = element->Attribute("action_name");
 
         if (name && actionName) {
             nameToActionNameMap[name] = actionName;
         } else {
-            std::cerr << "Missing attribute in ros_action_client tag\n";
+            LOG_ERROR("Missing attribute in ros_action_client tag");
         }
     }
-    deleteElementFromVector(actionVector);
-    deleteElementFromVector(serverVector);
-    
+
     // add xmln
     replaceAttributeValue(root, "xmlns", "http://www.w3.org/2005/07/scxml");
 
-    // Delete attribute type from data elements
-    std::vector<tinyxml2::XMLElement*> dataVector;
-    findElementVectorByTag(root, std::string("data"), dataVector);
-    deleteElementAttributeFromVector(dataVector, "type");
-
-    // Translate elements with tag ros_service_handle_request 
-    std::vector<tinyxml2::XMLElement*> srvHndlReqVector;
-    findElementVectorByTag(root, std::string("ros_service_handle_request"), srvHndlReqVector);
-    replaceAttributeNameFromVector(srvHndlReqVector, "name", "event");
-    replaceAttributeValueContaingFromVector(srvHndlReqVector, "event", "tick", "CMD_TICK");
-    replaceAttributeValueContaingFromVector(srvHndlReqVector, "event", "halt", "CMD_HALT");
-    replaceTagNameFromVector(&doc, srvHndlReqVector, "transition");
-
-    // Translate elements with tag ros_service_send_request 
-    std::vector<tinyxml2::XMLElement*> srvSendReqVector;
-    findElementVectorByTag(root, std::string("ros_service_send_request"), srvSendReqVector);
-    replaceAttributeNameFromVector(srvSendReqVector, "name", "event");
-    replaceEventValueFromVectorFromSlashToPoint(srvSendReqVector);
-    appendAttributeValueFromVector(srvSendReqVector, "event", ".Call");
-    for (auto& element : srvSendReqVector) {
-        std::vector<tinyxml2::XMLElement*> srvSendReqFieldVector;
-        findElementVectorByTag(element, std::string("field"), srvSendReqFieldVector);
-        replaceTagNameFromVector(&doc, srvSendReqFieldVector, "param");
-    }
-    replaceTagNameFromVector(&doc, srvSendReqVector, "send");
-
-    // Translate elements with tag ros_service_handle_response 
-    std::vector<tinyxml2::XMLElement*> srvHndlRspVector;
-    findElementVectorByTag(root, std::string("ros_service_handle_response"), srvHndlRspVector);
-    replaceAttributeNameFromVector(srvHndlRspVector, "name", "event");
-    // replaceAttributeValueFromVector(srvHndlRspVector, "event", ""); get value e modificare le / con .
-    replaceAttributeValueSubstringFromVector(srvHndlRspVector, "cond", "_res.", "_event.data.");
-    replaceEventValueFromVectorFromSlashToPoint(srvHndlRspVector);
-    appendAttributeValueFromVector(srvHndlRspVector, "event", ".Return");
-    replaceTagNameFromVector(&doc, srvHndlRspVector, "transition");
-
-    // Translate elements with tag ros_service_send_response 
-    std::vector<tinyxml2::XMLElement*> srvSendRspVector;
-    findElementVectorByTag(root, std::string("ros_service_send_response"), srvSendRspVector);
-    replaceAttributeNameFromVector(srvSendRspVector, "name", "event");
-    replaceAttributeValueContaingFromVector(srvSendRspVector, "event", "tick", "TICK_RESPONSE"); 
-    replaceAttributeValueContaingFromVector(srvSendRspVector, "event", "halt", "HALT_RESPONSE"); 
-    for (auto& element : srvSendRspVector) {
-        std::vector<tinyxml2::XMLElement*> srvSendRspFieldVector;
-        findElementVectorByTag(element, std::string("field"), srvSendRspFieldVector);
-        replaceTagNameFromVector(&doc, srvSendRspFieldVector, "param");
-    }
-    replaceTagNameFromVector(&doc, srvSendRspVector, "send");
-
-    // Translate elements with tag ros_topic_callback 
-    std::vector<tinyxml2::XMLElement*> topicCallbackVector;
-    findElementVectorByTag(root, std::string("ros_topic_callback"), topicCallbackVector);
-    replaceAttributeNameFromVector(topicCallbackVector, "name", "event");
-    replaceEventValueFromVectorFromSlashToPoint(topicCallbackVector);
-    appendAttributeValueFromVector(topicCallbackVector, "event", ".Sub");
-    replaceTagNameFromVector(&doc, topicCallbackVector, "transition");
-
-    std::vector<tinyxml2::XMLElement*> assignVector;
-    findElementVectorByTag(root, std::string("assign"), assignVector);
-    // appendIfContainsSubstringVector(assignVector, "expr", "_msg.", ".");
-    replaceAttributeValueSubstringFromVector(assignVector, "expr", "_msg.", "_event.data.");
-    replaceAttributeValueSubstringFromVector(assignVector, "expr", "_res.", "_event.data.");
-    // appendAttributeValueFromVector(assignVector, "expr", ".");
-    // appendAttributeValueLocationFromVector(assignVector, "expr");
-
-    // Translate elements with tag ros_action_send_goal
-    std::vector<tinyxml2::XMLElement*> actionSendGoalVector;
-    findElementVectorByTag(root, std::string("ros_action_send_goal"), actionSendGoalVector);
-    replaceAttributeNameFromVector(actionSendGoalVector, "name", "event");
-    for (auto& element : actionSendGoalVector) {
-        const char* eventValue = element->Attribute("event");
-        if (eventValue) {
-            std::string eventStr(eventValue);
-            auto it = nameToActionNameMap.find(eventStr);
-            if (it != nameToActionNameMap.end()) {
-                // Replacing the event value with the action name
-                element->SetAttribute("event", it->second.c_str());
-                add_to_log("Updating: " + eventStr + " -> " + it->second);
-            } else {
-                add_to_log("No update for: " + eventStr);
-            }
-        } else {
-            add_to_log("No 'event' attribute found");
-        }
-    }    
-    replaceEventValueFromVectorFromSlashToPoint(actionSendGoalVector);
-    appendAttributeValueFromVector(actionSendGoalVector, "event", ".SendGoal");
-    for (auto& element : actionSendGoalVector) {
-        std::vector<tinyxml2::XMLElement*> actionFieldVector;
-        findElementVectorByTag(element, std::string("field"), actionFieldVector);
-        replaceTagNameFromVector(&doc, actionFieldVector, "param");
-    }
-    replaceTagNameFromVector(&doc, actionSendGoalVector, "send");
-
-    // Translate elements with tag ros_action_handle_goal_response
-    translateRosActionHandleGoalResponseTag(root, nameToActionNameMap);
-
-    //Translate elements with tag ros_action_handle_feedback
-    std::vector<tinyxml2::XMLElement*> actionHandleFeedbackVector;
-    findElementVectorByTag(root, std::string("ros_action_handle_feedback"), actionHandleFeedbackVector);
-    replaceAttributeNameFromVector(actionHandleFeedbackVector, "name", "event");
-    for (auto& element : actionHandleFeedbackVector) {
-        const char* eventValue = element->Attribute("event");
-        if (eventValue) {
-            std::string eventStr(eventValue);
-            auto it = nameToActionNameMap.find(eventStr);
-            if (it != nameToActionNameMap.end()) {
-                // Replacing the event value with the action name
-                element->SetAttribute("event", it->second.c_str());
-                add_to_log("Updating: " + eventStr + " -> " + it->second);
-            } else {
-                add_to_log("No update for: " + eventStr);
-            }
-        } else {
-            add_to_log("No 'event' attribute found");
-        }
-    }
-    replaceEventValueFromVectorFromSlashToPoint(actionHandleFeedbackVector);
-    appendAttributeValueFromVector(actionHandleFeedbackVector, "event", ".FeedbackReturn");
-    replaceTagNameFromVector(&doc, actionHandleFeedbackVector, "transition");
-    replaceAttributeValueSubstringFromVector(assignVector, "expr", "_feedback.", "_event.data.");
-
-    // Translate elements with tag ros_action_handle_success_result
-    std::vector<tinyxml2::XMLElement*> actionHandleSuccessResultVector;
-    findElementVectorByTag(root, std::string("ros_action_handle_success_result"), actionHandleSuccessResultVector);
-    replaceAttributeNameFromVector(actionHandleSuccessResultVector, "name", "event");
-    for (auto& element : actionHandleSuccessResultVector) {
-        const char* eventValue = element->Attribute("event");
-        if (eventValue) {
-            std::string eventStr(eventValue);
-            auto it = nameToActionNameMap.find(eventStr);
-            if (it != nameToActionNameMap.end()) {
-                // Replacing the event value with the action name
-                element->SetAttribute("event", it->second.c_str());
-                add_to_log("Updating: " + eventStr + " -> " + it->second);
-            } else {
-                add_to_log("No update for: " + eventStr);
-            }
-        } else {
-            add_to_log("No 'event' attribute found");
+    std::string ouputFilePath = fileData.outputPathSrc + skillData.className + "SM.scxml";
+    std::vector<std::string> header = getTranslatedSMHeader(fileData);
+    if(fileData.stream_mode && !get_generation_context().inMemory)
+    {
+        // The translated SCXML is written while translating, the Replacer reads it back from the written file
+        createDirectory(fileData.outputPath);
+        createDirectory(fileData.outputPathSrc);
+        FILE* outputStream = openOutputStream(fileData.outputPathSrc, skillData.className + "SM.scxml");
+        if(!outputStream)
+        {
+            return false;
         }
-    }
-    replaceEventValueFromVectorFromSlashToPoint(actionHandleSuccessResultVector);
-    appendAttributeValueFromVector(actionHandleSuccessResultVector, "event", ".ResultResponse");
-    replaceTagNameFromVector(&doc, actionHandleSuccessResultVector, "transition");
-    replaceAttributeValueSubstringFromVector(assignVector, "expr", "_wrapped_result.result.", "_event.data.");
-
-    // Translate elements with tag ros_action_handle_cancel_response
-    std::vector<tinyxml2::XMLElement*> actionHandleCancelResultVector;
-    findElementVectorByTag(root, std::string("ros_action_handle_cancel_result"), actionHandleCancelResultVector);
-    replaceAttributeNameFromVector(actionHandleCancelResultVector, "name", "event");
-    for (auto& element : actionHandleCancelResultVector) {
-        const char* eventValue = element->Attribute("event");
-        if (eventValue) {
-            std::string eventStr(eventValue);
-            auto it = nameToActionNameMap.find(eventStr);
-            if (it != nameToActionNameMap.end()) {
-                // Replacing the event value with the action name
-                element->SetAttribute("event", it->second.c_str());
-                add_to_log("Updating: " + eventStr + " -> " + it->second);
-            } else {
-                add_to_log("No update for: " + eventStr);
-            }
-        } else {
-            add_to_log("No 'event' attribute found");
+        {
+            TRACE_PHASE("translateElements");
+            translationPrinterStr printer(outputStream, nameToActionNameMap, std::move(header));
+            doc.Accept(&printer);
+            TRACE_COUNTER("elements visited", printer.visitedElements);
         }
+        printGenerationBanner(skillData, fileData);
+        std::promise<bool> written;
+        written.set_value(commitOutputStream(outputStream, "writeTranslatedSM", fileData.outputPathSrc, skillData.className + "SM.scxml"));
+        translatedSMWritten = written.get_future();
+        doc.Clear();
+        fileData.outputFileTranslatedSM = ouputFilePath;
+        return true;
     }
-    replaceEventValueFromVectorFromSlashToPoint(actionHandleCancelResultVector);
-    appendAttributeValueFromVector(actionHandleCancelResultVector, "event", ".CancelResult");
-    replaceTagNameFromVector(&doc, actionHandleCancelResultVector, "transition");
 
-    //Translate elements with tag ros_action_send_cancel
-    std::vector<tinyxml2::XMLElement*> actionSendCancelVector;
-    findElementVectorByTag(root, std::string("ros_action_send_cancel"), actionSendCancelVector);
-    replaceAttributeNameFromVector(actionSendCancelVector, "name", "event");
-    for (auto& element : actionSendCancelVector) {
-        const char* eventValue = element->Attribute("event");
-        if (eventValue) {
-            std::string eventStr(eventValue);
-            auto it = nameToActionNameMap.find(eventStr);
-            if (it != nameToActionNameMap.end()) {
-                // Replacing the event value with the action name
-                element->SetAttribute("event", it->second.c_str());
-                add_to_log("Updating: " + eventStr + " -> " + it->second);
-            } else {
-                add_to_log("No update for: " + eventStr);
-            }
-        } else {
-            add_to_log("No 'event' attribute found");
-        }
-    }
-    replaceEventValueFromVectorFromSlashToPoint(actionSendCancelVector);
-    appendAttributeValueFromVector(actionSendCancelVector, "event", ".SendCancel");
-    replaceTagNameFromVector(&doc, actionSendCancelVector, "send");
+    // Translate all the High-Level tags with the rule table
+    translateElements(root, nameToActionNameMap);
 
-    // doc.Print();
-    std::string ouputFilePath = fileData.outputPathSrc + skillData.className + "SM.scxml";
     tinyxml2::XMLPrinter printer;
     doc.Print(&printer);  // Print the XML document into the printer
     std::string outputContent = std::string(printer.CStr());
     
     // Add autogenerated header comment to SCXML (after XML declaration)
-    std::string currentDatetime = getCurrentDatetime();
-    std::string header = "<!-- Autogenerated by model2code (https://github.com/convince-project/model2code) -->\n";
-    header += "<!-- File autogenerated at " + currentDatetime + " -->\n";
-    header += "<!-- This is an automatically generated file. -->\n";
+    std::string headerComments;
+    for (const auto& comment : header) {
+        headerComments += "<!--" + comment + "-->\n";
+    }
     
     // Find the end of the XML declaration and insert comment after it
     size_t xmlDeclEnd = outputContent.find("?>");
@@ -963,21 +895,21 @@ bool Translator(fileDataStr& fileData){
         // Find the newline after the XML declaration
         size_t newlinePos = outputContent.find('\n', xmlDeclEnd);
         if (newlinePos != std::string::npos) {
-            outputContent.insert(newlinePos + 1, header);
+            outputContent.insert(newlinePos + 1, headerComments);
         } else {
-            outputContent.insert(xmlDeclEnd, "\n" + header);
+            outputContent.insert(xmlDeclEnd, "\n" + headerComments);
         }
     }
     
-    // add_to_log("-----------");
-    createDirectory(fileData.outputPath);
-    createDirectory(fileData.outputPathSrc);
-    std::cout << "-----------" << std::endl;
-    std::cout << "Model2Code" << std::endl;
-    std::cout << "Generating Skill-level code for: "<< skillData.className << std::endl; 
-    std::cout << "Output directory: " << fileData.outputPath << std::endl;
-    std::cout << "-----------" << std::endl;
-    writeFile(fileData.outputPathSrc, skillData.className + "SM.scxml", outputContent);
+    // LOG_DEBUG("-----------");
+    if(!get_generation_context().inMemory)
+    {
+        createDirectory(fileData.outputPath);
+        createDirectory(fileData.outputPathSrc);
+    }
+    printGenerationBanner(skillData, fileData);
+    // The SCXML file is only an output artifact, the generation uses doc
+    translatedSMWritten = queueOutputFiles("writeTranslatedSM", {{fileData.outputPathSrc, skillData.className + "SM.scxml", std::move(outputContent)}});
     fileData.outputFileTranslatedSM = ouputFilePath;
 
     return true;
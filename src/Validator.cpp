@@ -0,0 +1,402 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file Validator.cpp
+ * @brief This file contains the functions to check the input SCXML of a skill before its generation.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+
+#include "Validator.h"
+#include "ExtractFromElement.h"
+#include "InputFile.h"
+#include "InterfaceRegistry.h"
+#include <algorithm>
+#include <cstring>
+
+/**
+ * \defgroup Validator Validator
+ * The input SCXML of a skill is checked before its generation (--validate), so that the errors of the model are
+ * reported with their line instead of failing later in the build of the generated package. The elements are visited
+ * once, collecting the ids, the ROS declarations and the elements referring to them, then the references are resolved
+ * in the collected maps. The fields of the events and their types are checked against the specification when it is
+ * given (--model_filename).
+ * @{
+ */
+
+// ROS declarations and their attributes required by the generation, the first one names the declaration
+static const std::map<std::string_view, std::vector<const char*>> declarationAttributes = {
+    {"ros_service_server", {"service_name", "type"}},
+    {"ros_service_client", {"service_name", "type"}},
+    {"ros_topic_subscriber", {"topic", "type"}},
+    {"ros_topic_publisher", {"topic", "type"}},
+    {"ros_action_client", {"name", "action_name", "type"}}};
+
+// ROS events and the declaration named by their name attribute
+static const std::map<std::string_view, std::string_view> eventDeclarations = {
+    {"ros_service_handle_request", "ros_service_server"},
+    {"ros_service_send_response", "ros_service_server"},
+    {"ros_service_send_request", "ros_service_client"},
+    {"ros_service_handle_response", "ros_service_client"},
+    {"ros_service_handle_error", "ros_service_client"},
+    {"ros_topic_callback", "ros_topic_subscriber"},
+    {"ros_topic_publish", "ros_topic_publisher"},
+    {"ros_action_send_goal", "ros_action_client"},
+    {"ros_action_handle_goal_response", "ros_action_client"},
+    {"ros_action_handle_feedback", "ros_action_client"},
+    {"ros_action_handle_success_result", "ros_action_client"},
+    {"ros_action_handle_cancel_result", "ros_action_client"},
+    {"ros_action_send_cancel", "ros_action_client"}};
+
+struct validationStr{ // elements collected by the visit of the input SCXML, the views are strings of its document
+    std::vector<validationDiagnosticStr>& diagnostics;
+    std::map<std::string_view, tinyxml2::XMLElement*> states; // id -> state, parallel, final or history element
+    std::map<std::string_view, tinyxml2::XMLElement*> data; // id -> data element
+    std::map<std::string_view, std::map<std::string_view, tinyxml2::XMLElement*>> declarations; // tag -> name -> declaration
+    std::set<const tinyxml2::XMLElement*> usedDeclarations;
+    std::vector<std::pair<tinyxml2::XMLElement*, const char*>> stateReferences; // element and attribute naming states
+    std::vector<tinyxml2::XMLElement*> events; // ROS events, in document order
+    std::vector<tinyxml2::XMLElement*> assigns;
+
+    explicit validationStr(std::vector<validationDiagnosticStr>& diagnostics) : diagnostics(diagnostics) {}
+};
+
+/**
+ * @brief Add a diagnostic at the line of an element
+ *
+ * @param validation validation of the skill
+ * @param element element with the problem
+ * @param error true for an error, false for a warning
+ * @param message description of the problem
+ */
+static void addDiagnostic(validationStr& validation, const tinyxml2::XMLElement* element, bool error, const std::string& message)
+{
+    validation.diagnostics.push_back({element->GetLineNum(), error, message});
+}
+
+/**
+ * @brief Add an element to the map of its ids, a duplicate id is an error
+ *
+ * @param validation validation of the skill
+ * @param ids map of the ids of the same kind
+ * @param element element with the id
+ * @param id value of the id attribute
+ */
+static void addId(validationStr& validation, std::map<std::string_view, tinyxml2::XMLElement*>& ids, tinyxml2::XMLElement* element, std::string_view id)
+{
+    auto [it, inserted] = ids.try_emplace(id, element);
+    if (!inserted) {
+        addDiagnostic(validation, element, true, "duplicate " + std::string(element->Name()) + " id '" + std::string(id) + "', already used at line " + std::to_string(it->second->GetLineNum()));
+    }
+}
+
+/**
+ * @brief Collect an element of the input SCXML and check its own attributes
+ *
+ * @param validation validation of the skill
+ * @param element element to be collected
+ */
+static void collectElement(validationStr& validation, tinyxml2::XMLElement* element)
+{
+    std::string_view tag = element->Name();
+    const char* id = element->Attribute("id");
+    if (tag == "state" || tag == "parallel" || tag == "final" || tag == "history") {
+        if (id) {
+            addId(validation, validation.states, element, id);
+        }
+    }
+    else if (tag == "data") {
+        if (!id) {
+            addDiagnostic(validation, element, true, "data element without attribute 'id'");
+        }
+        else {
+            addId(validation, validation.data, element, id);
+        }
+    }
+    else if (tag == "assign") {
+        validation.assigns.push_back(element);
+    }
+    else if (tag == "field") {
+        for (const char* attribute : {"name", "expr"}) {
+            if (!element->Attribute(attribute)) {
+                addDiagnostic(validation, element, true, std::string("field element without attribute '") + attribute + "'");
+            }
+        }
+    }
+
+    if (tag == "transition" || (eventDeclarations.count(tag) && element->Attribute("target"))) {
+        validation.stateReferences.push_back({element, "target"});
+    }
+    if ((tag == "scxml" || tag == "state" || tag == "parallel") && element->Attribute("initial")) {
+        validation.stateReferences.push_back({element, "initial"});
+    }
+    if (tag == "ros_action_handle_goal_response") {
+        // the element is translated to a transition to each state
+        for (const char* attribute : {"accept", "reject"}) {
+            if (!element->Attribute(attribute)) {
+                addDiagnostic(validation, element, true, std::string("ros_action_handle_goal_response without attribute '") + attribute + "'");
+            }
+            else {
+                validation.stateReferences.push_back({element, attribute});
+            }
+        }
+    }
+
+    auto declaration = declarationAttributes.find(tag);
+    if (declaration != declarationAttributes.end()) {
+        for (const char* attribute : declaration->second) {
+            if (!element->Attribute(attribute)) {
+                addDiagnostic(validation, element, true, std::string(tag) + " without attribute '" + attribute + "'");
+            }
+        }
+        if (const char* name = element->Attribute(declaration->second.front())) {
+            auto [it, inserted] = validation.declarations[tag].try_emplace(name, element);
+            if (!inserted) {
+                addDiagnostic(validation, element, true, "duplicate " + std::string(tag) + " '" + name + "', already declared at line " + std::to_string(it->second->GetLineNum()));
+            }
+        }
+    }
+    else if (eventDeclarations.count(tag)) {
+        validation.events.push_back(element);
+    }
+}
+
+/**
+ * @brief Get the name of the datamodel variable of a location (e.g. "m_pose.x" -> "m_pose")
+ *
+ * @param location location of an assign element
+ * @return std::string_view name of the variable
+ */
+static std::string_view getLocationVariable(std::string_view location)
+{
+    return location.substr(0, location.find_first_of(".["));
+}
+
+/**
+ * @brief Get the kind of a datamodel or interface type, types of different kinds can not be assigned to each other
+ *
+ * @param type type name (e.g. "int8", "float32", "string")
+ * @return std::string_view "bool", "integer", "float" or "string", empty for an unknown type
+ */
+static std::string_view getTypeKind(std::string_view type)
+{
+    if (type == "bool" || type == "boolean") {
+        return "bool";
+    }
+    if (type.rfind("int", 0) == 0 || type.rfind("uint", 0) == 0 || type == "byte" || type == "char") {
+        return "integer";
+    }
+    if (type.rfind("float", 0) == 0 || type == "double") {
+        return "float";
+    }
+    if (type == "string" || type == "wstring") {
+        return "string";
+    }
+    return "";
+}
+
+/**
+ * @brief Check the fields of a ROS event against its function in the specification
+ *
+ * @param validation validation of the skill
+ * @param registry registry of the specification
+ * @param event ROS event element with its declaration
+ * @param name name of the event (e.g. "/BatteryComponent/battery_level")
+ */
+static void checkEventInterface(validationStr& validation, const interfaceRegistryStr& registry, tinyxml2::XMLElement* event, std::string_view name)
+{
+    std::string_view tag = event->Name();
+    const char* resultPrefix = tag == "ros_service_handle_response" ? "_res." : tag == "ros_topic_callback" ? "_msg." : nullptr;
+    if (tag != "ros_service_send_request" && !resultPrefix) {
+        return;
+    }
+    // "/componentName/functionName", as the events without a ROS element resolved by getInterfaceFromRegistry
+    size_t componentStart = name.find_first_not_of('/');
+    size_t componentEnd = name.find('/', componentStart);
+    if (componentStart == std::string_view::npos || componentEnd == std::string_view::npos) {
+        return;
+    }
+    std::string componentName(name.substr(componentStart, componentEnd - componentStart));
+    std::string functionName(name.substr(componentEnd + 1));
+    std::replace(functionName.begin(), functionName.end(), '/', '.');
+    const interfaceFunctionStr* function = findInterfaceFunction(registry, componentName, functionName);
+    if (!function) {
+        // the components of the skill itself (e.g. the tick and halt servers) are not in the specification
+        auto component = registry.componentInterfaces.find(componentName);
+        if (component != registry.componentInterfaces.end()) {
+            addDiagnostic(validation, event, true, "function '" + functionName + "' not found in interface '" + component->second + "' of component '" + componentName + "'");
+        }
+        return;
+    }
+    const std::string functionId = componentName + "." + functionName;
+
+    if (!resultPrefix) {
+        if (function->requestFields.empty()) {
+            return;
+        }
+        std::set<std::string_view> setFields;
+        for (tinyxml2::XMLElement* field = event->FirstChildElement("field"); field; field = field->NextSiblingElement("field")) {
+            const char* fieldName = field->Attribute("name");
+            if (!fieldName) {
+                continue;
+            }
+            setFields.insert(fieldName);
+            if (std::find(function->requestFields.begin(), function->requestFields.end(), fieldName) == function->requestFields.end()) {
+                addDiagnostic(validation, field, true, "unknown field '" + std::string(fieldName) + "' in the request of " + functionId);
+            }
+        }
+        for (const auto& requestField : function->requestFields) {
+            if (!setFields.count(requestField)) {
+                addDiagnostic(validation, event, false, "field '" + requestField + "' of the request of " + functionId + " is not set");
+            }
+        }
+        return;
+    }
+
+    for (tinyxml2::XMLElement* assign = event->FirstChildElement("assign"); assign; assign = assign->NextSiblingElement("assign")) {
+        const char* expr = assign->Attribute("expr");
+        const char* location = assign->Attribute("location");
+        if (!expr || strncmp(expr, resultPrefix, strlen(resultPrefix)) != 0) {
+            continue;
+        }
+        std::string_view field(expr + strlen(resultPrefix));
+        field = field.substr(0, field.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_"));
+        if (!function->returnFields.empty() && std::find(function->returnFields.begin(), function->returnFields.end(), field) == function->returnFields.end()) {
+            addDiagnostic(validation, assign, true, "unknown field '" + std::string(field) + "' in the result of " + functionId);
+            continue;
+        }
+        auto fieldType = function->interfaceData.find(std::string(field));
+        auto variable = location ? validation.data.find(getLocationVariable(location)) : validation.data.end();
+        const char* variableType = variable != validation.data.end() ? variable->second->Attribute("type") : nullptr;
+        if (fieldType == function->interfaceData.end() || !variableType) {
+            continue;
+        }
+        std::string_view fieldKind = getTypeKind(fieldType->second);
+        std::string_view variableKind = getTypeKind(variableType);
+        if (fieldKind.empty() || variableKind.empty() || fieldKind == variableKind) {
+            continue;
+        }
+        // the numbers and the booleans are converted by the generated code, a string is not
+        bool error = fieldKind == "string" || variableKind == "string";
+        addDiagnostic(validation, assign, error, "type mismatch: field '" + std::string(field) + "' of " + functionId + " is " + fieldType->second + ", datamodel variable '" + location + "' is " + variableType);
+    }
+}
+
+/**
+ * @brief Check the input SCXML of a skill: ids, state references, ROS declarations and their events, datamodel
+ * variables and, when the specification is given, the fields of the events and their types
+ *
+ * @param fileData file data structure of the skill with the input file name and the specification files
+ * @param diagnostics problems found passed by reference, sorted by line
+ * @return true if no error is found, the warnings do not stop the generation
+ * @return false if the file can not be parsed (the error is printed) or an error is found
+ */
+bool validateSkill(const fileDataStr& fileData, std::vector<validationDiagnosticStr>& diagnostics)
+{
+    TRACE_PHASE_DETAIL("validateSkill", fileData.inputFileName);
+    diagnostics.clear();
+    tinyxml2::XMLDocument doc;
+    if (!parseInputFile(doc, fileData.inputFileName)) {
+        return false;
+    }
+    tinyxml2::XMLElement* root = doc.RootElement();
+    if (!root) {
+        error_stream() << "No root element found in file: " << fileData.inputFileName << std::endl;
+        return false;
+    }
+    validationStr validation(diagnostics);
+    if (strcmp(root->Name(), "scxml") != 0) {
+        addDiagnostic(validation, root, true, "root element is '" + std::string(root->Name()) + "' instead of 'scxml'");
+    }
+    const char* rootName = root->Attribute("name");
+    if (!rootName || !strstr(rootName, "Skill")) {
+        addDiagnostic(validation, root, true, "the name of the root element must contain 'Skill' (e.g. name=\"BatteryLevelSkill\")");
+    }
+
+    // a single visit collects the elements, the references are resolved in the collected maps
+    size_t visitedElements = 0;
+    for (tinyxml2::XMLElement* element = root; element; element = nextElementInTree(root, element)) {
+        visitedElements++;
+        collectElement(validation, element);
+    }
+    TRACE_COUNTER("elements validated", visitedElements);
+
+    for (const auto& [element, attribute] : validation.stateReferences) {
+        std::istringstream states(element->Attribute(attribute));
+        std::string state;
+        while (states >> state) {
+            if (!validation.states.count(state)) {
+                addDiagnostic(validation, element, true, "unknown state '" + state + "' in attribute '" + attribute + "' of " + element->Name());
+            }
+        }
+    }
+
+    std::shared_ptr<const interfaceRegistryStr> registry = getInterfaceRegistry(fileData.modelFileName, fileData.interfaceFileName);
+    for (tinyxml2::XMLElement* event : validation.events) {
+        const char* name = event->Attribute("name");
+        if (!name) {
+            addDiagnostic(validation, event, true, std::string(event->Name()) + " without attribute 'name'");
+            continue;
+        }
+        std::string_view declarationTag = eventDeclarations.at(event->Name());
+        const auto& declarations = validation.declarations[declarationTag];
+        auto declaration = declarations.find(name);
+        if (declaration == declarations.end()) {
+            addDiagnostic(validation, event, true, std::string(event->Name()) + " '" + name + "' without a matching " + std::string(declarationTag));
+            continue;
+        }
+        validation.usedDeclarations.insert(declaration->second);
+        if (registry) {
+            checkEventInterface(validation, *registry, event, name);
+        }
+    }
+    for (const auto& [tag, declarations] : validation.declarations) {
+        for (const auto& [name, declaration] : declarations) {
+            if (!validation.usedDeclarations.count(declaration)) {
+                addDiagnostic(validation, declaration, false, std::string(tag) + " '" + std::string(name) + "' is declared but never used");
+            }
+        }
+    }
+
+    for (tinyxml2::XMLElement* assign : validation.assigns) {
+        const char* location = assign->Attribute("location");
+        if (!location) {
+            addDiagnostic(validation, assign, true, "assign element without attribute 'location'");
+        }
+        else if (!validation.data.count(getLocationVariable(location))) {
+            addDiagnostic(validation, assign, true, "assign to '" + std::string(location) + "', not declared in the datamodel");
+        }
+    }
+
+    std::stable_sort(diagnostics.begin(), diagnostics.end(), [](const validationDiagnosticStr& a, const validationDiagnosticStr& b) { return a.line < b.line; });
+    return std::none_of(diagnostics.begin(), diagnostics.end(), [](const validationDiagnosticStr& diagnostic) { return diagnostic.error; });
+}
+
+/**
+ * @brief Check the input SCXML of a skill and print the problems found as "file:line: error: message"
+ *
+ * @param fileData file data structure of the skill with the input file name and the specification files
+ * @return true if no error is found
+ * @return false if the file can not be parsed or an error is found
+ */
+bool validateSkill(const fileDataStr& fileData)
+{
+    std::vector<validationDiagnosticStr> diagnostics;
+    bool valid = validateSkill(fileData, diagnostics);
+    size_t errors = 0;
+    for (const auto& diagnostic : diagnostics) {
+        if (diagnostic.error) {
+            errors++;
+            error_stream() << fileData.inputFileName << ":" << diagnostic.line << ": error: " << diagnostic.message << std::endl;
+        }
+        // log_enabled is also true for the buffered log messages, the warnings are only printed at the warning level
+        else if (logConfig.level <= logLevel::warning) {
+            error_stream() << fileData.inputFileName << ":" << diagnostic.line << ": warning: " << diagnostic.message << std::endl;
+        }
+    }
+    output_stream() << "Validated " << fileData.inputFileName << ": " << errors << " errors, " << diagnostics.size() - errors << " warnings" << std::endl;
+    return valid;
+}
+/** @} */ // end of Validator group
@@ -10,7 +10,27 @@
  */
 
 // #include "Replacer.h"
-#include "Translator.h"
+#include "Model2Code.h"
+#include "Manifest.h"
+#include "Profile.h"
+#include <filesystem>
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <iomanip>
+#include <set>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
 
 /**
  * @brief Print the help message
@@ -21,16 +41,60 @@ void print_help()
     std::cout << "Welcome to model2code tool.\n";
     std::cout << "Usage:\n";
     std::cout << "model2code --input_filename \"inputFile.scxml\" ";
-    std::cout << "--model_filename \"projectModel.xml\" ";
-    std::cout << "--interface_filename \"interfaceFile.xml\" ";
-    std::cout << "--template_path \"path/to/template_skill/directory\" ";
+    std::cout << "--model_filename \"projectModel.xml\" [optional, its components and interfaces are used for the events without a ROS element in the SCXML] ";
+    std::cout << "--interface_filename \"interfaceFile.xml\" [default: the interfaces path of the model file] ";
+    std::cout << "--template_path \"path/to/template_skill/directory\" [default: the template_skill embedded at build time] ";
     std::cout << "--output_path \"path/to/output/directory\"\n";
-    std::cout << "--verbose_mode [to show log]\n";
+    std::cout << "--verbose_mode [to show log, same as --log_level debug]\n";
+    std::cout << "--log_level debug|info|warning|error|off [minimum level of the log messages shown, default warning]\n";
+    std::cout << "--log_buffer N [to keep the last N log messages of any level and show them when a skill fails]\n";
+    std::cout << "--batch \"path/to/scxml/directory\" or \"manifest.txt\" [to generate all the skills in one run, "
+                 "the manifest lists one input file per line, optionally followed by its output path]\n";
+    std::cout << "--force [to generate the skills even if their inputs did not change since the last generation]\n";
+    std::cout << "--reproducible [to write a fixed datetime (SOURCE_DATE_EPOCH or 1970-01-01) so that identical inputs give identical outputs]\n";
+    std::cout << "--fsync [to sync the generated files to disk before they replace the previous ones]\n";
+    std::cout << "--stream [to write the translated SCXML while translating, without keeping a translated copy of the model in memory]\n";
+    std::cout << "--validate [to check the input SCXML before the generation and print its errors with their line, a skill with errors is not generated]\n";
+    std::cout << "--cache [to keep the event data resolved from the input files in ~/.cache/model2code and reuse it while the inputs do not change]\n";
+    std::cout << "--cache_dir \"path/to/cache/directory\" [same as --cache with another directory]\n";
+    std::cout << "--cache_size MB [maximum size of the cache, the least recently used files are removed above it, default 64]\n";
+    std::cout << "--jobs N [number of skills generated in parallel in batch mode, 0 for one per core, default 1]\n";
+    std::cout << "--profile \"profile.json\" [to write the time of the generation phases as a Chrome trace and print the slowest ones, "
+                 "not in watch mode]\n";
+    std::cout << "--profile_top N [number of phases printed with --profile, default 10]\n";
+    std::cout << "--watch \"path/to/scxml/directory\" [to regenerate a skill when its SCXML file changes, "
+                 "and all the skills when the templates change]\n";
     // std::cout << "--datamodel_mode \n";
     // std::cout << "--translate_mode \n";
     // std::cout << "--generate_mode \n";
 }
 
+/**
+ * @brief Read the non-negative integer value of an option
+ * 
+ * @param option option name, for the error message
+ * @param value value of the option
+ * @param maximum maximum value accepted
+ * @param number value returned by reference
+ * @return true 
+ * @return false if the value is not a number or is above maximum, the error is printed
+ */
+template <typename T>
+static bool getOptionNumber(const std::string& option, const char* value, const T maximum, T& number)
+{
+    const char* end = value + std::strlen(value);
+    T parsed = 0;
+    auto [last, ec] = std::from_chars(value, end, parsed);
+    if(value == end || last != end || ec != std::errc() || parsed > maximum)
+    {
+        std::cerr << "Invalid value for " << option << ": " << value << std::endl;
+        std::cerr << "Run 'model2code --help' for instructions" << std::endl;
+        return false;
+    }
+    number = parsed;
+    return true;
+}
+
 /**
  * @brief Handle the inputs
  * 
@@ -44,13 +108,13 @@ void print_help()
 bool handleInputs(int argc, char* argv[], fileDataStr& fileData, templateFileDataStr& templateFileData)
 {
     // Default values
-    fileData.modelFileName          = modelFilePath;
-    fileData.interfaceFileName      = interfaceFilePath;
+    fileData.modelFileName          = ""; // no specification
+    fileData.interfaceFileName      = ""; // interfaces path of the model file
     fileData.datamodel_mode         = false;
     fileData.translate_mode         = false;
     fileData.generate_mode          = false;
     fileData.verbose_mode               = false;
-    templateFileData.templatePath   = templateFilePath;
+    templateFileData.templatePath   = ""; // embedded template_skill
 
     if (argc == 1)
     {
@@ -69,18 +133,44 @@ bool handleInputs(int argc, char* argv[], fileDataStr& fileData, templateFileDat
             fileData.inputFileName = argv[i+1];
             i++;
         }
+        else if (arg == "--batch" && i+1 < argc && argv[i+1][0] != '-') {
+            fileData.batchPath = argv[i+1];
+            i++;
+        }
+        else if (arg == "--profile" && i+1 < argc && argv[i+1][0] != '-') {
+            fileData.profileFile = argv[i+1];
+            i++;
+        }
+        else if (arg == "--profile_top" && i+1 < argc) {
+            if(!getOptionNumber(arg, argv[i+1], std::numeric_limits<size_t>::max(), fileData.profileTopCount))
+            {
+                return RETURN_CODE_ERROR;
+            }
+            i++;
+        }
+        else if (arg == "--watch" && i+1 < argc && argv[i+1][0] != '-') {
+            fileData.watchPath = argv[i+1];
+            i++;
+        }
+        else if (arg == "--jobs" && i+1 < argc) {
+            if(!getOptionNumber(arg, argv[i+1], std::numeric_limits<unsigned int>::max(), fileData.jobs))
+            {
+                return RETURN_CODE_ERROR;
+            }
+            i++;
+        }
         else if (arg == "--output_path" && i+1 < argc && argv[i+1][0] != '-') {
             fileData.outputPath = argv[i + 1];
             i++;
         }
-        // else if (arg == "--model_filename" && i+1 < argc && argv[i+1][0] != '-') {
-        //     fileData.modelFileName = argv[i + 1];
-        //     i++;
-        // }
-        // else if (arg == "--interface_filename" && i+1 < argc && argv[i+1][0] != '-') {
-        //     fileData.interfaceFileName = argv[i + 1];
-        //     i++;
-        // }
+        else if (arg == "--model_filename" && i+1 < argc && argv[i+1][0] != '-') {
+            fileData.modelFileName = argv[i + 1];
+            i++;
+        }
+        else if (arg == "--interface_filename" && i+1 < argc && argv[i+1][0] != '-') {
+            fileData.interfaceFileName = argv[i + 1];
+            i++;
+        }
         else if (arg == "--template_path" && i+1 < argc && argv[i+1][0] != '-') {
             templateFileData.templatePath = argv[i+1];
             i++;
@@ -96,10 +186,69 @@ bool handleInputs(int argc, char* argv[], fileDataStr& fileData, templateFileDat
         }
         else if (arg == "--verbose_mode") {
             fileData.verbose_mode = true;
+            logConfig.level = logLevel::debug;
+        }
+        else if (arg == "--log_level" && i+1 < argc) {
+            if(!getLogLevel(argv[i+1], logConfig.level))
+            {
+                std::cerr << "Invalid log level: " << argv[i+1] << std::endl;
+                std::cerr << "Run 'model2code --help' for instructions" << std::endl;
+                return RETURN_CODE_ERROR;
+            }
+            i++;
+        }
+        else if (arg == "--log_buffer" && i+1 < argc) {
+            if(!getOptionNumber(arg, argv[i+1], std::numeric_limits<size_t>::max(), logConfig.bufferSize))
+            {
+                return RETURN_CODE_ERROR;
+            }
+            i++;
+        }
+        else if (arg == "--force") {
+            fileData.force_mode = true;
+        }
+        else if (arg == "--reproducible") {
+            fileData.reproducible_mode = true;
+        }
+        else if (arg == "--fsync") {
+            fileData.fsync_mode = true;
+        }
+        else if (arg == "--stream") {
+            fileData.stream_mode = true;
+        }
+        else if (arg == "--validate") {
+            fileData.validate_mode = true;
+        }
+        else if (arg == "--cache") {
+            fileData.cacheDirectory = getDefaultCacheDirectory();
+            if(fileData.cacheDirectory == "")
+            {
+                std::cerr << "No cache directory: neither XDG_CACHE_HOME nor HOME is set, use --cache_dir" << std::endl;
+                return RETURN_CODE_ERROR;
+            }
+        }
+        else if (arg == "--cache_dir" && i+1 < argc && argv[i+1][0] != '-') {
+            fileData.cacheDirectory = argv[i+1];
+            i++;
+        }
+        else if (arg == "--cache_size" && i+1 < argc) {
+            // in MB, the size in bytes must fit in cacheSize
+            uintmax_t cacheSizeMB;
+            if(!getOptionNumber(arg, argv[i+1], std::numeric_limits<uintmax_t>::max() / (1024 * 1024), cacheSizeMB))
+            {
+                return RETURN_CODE_ERROR;
+            }
+            fileData.cacheSize = cacheSizeMB * 1024 * 1024;
+            i++;
         }
     }
-    add_to_log("Args" + fileData.datamodel_mode ? " with datamodel mode" : " without datamodel mode" + fileData.translate_mode ? " with translation mode" : " without translation mode" + fileData.generate_mode ? " with generation mode" : " without generation mode");
+    LOG_DEBUG("Args" << (fileData.datamodel_mode ? " with datamodel mode" : " without datamodel mode") << (fileData.translate_mode ? " with translation mode" : " without translation mode") << (fileData.generate_mode ? " with generation mode" : " without generation mode"));
     
+    if(fileData.batchPath != "" || fileData.watchPath != "")
+    {
+        // input and output paths are set for each skill of the batch
+        return RETURN_CODE_OK;
+    }
     if(fileData.inputFileName == "")
     {
         std::cout << "-----------" << std::endl;
@@ -107,28 +256,403 @@ bool handleInputs(int argc, char* argv[], fileDataStr& fileData, templateFileDat
         std::cerr << "Run 'model2code --help' for instructions" << std::endl;
         return RETURN_CODE_ERROR;
     }
-    if(fileData.outputPath == "")
+    return setOutputPaths(fileData);
+}
+
+/**
+ * @brief Write the profile of the generation and print its summary
+ * 
+ * @param fileData file data structure with the profile options
+ * @param events traced phases of the generation
+ * @param counters counters of the generation
+ * @return true 
+ * @return false if the profile can not be written
+ */
+bool writeGenerationProfile(const fileDataStr& fileData, const std::vector<traceEventStr>& events, const std::map<std::string, uint64_t>& counters)
+{
+    printProfileSummary(events, counters, fileData.profileTopCount);
+    if(!writeProfile(fileData.profileFile, events, counters))
+    {
+        return false;
+    }
+    output_stream() << "Profile written: " << fileData.profileFile << std::endl;
+    return true;
+}
+
+/**
+ * @brief Get the skills of a batch from a directory of SCXML files or from a manifest file
+ * 
+ * @param batchPath directory or manifest file, the manifest lists one input file per line optionally followed by its output path
+ * @param batchInputs input file and output path of each skill, the output path is empty if not provided
+ * @return true 
+ * @return false 
+ */
+bool getBatchInputs(const std::string& batchPath, std::vector<std::pair<std::string, std::string>>& batchInputs)
+{
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if(fs::is_directory(batchPath, ec))
+    {
+        for (const auto& entry : fs::directory_iterator(batchPath, ec)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".scxml") {
+                batchInputs.push_back({entry.path().string(), ""});
+            }
+        }
+        std::sort(batchInputs.begin(), batchInputs.end());
+    }
+    else
     {
-        add_to_log("-----------");
-        add_to_log("Output path not provided");
-        // std::cerr << "Output path not provided" << std::endl;
-        getPath(fileData.inputFileName, fileData.outputPath);
-        if(fileData.outputPath == "")
+        std::ifstream manifest(batchPath);
+        if(!manifest.is_open())
         {
-            std::cerr << "Not able to get output path from input file name" << std::endl;
-            std::cerr << "Run 'model2code --help' for instructions" << std::endl;
-            return RETURN_CODE_ERROR;
+            std::cerr << "Failed to open batch manifest: " << batchPath << std::endl;
+            return false;
+        }
+        // relative paths in the manifest are relative to the manifest directory
+        fs::path manifestDir = fs::path(batchPath).parent_path();
+        std::string line;
+        while (std::getline(manifest, line)) {
+            std::istringstream lineStream(line);
+            std::string inputFile, outputPath;
+            if (!(lineStream >> inputFile) || inputFile[0] == '#') {
+                continue;
+            }
+            lineStream >> outputPath;
+            batchInputs.push_back({(manifestDir / inputFile).string(), outputPath.empty() ? "" : (manifestDir / outputPath).string()});
+        }
+    }
+    if(ec)
+    {
+        std::cerr << "Failed to read batch directory: " << batchPath << " (" << ec.message() << ")" << std::endl;
+        return false;
+    }
+    if(batchInputs.empty())
+    {
+        std::cerr << "No SCXML file found in: " << batchPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Generate a skill of a batch, the messages are written in the generation context of the current thread
+ * 
+ * The files are written in background, the skill is completed by collectBatchSkill.
+ * 
+ * @param fileData file data structure with the options shared by all the skills, the output path is used as base directory
+ * @param batchInput input file and output path of the skill, the output path is empty if not provided
+ * @param templateFileData template file data structure, the templates are already read
+ * @param upToDate set to true if the skill is skipped as up to date
+ * @return true if the skill is generated successfully or is up to date
+ * @return false 
+ */
+bool generateBatchSkill(const fileDataStr& fileData, const std::pair<std::string, std::string>& batchInput, templateFileDataStr& templateFileData, bool& upToDate)
+{
+    const auto& [inputFile, outputPath] = batchInput;
+    fileDataStr skillFileData = fileData;
+    skillFileData.inputFileName = inputFile;
+    skillFileData.outputPath = outputPath;
+    if(outputPath == "" && fileData.outputPath != "")
+    {
+        // same layout as tests/test.sh: one snake case directory per skill
+        skillFileData.outputPath = fileData.outputPath + "/" + turnToSnakeCase(std::filesystem::path(inputFile).stem().string());
+    }
+    upToDate = false;
+    return !setOutputPaths(skillFileData) && generateSkill(skillFileData, templateFileData, upToDate);
+}
+
+/**
+ * @brief Wait for the files of a skill generated by generateBatchSkill and report its errors, in the generation context of the skill
+ * 
+ * @param inputFile SCXML file of the skill
+ * @param generated result of generateBatchSkill
+ * @return true if the skill is generated and its files are written
+ * @return false 
+ */
+bool collectBatchSkill(const std::string& inputFile, bool generated)
+{
+    generated = join_generation_tasks() && generated;
+    if(!generated)
+    {
+        error_stream() << "Error in the generation of: " << inputFile << std::endl;
+        print_log();
+    }
+    clear_log();
+    return generated;
+}
+
+/**
+ * @brief Generate all the skills of a batch in one run, the templates are read once and shared by all the skills
+ * 
+ * The skills are generated by fileData.jobs worker threads, each one taking the next skill of the batch when it is free.
+ * The workers do not wait for the files of their skill: the main thread collects the skills in the batch order, waiting
+ * for their files, and prints the messages buffered in their generation contexts, so the output does not depend on the
+ * number of jobs.
+ * 
+ * @param fileData file data structure with the options shared by all the skills, the output path is used as base directory
+ * @param templateFileData template file data structure
+ * @return int RETURN_CODE_OK if all the skills are generated, RETURN_CODE_ERROR otherwise
+ */
+int runBatch(const fileDataStr& fileData, templateFileDataStr& templateFileData)
+{
+    std::vector<std::pair<std::string, std::string>> batchInputs;
+    if(!getBatchInputs(fileData.batchPath, batchInputs))
+    {
+        return RETURN_CODE_ERROR;
+    }
+    // the phases of the main thread (e.g. the templates read) and of the skills are gathered in the main context
+    bool profile = fileData.profileFile != "";
+    generationContextStr& mainContext = get_generation_context();
+    mainContext.trace = profile;
+    // the workers only read the templates
+    if(!readTemplates(templateFileData, templateFileData.codeMap))
+    {
+        std::cerr << "Failed to read the templates from: " << getTemplateSource(templateFileData) << std::endl;
+        return RETURN_CODE_ERROR;
+    }
+    unsigned int jobs = fileData.jobs ? fileData.jobs : std::max(1u, std::thread::hardware_concurrency());
+    jobs = std::min<size_t>(jobs, batchInputs.size());
+
+    std::vector<generationContextStr> skillContexts(batchInputs.size());
+    std::vector<char> skillDone(batchInputs.size(), false);
+    std::vector<char> skillGenerated(batchInputs.size(), false);
+    std::vector<char> skillUpToDate(batchInputs.size(), false);
+    std::atomic<size_t> nextSkill = 0;
+    std::mutex doneMutex;
+    std::condition_variable doneCondition;
+    auto worker = [&]() {
+        for (size_t i = nextSkill++; i < batchInputs.size(); i = nextSkill++) {
+            skillContexts[i].buffered = true;
+            skillContexts[i].trace = profile;
+            set_generation_context(&skillContexts[i]);
+            bool upToDate;
+            bool generated = generateBatchSkill(fileData, batchInputs[i], templateFileData, upToDate);
+            set_generation_context(nullptr);
+            {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                skillDone[i] = true;
+                skillGenerated[i] = generated;
+                skillUpToDate[i] = upToDate;
+            }
+            doneCondition.notify_all();
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned int j = 0; j < jobs; j++) {
+        workers.emplace_back(worker);
+    }
+
+    std::vector<std::string> failedSkills;
+    size_t upToDateSkills = 0;
+    for (size_t i = 0; i < batchInputs.size(); i++) {
+        {
+            std::unique_lock<std::mutex> lock(doneMutex);
+            doneCondition.wait(lock, [&]() { return skillDone[i]; });
+        }
+        set_generation_context(&skillContexts[i]);
+        skillGenerated[i] = collectBatchSkill(batchInputs[i].first, skillGenerated[i]);
+        set_generation_context(&mainContext);
+        std::cout << skillContexts[i].output.str() << std::flush;
+        std::cerr << skillContexts[i].errors.str() << std::flush;
+        skillContexts[i].output.str("");
+        skillContexts[i].errors.str("");
+        for (auto& event : skillContexts[i].traceEvents) {
+            mainContext.traceEvents.push_back(std::move(event));
+        }
+        for (const auto& [counter, value] : skillContexts[i].traceCounters) {
+            mainContext.traceCounters[counter] += value;
         }
-        else
+        if(!skillGenerated[i])
+        {
+            failedSkills.push_back(batchInputs[i].first);
+        }
+        else if(skillUpToDate[i])
+        {
+            upToDateSkills++;
+        }
+    }
+    for (auto& workerThread : workers) {
+        workerThread.join();
+    }
+    bool synced = flushOutputFiles();
+    trimEventCache();
+
+    std::cout << "-----------" << std::endl;
+    std::cout << "Batch summary: " << batchInputs.size() << " skills, " << batchInputs.size() - failedSkills.size() - upToDateSkills << " generated, "
+              << upToDateSkills << " up to date, " << failedSkills.size() << " failed" << std::endl;
+    for (const auto& failedSkill : failedSkills) {
+        std::cout << "\tFAILED: " << failedSkill << std::endl;
+    }
+    if(profile && !writeGenerationProfile(fileData, mainContext.traceEvents, mainContext.traceCounters))
+    {
+        return RETURN_CODE_ERROR;
+    }
+    return failedSkills.empty() && synced ? RETURN_CODE_OK : RETURN_CODE_ERROR;
+}
+
+/**
+ * @brief Generate a watched skill and print the time taken
+ * 
+ * @param fileData file data structure with the options shared by all the skills, the output path is used as base directory
+ * @param inputFile SCXML file of the skill
+ * @param templateFileData template file data structure, the templates are already read
+ * @param changeTime time when the change was detected
+ * @return true if the skill is generated successfully
+ * @return false 
+ */
+bool generateWatchedSkill(const fileDataStr& fileData, const std::string& inputFile, templateFileDataStr& templateFileData, const std::chrono::steady_clock::time_point& changeTime)
+{
+    auto start = std::chrono::steady_clock::now();
+    bool upToDate;
+    bool generated = collectBatchSkill(inputFile, generateBatchSkill(fileData, {inputFile, ""}, templateFileData, upToDate));
+    generated &= flushOutputFiles();
+    trimEventCache();
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "-----------" << std::endl;
+    std::cout << (!generated ? "FAILED: " : upToDate ? "Up to date: " : "Done: ") << inputFile << " in " << std::fixed << std::setprecision(1)
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms ("
+              << std::chrono::duration<double, std::milli>(end - changeTime).count() << " ms since the change)" << std::defaultfloat << std::endl;
+    return generated;
+}
+
+/**
+ * @brief Watch a directory of SCXML files and the templates, and regenerate the affected skills when they change
+ * 
+ * The templates stay loaded between the generations and are read again only when one of them changes. The events of
+ * a save are gathered until no event is received for watchQuietTime, so a skill is generated once per save.
+ * The function returns only on error.
+ * 
+ * @param fileData file data structure with the options shared by all the skills, the output path is used as base directory
+ * @param templateFileData template file data structure
+ * @return int RETURN_CODE_ERROR
+ */
+int runWatch(const fileDataStr& fileData, templateFileDataStr& templateFileData)
+{
+#ifdef __linux__
+    namespace fs = std::filesystem;
+    constexpr int watchQuietTime = 20; // ms
+    std::error_code ec;
+    if(!fs::is_directory(fileData.watchPath, ec))
+    {
+        std::cerr << "Watch path is not a directory: " << fileData.watchPath << std::endl;
+        return RETURN_CODE_ERROR;
+    }
+    // editors may save in place while a skill is generated, a mapped file would change under the generation
+    setInputFileMapping(false);
+    if(!readTemplates(templateFileData, templateFileData.codeMap))
+    {
+        std::cerr << "Failed to read the templates from: " << getTemplateSource(templateFileData) << std::endl;
+        return RETURN_CODE_ERROR;
+    }
+
+    int fd = inotify_init1(IN_CLOEXEC);
+    if(fd < 0)
+    {
+        std::cerr << "Failed to initialize inotify" << std::endl;
+        return RETURN_CODE_ERROR;
+    }
+    // editors save in place or by renaming a temporary file
+    constexpr uint32_t watchMask = IN_CLOSE_WRITE | IN_MOVED_TO;
+    int inputWatch = inotify_add_watch(fd, fileData.watchPath.c_str(), watchMask);
+    std::set<int> templateWatches;
+    // the embedded templates can not change, only the templates of --template_path are watched
+    std::vector<std::string> templateFiles;
+    if(!templateFileData.templatePath.empty())
+    {
+        templateFiles = {templateFileData.hFile, templateFileData.cppFile, templateFileData.hDatamodelFile, templateFileData.cppDatamodelFile,
+                         templateFileData.CMakeListsFile, templateFileData.packageFile, templateFileData.mainFile};
+    }
+    for (const auto& templateFile : templateFiles) {
+        std::string templateDir = fs::path(templateFile).parent_path().string();
+        int templateWatch = inotify_add_watch(fd, templateDir.empty() ? "." : templateDir.c_str(), watchMask);
+        if(templateWatch < 0)
         {
-            add_to_log("Got output path from input file name: " + fileData.outputPath);
+            inputWatch = -1;
+            break;
         }
+        templateWatches.insert(templateWatch);
     }
+    if(inputWatch < 0)
+    {
+        std::cerr << "Failed to watch: " << fileData.watchPath << " and " << getTemplateSource(templateFileData) << std::endl;
+        close(fd);
+        return RETURN_CODE_ERROR;
+    }
+
+    auto generateAll = [&](const std::chrono::steady_clock::time_point& changeTime) {
+        std::vector<std::pair<std::string, std::string>> watchInputs;
+        if(getBatchInputs(fileData.watchPath, watchInputs))
+        {
+            for (const auto& watchInput : watchInputs) {
+                generateWatchedSkill(fileData, watchInput.first, templateFileData, changeTime);
+            }
+        }
+    };
+    generateAll(std::chrono::steady_clock::now());
+    std::cout << "-----------" << std::endl;
+    std::cout << "Watching: " << fileData.watchPath << " and " << getTemplateSource(templateFileData) << std::endl;
 
-    fileData.outputPath = fileData.outputPath + "/";
-    fileData.outputPathInclude = fileData.outputPath + "/include/";
-    fileData.outputPathSrc = fileData.outputPath + "/src/";
-    return RETURN_CODE_OK;
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+        // wait for the first event, then gather the events of the same save
+        std::set<std::string> changedInputs;
+        bool templatesChanged = false;
+        std::chrono::steady_clock::time_point changeTime;
+        pollfd pfd = {fd, POLLIN, 0};
+        for (int timeout = -1; poll(&pfd, 1, timeout) > 0; timeout = watchQuietTime) {
+            if(timeout < 0)
+            {
+                changeTime = std::chrono::steady_clock::now();
+            }
+            ssize_t length = read(fd, buffer, sizeof(buffer));
+            if(length <= 0)
+            {
+                std::cerr << "Failed to read the inotify events" << std::endl;
+                close(fd);
+                return RETURN_CODE_ERROR;
+            }
+            for (char* ptr = buffer; ptr < buffer + length; ptr += sizeof(inotify_event) + reinterpret_cast<inotify_event*>(ptr)->len) {
+                const inotify_event* event = reinterpret_cast<inotify_event*>(ptr);
+                if(event->len == 0)
+                {
+                    continue;
+                }
+                if(templateWatches.count(event->wd))
+                {
+                    templatesChanged = true;
+                }
+                else if(event->wd == inputWatch && fs::path(event->name).extension() == ".scxml")
+                {
+                    changedInputs.insert((fs::path(fileData.watchPath) / event->name).string());
+                }
+            }
+        }
+        if(templatesChanged)
+        {
+            templateFileData.codeMap.clear();
+            templateFileData.compiledMap.clear();
+            templateFileData.templateFiles.clear();
+            if(!readTemplates(templateFileData, templateFileData.codeMap))
+            {
+                std::cerr << "Failed to read the templates from: " << getTemplateSource(templateFileData) << std::endl;
+                // read again at the next change
+                templateFileData.codeMap.clear();
+                templateFileData.compiledMap.clear();
+                templateFileData.templateFiles.clear();
+                continue;
+            }
+            // the skills whose templates did not change are skipped by their manifest
+            generateAll(changeTime);
+            continue;
+        }
+        for (const auto& changedInput : changedInputs) {
+            generateWatchedSkill(fileData, changedInput, templateFileData, changeTime);
+        }
+    }
+#else
+    std::cerr << "--watch is only supported on Linux" << std::endl;
+    return RETURN_CODE_ERROR;
+#endif
 }
 
 /**
@@ -147,44 +671,36 @@ int main(int argc, char* argv[])
     {
         return RETURN_CODE_ERROR;
     }
-
-    
-    if(!fileData.translate_mode & fileData.generate_mode)
-    {
-        // Generation request without translation
-        fileData.inputFileNameGeneration = fileData.inputFileName;   
-    }
-    else if(!fileData.translate_mode & !fileData.generate_mode)
+    setOutputSync(fileData.fsync_mode);
+    setEventCache(fileData.cacheDirectory, fileData.cacheSize);
+    // the specification is parsed once here and shared by all the skills
+    if(fileData.modelFileName != "" && !getInterfaceRegistry(fileData.modelFileName, fileData.interfaceFileName))
     {
-        fileData.translate_mode= true;
-        fileData.generate_mode = true;
+        return RETURN_CODE_ERROR;
     }
 
-    if(fileData.translate_mode)
-    {   
-        add_to_log("Translation request");
-        if(!Translator(fileData))
-        {
-            add_to_log("-----------");
-            add_to_log("Error in translation");
-            return RETURN_CODE_ERROR;
-        }
-        fileData.inputFileNameGeneration = fileData.outputFileTranslatedSM;
-        
+    if(fileData.watchPath != "")
+    {
+        return runWatch(fileData, templateFileData);
     }
-    if(fileData.generate_mode)
+    if(fileData.batchPath != "")
     {
-
-        if(!Replacer(fileData, templateFileData))
-        {
-            add_to_log("-----------");
-            add_to_log("Error in code generation");
-            return RETURN_CODE_ERROR;
-        }
+        return runBatch(fileData, templateFileData);
     }
-    if(fileData.verbose_mode)
+    generationContextStr& context = get_generation_context();
+    context.trace = fileData.profileFile != "";
+    bool upToDate;
+    bool generated = generateSkill(fileData, templateFileData, upToDate);
+    generated = join_generation_tasks() && generated;
+    if(!generated)
     {
         print_log();
     }
-    return RETURN_CODE_OK;
+    generated &= flushOutputFiles();
+    trimEventCache();
+    if(context.trace && !writeGenerationProfile(fileData, context.traceEvents, context.traceCounters))
+    {
+        return RETURN_CODE_ERROR;
+    }
+    return generated ? RETURN_CODE_OK : RETURN_CODE_ERROR;
 };
\ No newline at end of file
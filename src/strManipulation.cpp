@@ -10,8 +10,12 @@
 */
 
 #include "strManipulation.h"
+#include "Data.h"
+#include <cerrno>
 #include <chrono>
 #include <iomanip>
+#include <filesystem>
+#include <algorithm>
 
 /**
  * @brief Convert string to snake case
@@ -60,7 +64,7 @@ void getDataTypePath(const std::string input, std::string& output)
     std::string temp = input;
     size_t pos = 0;
     if (temp == ""){
-        std::cerr << "Input DataType has no value" << std::endl;
+        error_stream() << "Input DataType has no value" << std::endl;
         return;
     }
 
@@ -103,14 +107,14 @@ bool readTemplateFile(const std::string filePath, std::string& fileContent)
 {
     std::ifstream readFile(filePath);
     if (!readFile.is_open()) {
-        std::cerr << "Failed to open template file for reading: " << filePath << std::endl;
+        error_stream() << "Failed to open template file for reading: " << filePath << std::endl;
         return false;
     }
     std::stringstream buffer;
     buffer << readFile.rdbuf();
 
     if (readFile.fail() && !readFile.eof()) {
-        std::cerr << "Error while reading the file: " << filePath << std::endl;
+        error_stream() << "Error while reading the file: " << filePath << std::endl;
         readFile.close();
         return false;
     }
@@ -120,39 +124,66 @@ bool readTemplateFile(const std::string filePath, std::string& fileContent)
 }
 
 /**
- * @brief function to write the file
+ * @brief function that replaces all the occurences of a string with another string
  * 
- * @param filePath constant string of the file path
- * @param fileContent constant string of the file content to be written
- * @return true 
- * @return false 
+ * @param str string to be modified passed by reference
+ * @param from original string to be replaced
+ * @param to new string to replace the original string
  */
-bool writeFile(const std::string filePath, const std::string fileName, const std::string fileContent)
-{
-    std::string path = filePath + fileName;
-    std::ofstream outputFile(path);
-    if (!outputFile.is_open()) {
-        std::cerr << "Failed to open file for writing: " << path << std::endl;
-        return false;
-    }
-    outputFile << fileContent;
-    outputFile.close();
-    std::cout << fileName << " file generated" << std::endl;
-    return true;
+void replaceAll(std::string& str, const std::string& from, const std::string& to) {
+    replaceMany(str, {{from, to}});
 }
 
 /**
- * @brief function that replaces all the occurences of a string with another string
+ * @brief function that replaces all the occurences of several strings in a single pass, the replaced text is not searched again
  * 
  * @param str string to be modified passed by reference
- * @param from original string to be replaced
- * @param to new string to replace the original string
+ * @param replacements original strings and new strings, the longest original string is replaced where several match
  */
-void replaceAll(std::string& str, const std::string& from, const std::string& to) {
-    size_t start_pos = 0;
-    while((start_pos = str.find(from, start_pos)) != std::string::npos) {
-        str.replace(start_pos, from.length(), to);
-        start_pos += to.length(); 
+void replaceMany(std::string& str, const std::vector<std::pair<std::string_view, std::string_view>>& replacements) {
+    // the original strings are tried only where their first character is found, longest first
+    std::vector<const std::pair<std::string_view, std::string_view>*> patterns;
+    bool firstChars[256] = {};
+    for (const auto& replacement : replacements) {
+        if (!replacement.first.empty()) {
+            patterns.push_back(&replacement);
+            firstChars[static_cast<unsigned char>(replacement.first[0])] = true;
+        }
+    }
+    std::stable_sort(patterns.begin(), patterns.end(), [](const auto* a, const auto* b) { return a->first.size() > b->first.size(); });
+
+    std::string output; // written from the first match, str is left untouched if nothing matches
+    bool matched = false;
+    size_t copied = 0; // characters of str before this position are in output
+    std::string_view input(str);
+    for (size_t pos = 0; pos < input.size(); ) {
+        if (!firstChars[static_cast<unsigned char>(input[pos])]) {
+            pos++;
+            continue;
+        }
+        const std::pair<std::string_view, std::string_view>* found = nullptr;
+        for (const auto* pattern : patterns) {
+            if (input.compare(pos, pattern->first.size(), pattern->first) == 0) {
+                found = pattern;
+                break;
+            }
+        }
+        if (!found) {
+            pos++;
+            continue;
+        }
+        if (!matched) {
+            output.reserve(str.size() + str.size() / 4);
+            matched = true;
+        }
+        output.append(input, copied, pos - copied);
+        output.append(found->second);
+        pos += found->first.size();
+        copied = pos;
+    }
+    if (matched) {
+        output.append(input, copied, std::string_view::npos);
+        str = std::move(output);
     }
 }
 
@@ -210,8 +241,7 @@ void saveSection(const std::string str, const std::string& from, const std::stri
  * @param to right string 
  */
 void keepSection(std::string& str, const std::string& from, const std::string& to){
-    replaceAll(str, from, "");
-    replaceAll(str, to, "");
+    replaceMany(str, {{from, ""}, {to, ""}});
 }
 
 /**
@@ -259,3 +289,71 @@ std::string getCurrentDatetime() {
     return oss.str();
 }
 
+/**
+ * @brief Read SOURCE_DATE_EPOCH (https://reproducible-builds.org/specs/source-date-epoch/)
+ * 
+ * @param epoch seconds since the Unix epoch returned by reference
+ * @param invalid set to true if SOURCE_DATE_EPOCH is set but is not a valid number of seconds
+ * @return true if SOURCE_DATE_EPOCH is set and valid
+ * @return false 
+ */
+static bool getSourceDateEpoch(std::time_t& epoch, bool& invalid) {
+    invalid = false;
+    const char* sourceDateEpoch = std::getenv("SOURCE_DATE_EPOCH");
+    if (!sourceDateEpoch || !*sourceDateEpoch) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    long long value = std::strtoll(sourceDateEpoch, &end, 10);
+    if (*end != '\0' || errno == ERANGE || value < 0) {
+        invalid = true;
+        return false;
+    }
+    epoch = static_cast<std::time_t>(value);
+    return true;
+}
+
+/**
+ * @brief Get the datetime written in the generated files
+ * 
+ * SOURCE_DATE_EPOCH is used if set, otherwise in reproducible mode the Unix epoch is used, so that identical inputs give
+ * bit-identical outputs. Fixed datetimes are written in UTC.
+ * 
+ * @param reproducible true to write a fixed datetime when SOURCE_DATE_EPOCH is not set
+ * @return std::string formatted datetime string (e.g., "2025-11-26 09:12:41 UTC")
+ */
+std::string getGenerationDatetime(const bool reproducible) {
+    std::time_t epoch = 0;
+    bool invalid;
+    bool hasSourceDateEpoch = getSourceDateEpoch(epoch, invalid);
+    if (invalid) {
+        LOG_WARNING("Invalid SOURCE_DATE_EPOCH, ignored: " << std::getenv("SOURCE_DATE_EPOCH"));
+    }
+    if (!hasSourceDateEpoch && !reproducible) {
+        return getCurrentDatetime();
+    }
+    std::tm epoch_tm{};
+    if (!gmtime_r(&epoch, &epoch_tm)) {
+        // the year of the epoch does not fit in std::tm
+        LOG_WARNING("SOURCE_DATE_EPOCH out of range, the Unix epoch is used: " << epoch);
+        epoch = 0;
+        gmtime_r(&epoch, &epoch_tm);
+    }
+    std::ostringstream oss;
+    oss << std::put_time(&epoch_tm, "%Y-%m-%d %H:%M:%S UTC");
+    return oss.str();
+}
+
+/**
+ * @brief Check if the datetime written in the generated files is fixed (reproducible mode or SOURCE_DATE_EPOCH)
+ * 
+ * @param reproducible true in reproducible mode
+ * @return true 
+ * @return false if the current datetime is written
+ */
+bool isGenerationDatetimeFixed(const bool reproducible) {
+    std::time_t epoch;
+    bool invalid;
+    return getSourceDateEpoch(epoch, invalid) || reproducible;
+}
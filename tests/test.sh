@@ -18,24 +18,24 @@ HL_SCXML_DIR="./hl_scxml"
 OUTPUT_DIR="./test_compilation/output"
 # create the output directory if it does not exist
 mkdir -p $OUTPUT_DIR
+# generate all the skills in one run, each skill is written in the snake case sub-directory of the output directory
+echo $MODEL2CODE_CMD --batch "$HL_SCXML_DIR" --output_path "$OUTPUT_DIR" --template_path "../template_skill" #--verbose_mode
+$MODEL2CODE_CMD --batch "$HL_SCXML_DIR" --output_path "$OUTPUT_DIR" --template_path "../template_skill" --verbose_mode || exit 1
 # loop through each file in the correct_skills directory
 for file in $HL_SCXML_DIR/*.scxml; do
     # get the base name of the file (without the path and .scxml extension)
     base_name=$(basename "$file" .scxml)
     # convert it from CamelCase to snake_case
-    base_name=$(echo "$base_name" | sed -r 's/([a-z])([A-Z])/\1_\2/g' | tr '[:upper:]' '[:lower:]')
+    base_name=$(echo "$base_name" | sed -r 's/([a-z0-9])([A-Z])/\1_\2/g' | tr '[:upper:]' '[:lower:]')
     # remove any leading or trailing whitespace
     base_name=$(echo "$base_name" | xargs)
     # print the base name
     # base_name=$(basename "$file")
-    # run the model2code command on the file and redirect the output to the output directory
-    echo $MODEL2CODE_CMD --input_filename "$file" --output_path "$OUTPUT_DIR/$base_name" --template_path "../template_skill" #--verbose_mode
-    $MODEL2CODE_CMD --input_filename "$file" --output_path "$OUTPUT_DIR/$base_name" --template_path "../template_skill" --verbose_mode
     # check if the output directory exists
 
     if [ -d "$OUTPUT_DIR/$base_name" ]; then
-        # compare the output file with the corresponding file in the hl_scxml directory
-        if diff -r -u "$OUTPUT_DIR/$base_name" "$CORRECT_SKILLS_DIR/$base_name" --color; then
+        # compare the output file with the corresponding file in the hl_scxml directory, the generation manifest is not part of the package
+        if diff -r -u -x .model2code_manifest "$OUTPUT_DIR/$base_name" "$CORRECT_SKILLS_DIR/$base_name" --color; then
             # if the files are the same, print "Test passed for $base_name" and exit with code 0
             echo "Test passed for $base_name"
         else
@@ -51,3 +51,35 @@ for file in $HL_SCXML_DIR/*.scxml; do
         exit 1
     fi 
 done
+
+# generate one skill alone too, the single skill generation must give the same package as the batch one
+file="$HL_SCXML_DIR/AlarmBatteryLowSkill.scxml"
+base_name="alarm_battery_low_skill"
+echo $MODEL2CODE_CMD --input_filename "$file" --output_path "$OUTPUT_DIR/single/$base_name" --template_path "../template_skill" #--verbose_mode
+$MODEL2CODE_CMD --input_filename "$file" --output_path "$OUTPUT_DIR/single/$base_name" --template_path "../template_skill" --verbose_mode || exit 1
+if diff -r -u -x .model2code_manifest "$OUTPUT_DIR/single/$base_name" "$CORRECT_SKILLS_DIR/$base_name" --color; then
+    echo "Test passed for the single generation of $base_name"
+else
+    echo "Test failed for the single generation of $base_name"
+    exit 1
+fi
+
+# check the errors found by --validate before the generation: the invalid skill gives exactly the expected errors
+INVALID_SKILL="invalid_scxml/InvalidSkill.scxml"
+VALIDATION_OUTPUT=$($MODEL2CODE_CMD --validate --input_filename "$INVALID_SKILL" --output_path "$OUTPUT_DIR/validation" 2>&1)
+if [ $? -ne 0 ] && diff -u "invalid_scxml/InvalidSkill.expected" <(echo "$VALIDATION_OUTPUT" | grep -E ": (error|warning): "); then
+    echo "Test passed for the validation of $INVALID_SKILL"
+else
+    echo "Test failed for the validation of $INVALID_SKILL"
+    exit 1
+fi
+# and the errors of the test skills are found (responses sent to the tick of another skill, assignment to an undeclared variable)
+for expected_error in "$HL_SCXML_DIR/IsTimerDoneSkill.scxml:44: error:" "$HL_SCXML_DIR/GoToPoiActionSkill.scxml:35: error:"; do
+    file="${expected_error%%:*}"
+    if $MODEL2CODE_CMD --validate --input_filename "$file" --output_path "$OUTPUT_DIR/validation" 2>&1 | grep -qF "$expected_error"; then
+        echo "Test passed for the validation of $file"
+    else
+        echo "Test failed for the validation of $file: $expected_error not found"
+        exit 1
+    fi
+done
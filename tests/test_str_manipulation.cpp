@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2024 Humanoid Sensing and Perception, Istituto Italiano di Tecnologia
+// SPDX-License-Identifier:  APACHE-2.0
+
+/**
+ * @file test_str_manipulation.cpp
+ * @brief This file contains the tests of the string substitutions used to render the templates (replaceMany, replaceAll).
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ */
+
+#include "strManipulation.h"
+#include "Data.h"
+
+static int failures = 0;
+
+/**
+ * @brief Check a replaceMany substitution and print it if the result is not the expected one
+ *
+ * @param name name of the checked case
+ * @param str original string
+ * @param replacements original strings and new strings
+ * @param expected expected result
+ */
+static void checkReplaceMany(const std::string& name, std::string str, const std::vector<std::pair<std::string_view, std::string_view>>& replacements, const std::string& expected)
+{
+    replaceMany(str, replacements);
+    if (str != expected) {
+        std::cerr << "FAILED " << name << ": \"" << str << "\" instead of \"" << expected << "\"" << std::endl;
+        failures++;
+    }
+}
+
+int main()
+{
+    checkReplaceMany("no match", "int value;", {{"$name$", "x"}}, "int value;");
+    checkReplaceMany("several patterns", "$type$ $name$ = $name$;", {{"$type$", "int"}, {"$name$", "x"}}, "int x = x;");
+    // the longest original string is replaced where several match, whatever their order
+    checkReplaceMany("overlapping patterns", "response->$field$ $field$", {{"$field$", "name"}, {"response->$field$", "response->name()"}}, "response->name() name");
+    checkReplaceMany("prefix patterns", "abcab", {{"ab", "1"}, {"abc", "2"}}, "21");
+    // an empty original string never matches
+    checkReplaceMany("empty original string", "abc", {{"", "x"}}, "abc");
+    checkReplaceMany("empty original string with others", "abc", {{"", "x"}, {"b", "y"}}, "ayc");
+    // the replaced text is not searched again
+    checkReplaceMany("replacement containing a pattern", "$a$ $b$", {{"$a$", "$b$"}, {"$b$", "$a$"}}, "$b$ $a$");
+    checkReplaceMany("replacement containing its pattern", "x", {{"x", "xx"}}, "xx");
+    checkReplaceMany("empty replacement", "a/*X*/b/*X*/", {{"/*X*/", ""}}, "ab");
+
+    std::string str = "a-b-c";
+    replaceAll(str, "-", "--");
+    if (str != "a--b--c") {
+        std::cerr << "FAILED replaceAll: \"" << str << "\"" << std::endl;
+        failures++;
+    }
+
+    if (failures) {
+        std::cerr << failures << " failed checks" << std::endl;
+        return RETURN_CODE_ERROR;
+    }
+    std::cout << "All the checks passed" << std::endl;
+    return RETURN_CODE_OK;
+}